@@ -12,23 +12,61 @@ Protocol — Host → FPGA (8N1, big-endian multi-byte fields):
   0x04 WRITE_ASSIGN   [var:2][val:1]                             3 payload bytes
   0x05 BCP_START      [false_lit:2]                              2 payload bytes
   0x06 RESET_STATE    (none)                                      0 payload bytes
+  0x09 FRAME          [seq:1][len:1][records:len][crc:2]     len+4 payload bytes
 
 Protocol — FPGA → Host (streamed after BCP_START completes):
   0xB0 [var:2][val:1][reason:2]  — one implication  (6 bytes total)
   0xC0 [clause_id:2][0x00]       — done, no conflict (4 bytes total)
   0xC1 [clause_id:2][0x00]       — done, conflict    (4 bytes total)
 
+Protocol — FPGA → Host (frame acknowledgements, at any time):
+  0xA0 [seq:1]                   — frame `seq` accepted
+  0xA1 [seq:1]                   — frames from `seq` on must be resent
+
+Framed bulk writes:
+  A FRAME carries up to 255 bytes of WRITE_CLAUSE, WRITE_WL_ENTRY,
+  WRITE_WL_LEN and WRITE_ASSIGN records, each encoded exactly like the
+  plain command (command byte + payload).  The CRC is CRC-16/CCITT-FALSE
+  (polynomial 0x1021, initial value 0xFFFF) over seq, len and the records,
+  sent high byte first.  Frames are numbered from 0 (RESET_STATE restarts
+  the count) and the host may have several unacknowledged frames in
+  flight, a sliding window with go-back-N recovery:
+
+    - A frame is accepted only if its CRC matches and seq is the next one
+      expected.  Its records go to one of two frame buffers and the frame
+      is ACKed; a separate executor replays the buffered records into the
+      memories, one byte per cycle, while the next frame is received.
+    - Anything else — a CRC error, an unexpected seq, a frame that finds
+      both buffers still full, an unknown command byte or a UART framing
+      error — makes the interface NAK the expected seq once and ignore
+      every command except RESET_STATE until a good frame with that seq
+      arrives.  Commands ignored this way include BCP_START, so no result
+      is sent for a round that was started on an incomplete upload.
+
+  A plain command waits in CMD_EXEC until every accepted frame has been
+  applied; bytes that arrive meanwhile are lost, so after frames the host
+  only sends commands it then waits on (BCP_START).
+
 FSM states:
   CMD_WAIT     — idle, waiting for the command byte
   PAYLOAD_RECV — accumulating payload bytes into buf[]
   CMD_EXEC     — one-cycle dispatch: pulse write enable or start BCP
+  FRAME_SEQ, FRAME_LEN, FRAME_BODY, FRAME_CRC_HI, FRAME_CRC_LO
+               — receiving a FRAME into the free frame buffer
   BCP_WAIT     — waiting for the accelerator done pulse
   IMPL_CHECK   — decide: send next implication, or the done packet
   IMPL_SEND    — serialise 6-byte implication packet over UART TX
   DONE_SEND    — serialise 4-byte done/conflict packet over UART TX
+
+Frame executor states (second FSM):
+  EXEC_IDLE    — waiting for a full frame buffer
+  EXEC_CMD     — record command byte, or end of the buffer
+  EXEC_PAYLOAD — record payload bytes into ebuf[]
+  EXEC_WRITE   — one-cycle write, like CMD_EXEC
 """
 
 from amaranth import *
+from amaranth.lib.memory import Memory
 
 from memory.clause_memory import MAX_CLAUSES, LIT_WIDTH
 from memory.watch_list_memory import (NUM_LITERALS, MAX_WATCH_LEN,
@@ -42,15 +80,39 @@ CMD_WRITE_WL_LEN   = 0x03
 CMD_WRITE_ASSIGN   = 0x04
 CMD_BCP_START      = 0x05
 CMD_RESET_STATE    = 0x06
+CMD_FRAME          = 0x09
 
 # ── Response bytes ─────────────────────────────────────────────────────────
 RSP_IMPLICATION = 0xB0
 RSP_DONE_OK     = 0xC0
 RSP_DONE_CONF   = 0xC1
+RSP_FRAME_ACK   = 0xA0
+RSP_FRAME_NAK   = 0xA1
 
 # Maximum payload length across all commands
 MAX_PAYLOAD = 14
 
+# Largest FRAME body
+MAX_FRAME = 255
+
+# CRC-16/CCITT-FALSE
+CRC_POLY = 0x1021
+CRC_INIT = 0xFFFF
+
+
+def crc16_step(crc, byte):
+    """CRC after feeding one byte, MSB first (combinational)."""
+    for i in range(7, -1, -1):
+        fb = crc[15] ^ byte[i]
+        crc = Cat(Const(0, 1), crc[:15]) ^ Mux(fb, CRC_POLY, 0)
+    return crc
+
+
+def record_len(cmd):
+    """Payload length of a plain write command, as it appears in a frame."""
+    return {CMD_WRITE_CLAUSE: 14, CMD_WRITE_WL_ENTRY: 5,
+            CMD_WRITE_WL_LEN: 3, CMD_WRITE_ASSIGN: 3}[cmd]
+
 
 class HostInterface(Elaboratable):
     """
@@ -64,6 +126,7 @@ class HostInterface(Elaboratable):
     ------------------------------------
     rx_data  : Signal(8), in
     rx_valid : Signal(),  in  — one-cycle strobe per received byte
+    rx_err   : Signal(),  in  — one-cycle strobe on a framing error
 
     Ports — UART TX (to UARTTransmitter)
     -------------------------------------
@@ -98,6 +161,7 @@ class HostInterface(Elaboratable):
         # UART
         self.rx_data  = Signal(8)
         self.rx_valid = Signal()
+        self.rx_err   = Signal()
         self.tx_data  = Signal(8)
         self.tx_valid = Signal()
         self.tx_ready = Signal()
@@ -140,6 +204,50 @@ class HostInterface(Elaboratable):
         self.assign_wr_data = Signal(2)
         self.assign_wr_en   = Signal()
 
+    def _write(self, m, cmd, buf):
+        """Drive the memory write port selected by `cmd` from payload `buf`
+        for one cycle.  Non-write commands drive nothing."""
+        with m.Switch(cmd):
+
+            with m.Case(CMD_WRITE_CLAUSE):
+                # buf: [clause_id:2][size:1][sat:1][lit0:2][lit1:2][lit2:2][lit3:2][lit4:2]
+                m.d.comb += [
+                    self.clause_wr_addr.eq(   Cat(buf[1],  buf[0])),
+                    self.clause_wr_size.eq(        buf[2]),
+                    self.clause_wr_sat_bit.eq(     buf[3]),
+                    self.clause_wr_lit0.eq(    Cat(buf[5],  buf[4])),
+                    self.clause_wr_lit1.eq(    Cat(buf[7],  buf[6])),
+                    self.clause_wr_lit2.eq(    Cat(buf[9],  buf[8])),
+                    self.clause_wr_lit3.eq(    Cat(buf[11], buf[10])),
+                    self.clause_wr_lit4.eq(    Cat(buf[13], buf[12])),
+                    self.clause_wr_en.eq(1),
+                ]
+
+            with m.Case(CMD_WRITE_WL_ENTRY):
+                # buf: [lit:2][idx:1][clause_id:2]
+                m.d.comb += [
+                    self.wl_wr_lit.eq(  Cat(buf[1], buf[0])),
+                    self.wl_wr_idx.eq(      buf[2]),
+                    self.wl_wr_data.eq( Cat(buf[4], buf[3])),
+                    self.wl_wr_en.eq(1),
+                ]
+
+            with m.Case(CMD_WRITE_WL_LEN):
+                # buf: [lit:2][len:1]
+                m.d.comb += [
+                    self.wl_wr_lit.eq(    Cat(buf[1], buf[0])),
+                    self.wl_wr_len.eq(        buf[2]),
+                    self.wl_wr_len_en.eq(1),
+                ]
+
+            with m.Case(CMD_WRITE_ASSIGN):
+                # buf: [var:2][val:1]
+                m.d.comb += [
+                    self.assign_wr_addr.eq(Cat(buf[1], buf[0])),
+                    self.assign_wr_data.eq(    buf[2]),
+                    self.assign_wr_en.eq(1),
+                ]
+
     def elaborate(self, platform):
         m = Module()
 
@@ -186,8 +294,62 @@ class HostInterface(Elaboratable):
             done_b2.eq(conflict_id_reg[:8]),
         ]
 
+        # ── Frame buffers ───────────────────────────────────────────────────
+        # Two MAX_FRAME-byte buffers, addressed {bank, offset}.  The receiver
+        # fills bank `wbank`, the executor drains bank `rbank`; a bank is
+        # `full` from the frame's acceptance until the executor is done.
+        m.submodules.frame_mem = frame_mem = Memory(
+            shape=8, depth=2 * (MAX_FRAME + 1), init=[]
+        )
+        frame_wr = frame_mem.write_port()
+        frame_rd = frame_mem.read_port(domain="comb")
+
+        bank_full = Array([Signal(name=f"bank_full_{i}") for i in range(2)])
+        bank_len  = Array([Signal(8, name=f"bank_len_{i}") for i in range(2)])
+        wbank     = Signal()
+        rbank     = Signal()
+        exec_busy = Signal()
+        m.d.comb += exec_busy.eq(bank_full[0] | bank_full[1])
+
+        # ── Frame receive state ─────────────────────────────────────────────
+        expected_seq = Signal(8)  # seq of the next frame to accept
+        resync       = Signal()   # NAK sent; waiting for frame expected_seq
+        f_seq        = Signal(8)
+        f_len        = Signal(8)
+        f_cnt        = Signal(8)
+        f_overrun    = Signal()   # both buffers were full: drop this frame
+        crc          = Signal(16)
+        crc_hi       = Signal(8)
+        crc_next     = Signal(16)
+        m.d.comb += crc_next.eq(crc16_step(crc, self.rx_data))
+
+        # ── ACK/NAK sender ──────────────────────────────────────────────────
+        # One 2-byte packet at a time; it owns TX whenever the FSM below is
+        # not sending a BCP result.
+        ack_pending = Signal()
+        ack_code    = Signal(8)
+        ack_seq     = Signal(8)
+        ack_idx     = Signal()
+
+        def send_ack(code, seq):
+            with m.If(~ack_pending):
+                m.d.sync += [
+                    ack_pending.eq(1),
+                    ack_code.eq(code),
+                    ack_seq.eq(seq),
+                    ack_idx.eq(0),
+                ]
+
+        def enter_resync():
+            with m.If(~resync):
+                m.d.sync += resync.eq(1)
+                send_ack(RSP_FRAME_NAK, expected_seq)
+
+        with m.If(self.rx_err):
+            enter_resync()
+
         # ── FSM ─────────────────────────────────────────────────────────────
-        with m.FSM():
+        with m.FSM() as fsm:
 
             # ----------------------------------------------------------------
             # CMD_WAIT: idle until a command byte arrives on rx_valid.
@@ -211,10 +373,16 @@ class HostInterface(Elaboratable):
                         with m.Case(CMD_BCP_START):
                             m.d.sync += payload_len.eq(2)
                             m.next = "PAYLOAD_RECV"
-                        with m.Default():
-                            # 0-byte payload (e.g. RESET_STATE): execute directly
+                        with m.Case(CMD_RESET_STATE):
+                            # 0-byte payload: execute directly
                             m.d.sync += payload_len.eq(0)
                             m.next = "CMD_EXEC"
+                        with m.Case(CMD_FRAME):
+                            m.d.sync += crc.eq(CRC_INIT)
+                            m.next = "FRAME_SEQ"
+                        with m.Default():
+                            # Lost framing: resynchronise on a frame
+                            enter_resync()
 
             # ----------------------------------------------------------------
             # PAYLOAD_RECV: shift incoming bytes into buf[] one at a time.
@@ -233,61 +401,92 @@ class HostInterface(Elaboratable):
             # one memory write cycle occurs.
             # ----------------------------------------------------------------
             with m.State("CMD_EXEC"):
-                with m.Switch(cmd):
-
-                    with m.Case(CMD_WRITE_CLAUSE):
-                        # buf: [clause_id:2][size:1][sat:1][lit0:2][lit1:2][lit2:2][lit3:2][lit4:2]
-                        m.d.comb += [
-                            self.clause_wr_addr.eq(   Cat(buf[1],  buf[0])),
-                            self.clause_wr_size.eq(        buf[2]),
-                            self.clause_wr_sat_bit.eq(     buf[3]),
-                            self.clause_wr_lit0.eq(    Cat(buf[5],  buf[4])),
-                            self.clause_wr_lit1.eq(    Cat(buf[7],  buf[6])),
-                            self.clause_wr_lit2.eq(    Cat(buf[9],  buf[8])),
-                            self.clause_wr_lit3.eq(    Cat(buf[11], buf[10])),
-                            self.clause_wr_lit4.eq(    Cat(buf[13], buf[12])),
-                            self.clause_wr_en.eq(1),
-                        ]
-                        m.next = "CMD_WAIT"
+                with m.If(exec_busy):
+                    # Accepted frames are applied first
+                    pass
+                with m.Elif(resync & (cmd != CMD_RESET_STATE)):
+                    m.next = "CMD_WAIT"
+                with m.Else():
+                    self._write(m, cmd, buf)
+                    with m.Switch(cmd):
 
-                    with m.Case(CMD_WRITE_WL_ENTRY):
-                        # buf: [lit:2][idx:1][clause_id:2]
-                        m.d.comb += [
-                            self.wl_wr_lit.eq(  Cat(buf[1], buf[0])),
-                            self.wl_wr_idx.eq(      buf[2]),
-                            self.wl_wr_data.eq( Cat(buf[4], buf[3])),
-                            self.wl_wr_en.eq(1),
-                        ]
-                        m.next = "CMD_WAIT"
+                        with m.Case(CMD_BCP_START):
+                            # buf: [false_lit:2]
+                            m.d.comb += [
+                                self.bcp_false_lit.eq(Cat(buf[1], buf[0])),
+                                self.bcp_start.eq(1),
+                            ]
+                            m.next = "BCP_WAIT"
+
+                        with m.Case(CMD_RESET_STATE):
+                            m.d.sync += [
+                                expected_seq.eq(0),
+                                resync.eq(0),
+                            ]
+                            m.next = "CMD_WAIT"
 
-                    with m.Case(CMD_WRITE_WL_LEN):
-                        # buf: [lit:2][len:1]
-                        m.d.comb += [
-                            self.wl_wr_lit.eq(    Cat(buf[1], buf[0])),
-                            self.wl_wr_len.eq(        buf[2]),
-                            self.wl_wr_len_en.eq(1),
-                        ]
-                        m.next = "CMD_WAIT"
+                        with m.Default():
+                            m.next = "CMD_WAIT"
 
-                    with m.Case(CMD_WRITE_ASSIGN):
-                        # buf: [var:2][val:1]
-                        m.d.comb += [
-                            self.assign_wr_addr.eq(Cat(buf[1], buf[0])),
-                            self.assign_wr_data.eq(    buf[2]),
-                            self.assign_wr_en.eq(1),
-                        ]
-                        m.next = "CMD_WAIT"
+            # ----------------------------------------------------------------
+            # FRAME_*: receive [seq][len][records][crc] into bank wbank,
+            # updating the CRC over everything but the CRC itself.
+            # ----------------------------------------------------------------
+            with m.State("FRAME_SEQ"):
+                with m.If(self.rx_valid):
+                    m.d.sync += [
+                        f_seq.eq(self.rx_data),
+                        crc.eq(crc_next),
+                    ]
+                    m.next = "FRAME_LEN"
 
-                    with m.Case(CMD_BCP_START):
-                        # buf: [false_lit:2]
-                        m.d.comb += [
-                            self.bcp_false_lit.eq(Cat(buf[1], buf[0])),
-                            self.bcp_start.eq(1),
-                        ]
-                        m.next = "BCP_WAIT"
+            with m.State("FRAME_LEN"):
+                with m.If(self.rx_valid):
+                    m.d.sync += [
+                        f_len.eq(self.rx_data),
+                        f_cnt.eq(0),
+                        f_overrun.eq(bank_full[wbank]),
+                        crc.eq(crc_next),
+                    ]
+                    with m.If(self.rx_data == 0):
+                        m.next = "FRAME_CRC_HI"
+                    with m.Else():
+                        m.next = "FRAME_BODY"
 
-                    with m.Default():
-                        m.next = "CMD_WAIT"
+            with m.State("FRAME_BODY"):
+                with m.If(self.rx_valid):
+                    m.d.comb += [
+                        frame_wr.addr.eq(Cat(f_cnt, wbank)),
+                        frame_wr.data.eq(self.rx_data),
+                        frame_wr.en.eq(~f_overrun),
+                    ]
+                    m.d.sync += [
+                        f_cnt.eq(f_cnt + 1),
+                        crc.eq(crc_next),
+                    ]
+                    with m.If(f_cnt + 1 == f_len):
+                        m.next = "FRAME_CRC_HI"
+
+            with m.State("FRAME_CRC_HI"):
+                with m.If(self.rx_valid):
+                    m.d.sync += crc_hi.eq(self.rx_data)
+                    m.next = "FRAME_CRC_LO"
+
+            with m.State("FRAME_CRC_LO"):
+                with m.If(self.rx_valid):
+                    with m.If((Cat(self.rx_data, crc_hi) == crc) & ~f_overrun &
+                              (f_seq == expected_seq)):
+                        m.d.sync += [
+                            bank_full[wbank].eq(1),
+                            bank_len[wbank].eq(f_len),
+                            wbank.eq(~wbank),
+                            expected_seq.eq(expected_seq + 1),
+                            resync.eq(0),
+                        ]
+                        send_ack(RSP_FRAME_ACK, f_seq)
+                    with m.Else():
+                        enter_resync()
+                    m.next = "CMD_WAIT"
 
             # ----------------------------------------------------------------
             # BCP_WAIT: hold until the accelerator pulses done (1 cycle).
@@ -306,7 +505,10 @@ class HostInterface(Elaboratable):
             # 6-byte implication packet; otherwise send the 4-byte done packet.
             # ----------------------------------------------------------------
             with m.State("IMPL_CHECK"):
-                with m.If(self.impl_valid):
+                with m.If(ack_pending):
+                    # Let the ACK/NAK sender finish with TX first
+                    pass
+                with m.Elif(self.impl_valid):
                     m.d.sync += [
                         tx_shift.eq(Cat(
                             Const(RSP_IMPLICATION, 8),
@@ -362,4 +564,68 @@ class HostInterface(Elaboratable):
                     with m.If(tx_count == 1):
                         m.next = "CMD_WAIT"
 
+        # ── ACK/NAK sender ──────────────────────────────────────────────────
+        with m.If(ack_pending &
+                  ~fsm.ongoing("IMPL_SEND") & ~fsm.ongoing("DONE_SEND")):
+            m.d.comb += [
+                self.tx_data.eq(Mux(ack_idx, ack_seq, ack_code)),
+                self.tx_valid.eq(1),
+            ]
+            with m.If(self.tx_ready):
+                m.d.sync += ack_idx.eq(1)
+                with m.If(ack_idx):
+                    m.d.sync += ack_pending.eq(0)
+
+        # ── Frame executor ──────────────────────────────────────────────────
+        ebuf   = Array([Signal(8, name=f"ebuf_{i}") for i in range(MAX_PAYLOAD)])
+        e_cmd  = Signal(8)
+        e_plen = Signal(4)
+        e_idx  = Signal(4)
+        e_ptr  = Signal(8)
+        m.d.comb += frame_rd.addr.eq(Cat(e_ptr, rbank))
+
+        with m.FSM(name="exec"):
+
+            with m.State("EXEC_IDLE"):
+                with m.If(bank_full[rbank]):
+                    m.d.sync += e_ptr.eq(0)
+                    m.next = "EXEC_CMD"
+
+            with m.State("EXEC_CMD"):
+                # One record per pass; a command byte that is not a write
+                # ends the buffer (the host never sends one).
+                known = Signal()
+                with m.Switch(frame_rd.data):
+                    for c in (CMD_WRITE_CLAUSE, CMD_WRITE_WL_ENTRY,
+                              CMD_WRITE_WL_LEN, CMD_WRITE_ASSIGN):
+                        with m.Case(c):
+                            m.d.comb += known.eq(1)
+                            m.d.sync += e_plen.eq(record_len(c))
+                with m.If((e_ptr == bank_len[rbank]) | ~known):
+                    m.d.sync += [
+                        bank_full[rbank].eq(0),
+                        rbank.eq(~rbank),
+                    ]
+                    m.next = "EXEC_IDLE"
+                with m.Else():
+                    m.d.sync += [
+                        e_cmd.eq(frame_rd.data),
+                        e_ptr.eq(e_ptr + 1),
+                        e_idx.eq(0),
+                    ]
+                    m.next = "EXEC_PAYLOAD"
+
+            with m.State("EXEC_PAYLOAD"):
+                m.d.sync += [
+                    ebuf[e_idx].eq(frame_rd.data),
+                    e_ptr.eq(e_ptr + 1),
+                    e_idx.eq(e_idx + 1),
+                ]
+                with m.If(e_idx + 1 == e_plen):
+                    m.next = "EXEC_WRITE"
+
+            with m.State("EXEC_WRITE"):
+                self._write(m, e_cmd, ebuf)
+                m.next = "EXEC_CMD"
+
         return m
@@ -8,19 +8,57 @@ so the BCP accelerator is unchanged.
 Protocol — 128-bit DR register accessed via ER1 (IR=0x32):
 
   Command (host -> FPGA), shifted in via drscan:
-    [127:120] cmd_byte    (0x01-0x07)
+    [127:120] cmd_byte    (0x01-0x09)
     [119:8]   payload     (14 bytes, same encoding as UART protocol)
     [7:0]     seq_num     (incremented per command, for handshake)
 
   Response (FPGA -> host), shifted out during same drscan:
-    [127:120] status      (0x00=IDLE, 0x01=BUSY, 0xB0=IMPL, 0xC0=DONE_OK, 0xC1=DONE_CONFLICT)
-    [119:104] var         (16 bits, for IMPL)
-    [103:96]  val         (8 bits, for IMPL)
-    [95:80]   reason      (16 bits, for IMPL) / clause_id (for DONE)
-    [79:8]    reserved    (72 bits)
+    [127:120] status      (0x00=IDLE, 0x01=BUSY, 0xB0=IMPL, 0xC0=DONE_OK, 0xC1=DONE_CONFLICT,
+                           0xD0=PERF)
+    [119:117] count       (implication tuples in this response, 0..BURST_MAX)
+    [116:104] clause_id   (13 bits, conflicting clause for DONE_CONFLICT)
+    [103:100] reserved
+    [99:8]    tuples      (BURST_MAX x 23 bits; tuple i at [8+23*i +: 23],
+                           packed like an ImplicationFIFO entry:
+                           var [0:9] | value [9] (1=TRUE) | reason [10:23])
     [7:0]     ack_seq     (echoes seq_num when command consumed)
 
-  New command (JTAG only): CMD_ACK_IMPL = 0x07 -- pops implication FIFO.
+  Implications are drained in bursts: once BCP finishes, up to BURST_MAX
+  entries are popped from the implication FIFO into the response.  If more
+  remain, status is IMPL and CMD_ACK_IMPL (0x07, JTAG only) asks for the
+  next burst; otherwise the last burst comes with the DONE status, so a
+  round with at most BURST_MAX implications needs a single response.
+  The accelerator applies implied values to its assignment memory itself.
+
+  Backjumps (JTAG only):
+    CMD_WRITE_ASSIGN payload byte 3, bit 0 marks a decision, which opens a
+    new decision level in the assignment memory's hardware trail.
+    CMD_BACKTRACK (0x08) [level:2] unassigns every variable assigned above
+    `level`.  The assignment memory pops one variable per cycle, at most
+    MAX_VARS cycles, far less than one 128-bit scan; assignment writes and
+    BCP_START are held back until it finishes all the same.
+
+  Soft reset between problems (JTAG only):
+    CMD_RESET_STATE (0x06) drops every command still pending, drains the
+    implication FIFO and empties the assignment memory's trail (values are
+    kept; the host rewrites every variable of the next problem), then
+    returns to IDLE.  Clause memory and watch lists are left alone: the
+    host overwrites whatever the next problem uses.  The host waits for
+    IDLE with ack_seq equal to the reset's seq_num before sending more.
+
+  Performance counters (JTAG only, see modules/perf_counters.py):
+    CMD_READ_PERF (0x09) [index:1] answers with a PERF response in place
+    of the usual one until the next command:
+      [127:120] 0xD0
+      [119:112] index
+      [111:108] number of counters
+      [107:104] number of evaluator PEs
+      [103:8]   counters index .. index+2, counter index + i at [8+32*i +: 32]
+      [7:0]     ack_seq
+    Index 0 first snapshots every counter, so the values of one sweep
+    (index 0, 3, 6, ...) are from the same cycle.  It does not disturb the
+    FSM: the host reads the counters between BCP rounds, and the status
+    the FSM holds is shown again from the next command on.
 
 Clock domain crossing (2-FF synchronizer, adopted from proven bcp_engine.py):
   - Command path (jtck -> sync): jce1 & jupdate latches rx_shift into a
@@ -46,9 +84,11 @@ handles the BCP lifecycle.
 FSM states:
   IDLE       -- waiting for bcp_start_pending
   BCP_WAIT   -- waiting for the accelerator done pulse
-  IMPL_CHECK -- decide: load next implication or the done packet
-  IMPL_READY -- implication available, waiting for ack_impl_pending
-  DONE_READY -- BCP finished, results loaded, waiting for next command
+  BURST_LOAD -- pop up to BURST_MAX implications into the response
+  IMPL_READY -- full burst loaded and more pending, waiting for ack_impl_pending
+                (counted as drain_wait)
+  DONE_READY -- BCP finished, last burst loaded, waiting for next command
+  RESET      -- CMD_RESET_STATE: draining the implication FIFO
 
 Constructor parameter use_jtagg_primitive (default True):
   True  -> instantiate real JTAGG primitive (for synthesis)
@@ -62,6 +102,10 @@ from memory.clause_memory import MAX_CLAUSES, LIT_WIDTH
 from memory.watch_list_memory import (NUM_LITERALS, MAX_WATCH_LEN,
                                       CLAUSE_ID_WIDTH, LENGTH_WIDTH)
 from memory.assignment_memory import MAX_VARS
+from modules.implication_fifo import ENTRY_WIDTH
+from modules.clause_dispatcher import NUM_PES
+from modules.perf_counters import (PerfCounters, NUM_PERF, PERF_WIDTH,
+                                   PERF_PER_READ)
 
 # -- Command bytes -------------------------------------------------------------
 CMD_WRITE_CLAUSE   = 0x01
@@ -71,6 +115,8 @@ CMD_WRITE_ASSIGN   = 0x04
 CMD_BCP_START      = 0x05
 CMD_RESET_STATE    = 0x06
 CMD_ACK_IMPL       = 0x07
+CMD_BACKTRACK      = 0x08
+CMD_READ_PERF      = 0x09
 
 # -- Response status bytes -----------------------------------------------------
 RSP_IDLE        = 0x00
@@ -78,22 +124,36 @@ RSP_BUSY        = 0x01
 RSP_IMPLICATION = 0xB0
 RSP_DONE_OK     = 0xC0
 RSP_DONE_CONF   = 0xC1
+RSP_PERF        = 0xD0
 
 # Register width
 REG_WIDTH = 128
 
+# Implication tuples per response
+BURST_MAX = 4
+
+# ack_seq + tuples + reserved + clause_id + count + status
+assert 8 + BURST_MAX * ENTRY_WIDTH + 4 + 13 + 3 + 8 == REG_WIDTH
+# PERF response: ack_seq + counters + PE count + counter count + index + status
+assert 8 + PERF_PER_READ * PERF_WIDTH + 4 + 4 + 8 + 8 == REG_WIDTH
+
 
 class JTAGHostInterface(Elaboratable):
     """
     JTAG-based command decoder and response provider.
 
     Same BCP-facing ports as HostInterface, but communicates via JTAG
-    shift register instead of UART byte stream.
+    shift register instead of UART byte stream.  Also holds the
+    accelerator's performance counters, fed by its perf_* event outputs;
+    num_pes is only reported to the host.
     """
 
-    def __init__(self, use_jtagg_primitive=True, diagnostic_mode=False):
+    def __init__(self, use_jtagg_primitive=True, diagnostic_mode=False,
+                 num_pes=NUM_PES):
         self.use_jtagg_primitive = use_jtagg_primitive
         self.diagnostic_mode = diagnostic_mode
+        self.num_pes = num_pes
+        assert num_pes < 16  # 4 bits in the PERF response
 
         # -- JTAG test ports (simulation only, when use_jtagg_primitive=False) --
         if not use_jtagg_primitive:
@@ -140,6 +200,24 @@ class JTAGHostInterface(Elaboratable):
         self.assign_wr_addr = Signal(range(MAX_VARS))
         self.assign_wr_data = Signal(2)
         self.assign_wr_en   = Signal()
+        self.assign_wr_decision = Signal()
+
+        # -- Assignment backtrack port -----------------------------------------
+        self.assign_bt_level = Signal(range(MAX_VARS))
+        self.assign_bt_start = Signal()
+        self.assign_bt_busy  = Signal()
+
+        # -- Assignment soft reset ---------------------------------------------
+        self.assign_rst = Signal()
+
+        # -- Performance counter events (from the accelerator) -----------------
+        self.perf_active      = Signal()
+        self.perf_wlm_busy    = Signal()
+        self.perf_fetch_stall = Signal()
+        self.perf_pe_busy     = Signal(range(num_pes + 1))
+        self.perf_evaluated   = Signal(range(num_pes + 1))
+        self.perf_sat_skip    = Signal()
+        self.perf_fifo_full   = Signal()
 
     def elaborate(self, platform):
         m = Module()
@@ -178,23 +256,39 @@ class JTAGHostInterface(Elaboratable):
 
         # Response fields (set by the FSM below)
         rsp_status    = Signal(8)
-        rsp_var       = Signal(16)
-        rsp_val       = Signal(8)
-        rsp_reason_id = Signal(16)
         ack_seq       = Signal(8)
         conflict_reg    = Signal()
-        conflict_id_reg = Signal(range(MAX_CLAUSES))
+        conflict_id_reg = Signal(13)
+        burst_count = Signal(3)
+        burst = Array([Signal(ENTRY_WIDTH, name=f"burst_{i}")
+                       for i in range(BURST_MAX)])
+
+        # Performance counters and the PERF response fields
+        m.submodules.perf = perf = PerfCounters(inc_width=self.num_pes.bit_length())
+        perf_rsp   = Signal()
+        perf_idx_r = Signal(8)
+        m.d.comb += perf.rd_idx.eq(perf_idx_r)
 
         # Assemble the 128-bit response word
         jtag_data = Signal(REG_WIDTH)
-        m.d.comb += jtag_data.eq(Cat(
-            ack_seq,                    # [7:0]
-            Const(0, 72),               # [79:8]   reserved
-            rsp_reason_id,              # [95:80]
-            rsp_val,                    # [103:96]
-            rsp_var,                    # [119:104]
-            rsp_status,                 # [127:120]
-        ))
+        with m.If(perf_rsp):
+            m.d.comb += jtag_data.eq(Cat(
+                ack_seq,                    # [7:0]
+                *perf.rd_data,              # [103:8]  counters
+                Const(self.num_pes, 4),     # [107:104]
+                Const(NUM_PERF, 4),         # [111:108]
+                perf_idx_r,                 # [119:112]
+                Const(RSP_PERF, 8),         # [127:120]
+            ))
+        with m.Else():
+            m.d.comb += jtag_data.eq(Cat(
+                ack_seq,                    # [7:0]
+                *burst,                     # [99:8]   implication tuples
+                Const(0, 4),                # [103:100] reserved
+                conflict_id_reg,            # [116:104]
+                burst_count,                # [119:117]
+                rsp_status,                 # [127:120]
+            ))
 
         # Shadow register for reads
         jtag_shadow = Signal(REG_WIDTH)
@@ -286,6 +380,8 @@ class JTAGHostInterface(Elaboratable):
 
         assign_addr_r = Signal(range(MAX_VARS))
         assign_data_r = Signal(2)
+        assign_dec_r  = Signal()
+        bt_level_r    = Signal(range(MAX_VARS))
 
         bcp_false_lit_r = Signal(range(NUM_LITERALS))
 
@@ -294,8 +390,11 @@ class JTAGHostInterface(Elaboratable):
         wl_wr_pending      = Signal()
         wl_len_pending     = Signal()
         assign_wr_pending  = Signal()
+        bt_pending         = Signal()
         bcp_start_pending  = Signal()
         ack_impl_pending   = Signal()
+        reset_pending      = Signal()
+        assign_rst_pending = Signal()
         any_cmd_processed  = Signal()
 
         # Auto-clear one-shot flag each cycle (overridden when cmd_pending)
@@ -308,10 +407,12 @@ class JTAGHostInterface(Elaboratable):
         with m.If(cmd_pending):
             m.d.sync += cmd_pending.eq(0)
 
-            # Only process real commands (skip NOP scans with cmd_byte=0x00)
-            with m.If((cmd_byte >= CMD_WRITE_CLAUSE) & (cmd_byte <= CMD_ACK_IMPL)):
+            # Only process real commands (skip NOP scans with cmd_byte=0x00).
+            # READ_PERF leaves the FSM where it is.
+            with m.If((cmd_byte >= CMD_WRITE_CLAUSE) & (cmd_byte <= CMD_READ_PERF)):
                 m.d.sync += [
-                    any_cmd_processed.eq(1),
+                    any_cmd_processed.eq(cmd_byte != CMD_READ_PERF),
+                    perf_rsp.eq(cmd_byte == CMD_READ_PERF),
                     ack_seq.eq(rx_data_latched[0:8]),
                 ]
 
@@ -349,9 +450,16 @@ class JTAGHostInterface(Elaboratable):
                     m.d.sync += [
                         assign_addr_r.eq(Cat(buf[1], buf[0])),
                         assign_data_r.eq(buf[2]),
+                        assign_dec_r.eq(buf[3][0]),
                         assign_wr_pending.eq(1),
                     ]
 
+                with m.Case(CMD_BACKTRACK):
+                    m.d.sync += [
+                        bt_level_r.eq(Cat(buf[1], buf[0])),
+                        bt_pending.eq(1),
+                    ]
+
                 with m.Case(CMD_BCP_START):
                     m.d.sync += [
                         bcp_false_lit_r.eq(Cat(buf[1], buf[0])),
@@ -361,8 +469,20 @@ class JTAGHostInterface(Elaboratable):
                 with m.Case(CMD_ACK_IMPL):
                     m.d.sync += ack_impl_pending.eq(1)
 
+                with m.Case(CMD_READ_PERF):
+                    m.d.sync += perf_idx_r.eq(buf[0])
+                    with m.If(buf[0] == 0):
+                        m.d.comb += perf.snapshot.eq(1)
+
                 with m.Case(CMD_RESET_STATE):
-                    pass
+                    m.d.sync += [
+                        assign_wr_pending.eq(0),
+                        bt_pending.eq(0),
+                        bcp_start_pending.eq(0),
+                        ack_impl_pending.eq(0),
+                        reset_pending.eq(1),
+                        assign_rst_pending.eq(1),
+                    ]
 
         # =================================================================
         # Write-enable pulse generation (one cycle after pending is set)
@@ -398,25 +518,40 @@ class JTAGHostInterface(Elaboratable):
                 self.wl_wr_len_en.eq(1),
             ]
 
-        with m.If(assign_wr_pending):
+        with m.If(assign_wr_pending & ~self.assign_bt_busy):
             m.d.sync += assign_wr_pending.eq(0)
             m.d.comb += [
                 self.assign_wr_addr.eq(assign_addr_r),
                 self.assign_wr_data.eq(assign_data_r),
+                self.assign_wr_decision.eq(assign_dec_r),
                 self.assign_wr_en.eq(1),
             ]
 
+        with m.If(bt_pending):
+            m.d.sync += bt_pending.eq(0)
+            m.d.comb += [
+                self.assign_bt_level.eq(bt_level_r),
+                self.assign_bt_start.eq(1),
+            ]
+
+        with m.If(assign_rst_pending & ~self.assign_bt_busy):
+            m.d.sync += assign_rst_pending.eq(0)
+            m.d.comb += self.assign_rst.eq(1)
+
         # =================================================================
         # FSM — only handles BCP lifecycle and response status
         # =================================================================
         in_bcp_wait   = Signal()
         in_impl_ready = Signal()
         in_done_ready = Signal()
+        drain_wait    = Signal()
 
         with m.FSM():
             with m.State("IDLE"):
                 m.d.comb += rsp_status.eq(RSP_IDLE)
-                with m.If(bcp_start_pending):
+                with m.If(reset_pending):
+                    m.next = "RESET"
+                with m.Elif(bcp_start_pending & ~self.assign_bt_busy):
                     m.d.sync += bcp_start_pending.eq(0)
                     m.d.comb += [
                         self.bcp_false_lit.eq(bcp_false_lit_r),
@@ -431,40 +566,50 @@ class JTAGHostInterface(Elaboratable):
                     m.d.sync += [
                         conflict_reg.eq(self.bcp_conflict),
                         conflict_id_reg.eq(self.bcp_conflict_id),
+                        burst_count.eq(0),
                     ]
-                    m.next = "IMPL_CHECK"
+                    m.next = "BURST_LOAD"
 
-            with m.State("IMPL_CHECK"):
+            with m.State("BURST_LOAD"):
+                # One FIFO pop per cycle until the burst is full or the
+                # FIFO is empty.
                 m.d.comb += rsp_status.eq(RSP_BUSY)
-                with m.If(self.impl_valid):
+                with m.If(self.impl_valid & (burst_count != BURST_MAX)):
                     m.d.sync += [
-                        rsp_var.eq(self.impl_var),
-                        rsp_val.eq(self.impl_value),
-                        rsp_reason_id.eq(self.impl_reason),
+                        burst[burst_count].eq(Cat(self.impl_var,
+                                                  self.impl_value,
+                                                  self.impl_reason)),
+                        burst_count.eq(burst_count + 1),
                     ]
+                    m.d.comb += self.impl_ready.eq(1)
+                with m.Elif(self.impl_valid):
                     m.next = "IMPL_READY"
                 with m.Else():
-                    m.d.sync += [
-                        rsp_var.eq(0),
-                        rsp_val.eq(0),
-                        rsp_reason_id.eq(conflict_id_reg),
-                    ]
                     m.next = "DONE_READY"
 
             with m.State("IMPL_READY"):
-                m.d.comb += rsp_status.eq(RSP_IMPLICATION)
+                m.d.comb += [
+                    rsp_status.eq(RSP_IMPLICATION),
+                    drain_wait.eq(1),
+                ]
                 m.d.sync += in_impl_ready.eq(1)
-                with m.If(ack_impl_pending):
-                    m.d.sync += ack_impl_pending.eq(0)
-                    m.d.comb += self.impl_ready.eq(1)
-                    m.next = "IMPL_CHECK"
+                with m.If(reset_pending):
+                    m.next = "RESET"
+                with m.Elif(ack_impl_pending):
+                    m.d.sync += [
+                        ack_impl_pending.eq(0),
+                        burst_count.eq(0),
+                    ]
+                    m.next = "BURST_LOAD"
                 with m.Elif(any_cmd_processed):
                     m.next = "IDLE"
 
             with m.State("DONE_READY"):
                 m.d.sync += in_done_ready.eq(1)
                 m.d.comb += rsp_status.eq(Mux(conflict_reg, RSP_DONE_CONF, RSP_DONE_OK))
-                with m.If(bcp_start_pending):
+                with m.If(reset_pending):
+                    m.next = "RESET"
+                with m.Elif(bcp_start_pending & ~self.assign_bt_busy):
                     m.d.sync += bcp_start_pending.eq(0)
                     m.d.comb += [
                         self.bcp_false_lit.eq(bcp_false_lit_r),
@@ -474,6 +619,37 @@ class JTAGHostInterface(Elaboratable):
                 with m.Elif(any_cmd_processed):
                     m.next = "IDLE"
 
+            with m.State("RESET"):
+                # Reached from IDLE, IMPL_READY or DONE_READY only, so the
+                # accelerator is not running.  Pop whatever the host left
+                # in the FIFO.
+                m.d.comb += rsp_status.eq(RSP_BUSY)
+                with m.If(self.impl_valid):
+                    m.d.comb += self.impl_ready.eq(1)
+                with m.Else():
+                    m.d.sync += [
+                        reset_pending.eq(0),
+                        conflict_reg.eq(0),
+                        burst_count.eq(0),
+                    ]
+                    m.next = "IDLE"
+
+        # =================================================================
+        # Performance counter events
+        # =================================================================
+        m.d.comb += [
+            perf.inc["cycles"].eq(1),
+            perf.inc["bcp_rounds"].eq(self.bcp_start),
+            perf.inc["active"].eq(self.perf_active),
+            perf.inc["wlm_busy"].eq(self.perf_wlm_busy),
+            perf.inc["fetch_stall"].eq(self.perf_fetch_stall),
+            perf.inc["pe_busy"].eq(self.perf_pe_busy),
+            perf.inc["evaluated"].eq(self.perf_evaluated),
+            perf.inc["sat_skips"].eq(self.perf_sat_skip),
+            perf.inc["fifo_full"].eq(self.perf_fifo_full),
+            perf.inc["drain_wait"].eq(drain_wait),
+        ]
+
         # # ==================================================================
         # # LED Control (8 LEDs)
         # #   LED 7 — heartbeat (always)
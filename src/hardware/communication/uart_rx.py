@@ -9,7 +9,8 @@ Parameters
 ----------
 divisor : int
     Clock cycles per bit = clk_freq / baud_rate.
-    At 12 MHz / 1 Mbaud = 12.
+    At 12 MHz / 1 Mbaud = 12.  At least 4, so that the centre sample
+    stays clear of the 2-FF synchroniser delay (3 Mbaud at 12 MHz).
 
 Ports
 -----
@@ -32,6 +33,7 @@ class UARTReceiver(Elaboratable):
     """
 
     def __init__(self, divisor: int = 12):
+        assert divisor >= 4, "UART divisor below 4 cannot be centre-sampled"
         self.divisor = divisor
 
         self.rx_pin   = Signal(reset=1)   # idle high
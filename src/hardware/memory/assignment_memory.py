@@ -4,6 +4,22 @@ Variable Assignment Memory Module for the BCP Accelerator.
 Stores the current assignment state (UNASSIGNED, FALSE, TRUE) for each variable.
 Used by the Clause Evaluator to determine literal truth values during BCP.
 
+The memory also keeps a hardware trail so a backjump is a single command.
+Every write that assigns a previously unassigned variable pushes the variable
+onto the trail.  A write flagged as a decision first records the trail length
+as the checkpoint of a new decision level.  A backtrack to level L pops the
+trail down to the checkpoint of level L+1 and unassigns one popped variable
+per cycle.  Writes that arrive while it runs are ignored (bt_busy is high),
+so the host must let it finish before writing again.
+
+A soft reset (rst_trail) empties the trail and returns to level 0 without
+clearing the values; the host rewrites every variable of the next problem.
+
+The memory can have several read ports, so that clause evaluators can read
+all the literals of several clauses in one cycle.  Every read port is a
+bank of its own: synthesis gives each combinational read port a copy of the
+array, and all copies take the same writes.
+
 See: Hardware Description/BCP_Accelerator_System_Architecture.md, Memory Module 3
 """
 
@@ -28,6 +44,8 @@ class AssignmentMemory(Elaboratable):
     ----------
     max_vars : int
         Maximum number of variables (default 512).
+    num_read_ports : int
+        Number of read ports (default 1).
 
     Ports
     -----
@@ -35,25 +53,52 @@ class AssignmentMemory(Elaboratable):
         Variable ID to read.
     rd_data : Signal(2), out
         Assignment value for the addressed variable (0=UNASSIGNED, 1=FALSE, 2=TRUE).
+    rd_addrs, rd_datas : lists of num_read_ports signals
+        All read ports; rd_addr and rd_data are port 0.
     wr_addr : Signal(range(max_vars)), in
         Variable ID to write.
     wr_data : Signal(2), in
         Assignment value to write.
     wr_en : Signal(), in
         Write enable.
+    wr_decision : Signal(), in
+        With wr_en: this write is a decision and opens a new decision level.
+    bt_level : Signal(range(max_vars)), in
+        Decision level to backtrack to.
+    bt_start : Signal(), in
+        Pulse to unassign every variable assigned above bt_level.
+    bt_busy : Signal(), out
+        High while a backtrack is unassigning variables.
+    rst_trail : Signal(), in
+        Pulse to empty the trail and return to decision level 0.  Ignored
+        while bt_busy is high.
     """
 
-    def __init__(self, max_vars=MAX_VARS):
+    def __init__(self, max_vars=MAX_VARS, num_read_ports=1):
         self.max_vars = max_vars
+        self.num_read_ports = num_read_ports
 
-        # Read port (to Clause Evaluator)
-        self.rd_addr = Signal(range(max_vars))
-        self.rd_data = Signal(2)
+        # Read ports (to the Clause Evaluators)
+        self.rd_addrs = [Signal(range(max_vars), name=f"rd_addr{i}")
+                         for i in range(num_read_ports)]
+        self.rd_datas = [Signal(2, name=f"rd_data{i}")
+                         for i in range(num_read_ports)]
+        self.rd_addr = self.rd_addrs[0]
+        self.rd_data = self.rd_datas[0]
 
         # Write port (from software when variables are assigned)
         self.wr_addr = Signal(range(max_vars))
         self.wr_data = Signal(2)
         self.wr_en = Signal()
+        self.wr_decision = Signal()
+
+        # Backtrack port
+        self.bt_level = Signal(range(max_vars))
+        self.bt_start = Signal()
+        self.bt_busy = Signal()
+
+        # Soft reset
+        self.rst_trail = Signal()
 
     def elaborate(self, platform):
         m = Module()
@@ -63,19 +108,96 @@ class AssignmentMemory(Elaboratable):
             shape=2, depth=self.max_vars, init=[]
         )
 
-        # Read port - combinational (transparent) for single-cycle reads
-        rd_port = mem.read_port(domain="comb")
+        # Read ports - combinational (transparent) for single-cycle reads
+        for addr, data in zip(self.rd_addrs, self.rd_datas):
+            rd_port = mem.read_port(domain="comb")
+            m.d.comb += [
+                rd_port.addr.eq(addr),
+                data.eq(rd_port.data),
+            ]
+
+        # Hardware trail: variables in assignment order, and per decision
+        # level the trail length at which the level began.
+        m.submodules.trail = trail = Memory(
+            shape=range(self.max_vars), depth=self.max_vars, init=[]
+        )
+        m.submodules.level_lim = level_lim = Memory(
+            shape=range(self.max_vars + 1), depth=self.max_vars, init=[]
+        )
+        trail_len = Signal(range(self.max_vars + 1))
+        cur_level = Signal(range(self.max_vars + 1))
+        bt_target = Signal(range(self.max_vars + 1))
+
+        # Old value of the variable being written
+        old_port = mem.read_port(domain="comb")
+        m.d.comb += old_port.addr.eq(self.wr_addr)
+
+        trail_wr = trail.write_port()
+        trail_top = trail.read_port(domain="comb")
+        lim_wr = level_lim.write_port()
+        lim_rd = level_lim.read_port(domain="comb")
         m.d.comb += [
-            rd_port.addr.eq(self.rd_addr),
-            self.rd_data.eq(rd_port.data),
+            trail_top.addr.eq(trail_len - 1),
+            lim_rd.addr.eq(self.bt_level),
         ]
 
         # Write port - synchronous
         wr_port = mem.write_port()
-        m.d.comb += [
-            wr_port.addr.eq(self.wr_addr),
-            wr_port.data.eq(self.wr_data),
-            wr_port.en.eq(self.wr_en),
-        ]
+
+        with m.FSM():
+            with m.State("IDLE"):
+                m.d.comb += [
+                    wr_port.addr.eq(self.wr_addr),
+                    wr_port.data.eq(self.wr_data),
+                    wr_port.en.eq(self.wr_en),
+                ]
+
+                # A decision's checkpoint is the trail length before its
+                # own variable is pushed
+                with m.If(self.wr_en & self.wr_decision &
+                          (cur_level != self.max_vars)):
+                    m.d.comb += [
+                        lim_wr.addr.eq(cur_level),
+                        lim_wr.data.eq(trail_len),
+                        lim_wr.en.eq(1),
+                    ]
+                    m.d.sync += cur_level.eq(cur_level + 1)
+
+                with m.If(self.wr_en & (self.wr_data != UNASSIGNED) &
+                          (old_port.data == UNASSIGNED) &
+                          (trail_len != self.max_vars)):
+                    m.d.comb += [
+                        trail_wr.addr.eq(trail_len),
+                        trail_wr.data.eq(self.wr_addr),
+                        trail_wr.en.eq(1),
+                    ]
+                    m.d.sync += trail_len.eq(trail_len + 1)
+
+                with m.If(self.bt_start & (self.bt_level < cur_level)):
+                    m.d.sync += [
+                        bt_target.eq(lim_rd.data),
+                        cur_level.eq(self.bt_level),
+                    ]
+                    m.next = "POP"
+
+                # Last, so it wins over a push or a checkpoint in the same
+                # cycle
+                with m.If(self.rst_trail):
+                    m.d.sync += [
+                        trail_len.eq(0),
+                        cur_level.eq(0),
+                    ]
+
+            with m.State("POP"):
+                m.d.comb += self.bt_busy.eq(1)
+                with m.If(trail_len > bt_target):
+                    m.d.comb += [
+                        wr_port.addr.eq(trail_top.data),
+                        wr_port.data.eq(UNASSIGNED),
+                        wr_port.en.eq(1),
+                    ]
+                    m.d.sync += trail_len.eq(trail_len - 1)
+                with m.Else():
+                    m.next = "IDLE"
 
         return m
@@ -2,6 +2,9 @@
 
 from .bcp_accelerator import BCPAccelerator
 from .watch_list_manager import WatchListManager
+from .clause_dispatcher import ClauseDispatcher
 from .clause_prefetcher import ClausePrefetcher
 from .clause_evaluator import ClauseEvaluator
+from .clause_evaluator_pe import ClauseEvaluatorPE
 from .implication_fifo import ImplicationFIFO
+from .perf_counters import PerfCounters
@@ -1,26 +1,47 @@
 """
 BCP Hardware Accelerator — Top-Level Module.
 
-Integrates the full BCP pipeline: Watch List Manager → Clause Prefetcher →
-Clause Evaluator → Implication FIFO, backed by the three memory modules
-(Clause Database, Watch Lists, Variable Assignments).
+Integrates the full BCP pipeline: Watch List Manager → Clause Dispatcher →
+Clause Prefetcher → evaluator PEs → Implication FIFO, backed by the three
+memory modules (Clause Database, Watch Lists, Variable Assignments).
+
+The dispatcher hands the clauses of the watch list to num_pes parallel
+evaluator PEs in turn.  Each PE reads all the literals of its clause in one
+cycle through read ports of its own on the assignment memory.  When several
+PEs finish together, a conflict is taken from the lowest-numbered PE that
+has one, and UNIT results enter the FIFO one per cycle, lowest-numbered PE
+first; the others hold their result until their turn.
+
+A PE evaluates against the assignments as of its EVAL cycle, so it may not
+yet see an implication another PE is reporting at the same time.  It may
+then report the same implication twice, or one that contradicts it; the
+host drivers already treat the first as a repeat and the second as a
+conflict on its reason clause, which every literal of that clause then
+falsifies.
 
 Provides a clean interface to the software CDCL controller: start with a
-false_lit, receive implications and/or a conflict, wait for done.
+false_lit, receive implications and/or a conflict, wait for done.  Every
+implication that enters the FIFO is also written to the assignment memory,
+so later clauses in the same round (and later rounds) see it without the
+host writing it back.
 
 See: Hardware Description/BCP_Accelerator_System_Architecture.md
 """
 
 from amaranth import *
 
-from memory.clause_memory import ClauseMemory, MAX_CLAUSES, LIT_WIDTH
+from memory.clause_memory import ClauseMemory, MAX_CLAUSES, MAX_K, LIT_WIDTH
 from memory.watch_list_memory import (WatchListMemory, NUM_LITERALS,
                                       MAX_WATCH_LEN, CLAUSE_ID_WIDTH, LENGTH_WIDTH)
-from memory.assignment_memory import AssignmentMemory, MAX_VARS
+from memory.assignment_memory import (AssignmentMemory, MAX_VARS,
+                                      FALSE as ASSIGN_FALSE,
+                                      TRUE as ASSIGN_TRUE)
 
 from .watch_list_manager import WatchListManager
+from .clause_dispatcher import ClauseDispatcher, NUM_PES
 from .clause_prefetcher import ClausePrefetcher
-from .clause_evaluator import ClauseEvaluator, UNIT, CONFLICT
+from .clause_evaluator import UNIT, CONFLICT
+from .clause_evaluator_pe import ClauseEvaluatorPE
 from .implication_fifo import ImplicationFIFO
 
 
@@ -31,6 +52,11 @@ class BCPAccelerator(Elaboratable):
     Replaces the inner loop of CDCL propagate().  Processes all clauses
     watching a literal that became false.
 
+    Parameters
+    ----------
+    num_pes : int
+        Number of parallel evaluator PEs (default 4).
+
     Ports — control
     ----------------
     start     : Signal(), in   — pulse to begin BCP
@@ -50,9 +76,20 @@ class BCPAccelerator(Elaboratable):
     impl_value  : Signal(), out
     impl_reason : Signal(), out
     impl_ready  : Signal(), in  — software acknowledges / pops
+
+    Ports — performance counter events (see perf_counters.py)
+    ----------------------------------------------------------
+    perf_wlm_busy    : Signal(), out — ACTIVE, Watch List Manager not done
+    perf_fetch_stall : Signal(), out — dispatcher queue waiting on a PE
+    perf_pe_busy     : Signal(range(num_pes + 1)), out — PEs holding a clause
+    perf_evaluated   : Signal(range(num_pes + 1)), out — results taken
+    perf_sat_skip    : Signal(), out — clause delivered with its sat bit set
+    perf_fifo_full   : Signal(), out — UNIT result lost to a full FIFO
     """
 
-    def __init__(self):
+    def __init__(self, num_pes=NUM_PES):
+        self.num_pes = num_pes
+
         # --- Control interface ---
         self.start = Signal()
         self.false_lit = Signal(range(NUM_LITERALS))
@@ -95,14 +132,30 @@ class BCPAccelerator(Elaboratable):
         self.assign_wr_addr = Signal(range(MAX_VARS))
         self.assign_wr_data = Signal(2)
         self.assign_wr_en   = Signal()
+        self.assign_wr_decision = Signal()
+
+        # Assignment memory backtrack and soft reset ports
+        self.assign_bt_level = Signal(range(MAX_VARS))
+        self.assign_bt_start = Signal()
+        self.assign_bt_busy  = Signal()
+        self.assign_rst      = Signal()
+
+        # --- Performance counter events ---
+        self.perf_wlm_busy    = Signal()
+        self.perf_fetch_stall = Signal()
+        self.perf_pe_busy     = Signal(range(num_pes + 1))
+        self.perf_evaluated   = Signal(range(num_pes + 1))
+        self.perf_sat_skip    = Signal()
+        self.perf_fifo_full   = Signal()
 
         # --- Sub-modules (created here for external / test access) ---
         self.clause_mem = ClauseMemory()
         self.watch_mem = WatchListMemory()
-        self.assign_mem = AssignmentMemory()
+        self.assign_mem = AssignmentMemory(num_read_ports=num_pes * MAX_K)
         self.watch_mgr = WatchListManager()
+        self.dispatcher = ClauseDispatcher(num_pes=num_pes)
         self.prefetcher = ClausePrefetcher()
-        self.evaluator = ClauseEvaluator()
+        self.pes = [ClauseEvaluatorPE() for _ in range(num_pes)]
         self.impl_fifo = ImplicationFIFO()
 
     def elaborate(self, platform):
@@ -113,16 +166,19 @@ class BCPAccelerator(Elaboratable):
         watch_mem = self.watch_mem
         assign_mem = self.assign_mem
         watch_mgr = self.watch_mgr
+        dispatcher = self.dispatcher
         prefetcher = self.prefetcher
-        evaluator = self.evaluator
+        pes = self.pes
         impl_fifo = self.impl_fifo
 
         m.submodules.clause_mem = clause_mem
         m.submodules.watch_mem = watch_mem
         m.submodules.assign_mem = assign_mem
         m.submodules.watch_mgr = watch_mgr
+        m.submodules.dispatcher = dispatcher
         m.submodules.prefetcher = prefetcher
-        m.submodules.evaluator = evaluator
+        for i, pe in enumerate(pes):
+            m.submodules[f"pe{i}"] = pe
         m.submodules.impl_fifo = impl_fifo
 
         # =============================================================
@@ -142,10 +198,12 @@ class BCPAccelerator(Elaboratable):
             watch_mgr.wl_rd_len.eq(watch_mem.rd_len),
         ]
 
-        # Watch List Manager → Clause Prefetcher
+        # Watch List Manager → Clause Dispatcher → Clause Prefetcher
         m.d.comb += [
-            prefetcher.clause_id_in.eq(watch_mgr.clause_id),
-            prefetcher.clause_id_valid.eq(watch_mgr.clause_id_valid),
+            dispatcher.clause_id_in.eq(watch_mgr.clause_id),
+            dispatcher.clause_id_valid.eq(watch_mgr.clause_id_valid),
+            prefetcher.clause_id_in.eq(dispatcher.fetch_id),
+            prefetcher.clause_id_valid.eq(dispatcher.fetch_valid),
         ]
 
         # Clause Prefetcher ↔ Clause Memory
@@ -162,32 +220,88 @@ class BCPAccelerator(Elaboratable):
             prefetcher.clause_rd_lit4.eq(clause_mem.rd_data_lit4),
         ]
 
-        # Clause Prefetcher → Clause Evaluator
-        m.d.comb += [
-            evaluator.clause_id_in.eq(prefetcher.clause_id_out),
-            evaluator.meta_valid.eq(prefetcher.meta_valid),
-            evaluator.sat_bit.eq(prefetcher.out_sat_bit),
-            evaluator.size.eq(prefetcher.out_size),
-            evaluator.lit0.eq(prefetcher.out_lit0),
-            evaluator.lit1.eq(prefetcher.out_lit1),
-            evaluator.lit2.eq(prefetcher.out_lit2),
-            evaluator.lit3.eq(prefetcher.out_lit3),
-            evaluator.lit4.eq(prefetcher.out_lit4),
-        ]
+        # Clause Prefetcher → evaluator PEs: the clause goes to every PE,
+        # and the dispatcher says which one takes it
+        for i, pe in enumerate(pes):
+            m.d.comb += [
+                pe.clause_id_in.eq(prefetcher.clause_id_out),
+                pe.meta_valid.eq(dispatcher.deliver_valid
+                                 & (dispatcher.deliver_pe == i)),
+                pe.sat_bit.eq(prefetcher.out_sat_bit),
+                pe.size.eq(prefetcher.out_size),
+                pe.lit0.eq(prefetcher.out_lit0),
+                pe.lit1.eq(prefetcher.out_lit1),
+                pe.lit2.eq(prefetcher.out_lit2),
+                pe.lit3.eq(prefetcher.out_lit3),
+                pe.lit4.eq(prefetcher.out_lit4),
+                dispatcher.pe_idle[i].eq(pe.idle),
+            ]
 
-        # Clause Evaluator ↔ Assignment Memory
-        m.d.comb += [
-            assign_mem.rd_addr.eq(evaluator.assign_rd_addr),
-            evaluator.assign_rd_data.eq(assign_mem.rd_data),
-        ]
+        # Evaluator PEs ↔ Assignment Memory: MAX_K read ports per PE
+        for i, pe in enumerate(pes):
+            base = i * MAX_K
+            m.d.comb += [
+                assign_mem.rd_addrs[base + 0].eq(pe.assign_rd_addr0),
+                assign_mem.rd_addrs[base + 1].eq(pe.assign_rd_addr1),
+                assign_mem.rd_addrs[base + 2].eq(pe.assign_rd_addr2),
+                assign_mem.rd_addrs[base + 3].eq(pe.assign_rd_addr3),
+                assign_mem.rd_addrs[base + 4].eq(pe.assign_rd_addr4),
+                pe.assign_rd_data0.eq(assign_mem.rd_datas[base + 0]),
+                pe.assign_rd_data1.eq(assign_mem.rd_datas[base + 1]),
+                pe.assign_rd_data2.eq(assign_mem.rd_datas[base + 2]),
+                pe.assign_rd_data3.eq(assign_mem.rd_datas[base + 3]),
+                pe.assign_rd_data4.eq(assign_mem.rd_datas[base + 4]),
+            ]
 
-        # Clause Evaluator → Implication FIFO (UNIT results)
+        # Result reduction.  UNIT results share the FIFO and the assignment
+        # write port, so one is granted per cycle, lowest-numbered PE first.
+        # Every other result is taken as soon as it is valid.
+        unit_req = [pe.result_valid & (pe.result_status == UNIT) for pe in pes]
+        conf_req = [pe.result_valid & (pe.result_status == CONFLICT) for pe in pes]
+        unit_grant = []
+        earlier = C(0)
+        for i, pe in enumerate(pes):
+            grant = Signal(name=f"unit_grant{i}")
+            m.d.comb += [
+                grant.eq(unit_req[i] & ~earlier),
+                pe.result_ready.eq((pe.result_status != UNIT) | grant),
+            ]
+            unit_grant.append(grant)
+            earlier = earlier | unit_req[i]
+
+        retire = Cat(*[pe.result_valid & pe.result_ready for pe in pes])
+        n_retire = Signal(range(self.num_pes + 1))
+        m.d.comb += n_retire.eq(sum(retire[i] for i in range(self.num_pes)))
+
+        impl_push = Signal()
+        impl_var = Signal(range(MAX_VARS))
+        impl_val = Signal()
+        impl_reason = Signal(range(MAX_CLAUSES))
+        for i, pe in enumerate(pes):
+            with m.If(unit_grant[i]):
+                m.d.comb += [
+                    impl_push.eq(1),
+                    impl_var.eq(pe.result_implied_var),
+                    impl_val.eq(pe.result_implied_val),
+                    impl_reason.eq(pe.result_clause_id),
+                ]
+
+        # Priority-encoded conflict: the lowest-numbered PE with one
+        detect_conflict = Signal()
+        detect_cid = Signal(range(MAX_CLAUSES))
+        for i in reversed(range(self.num_pes)):
+            with m.If(conf_req[i]):
+                m.d.comb += [
+                    detect_conflict.eq(1),
+                    detect_cid.eq(pes[i].result_clause_id),
+                ]
+
+        # Evaluator PEs → Implication FIFO (UNIT results)
         m.d.comb += [
-            impl_fifo.push_valid.eq(
-                evaluator.result_valid & (evaluator.result_status == UNIT)),
-            impl_fifo.push_var.eq(evaluator.result_implied_var),
-            impl_fifo.push_value.eq(evaluator.result_implied_val),
-            impl_fifo.push_reason.eq(evaluator.result_clause_id),
+            impl_fifo.push_valid.eq(impl_push),
+            impl_fifo.push_var.eq(impl_var),
+            impl_fifo.push_value.eq(impl_val),
+            impl_fifo.push_reason.eq(impl_reason),
         ]
 
         # Implication FIFO → Top-level interface
@@ -222,11 +336,29 @@ class BCPAccelerator(Elaboratable):
             watch_mem.wr_len.eq(self.wl_wr_len),
             watch_mem.wr_en.eq(self.wl_wr_en),
             watch_mem.wr_len_en.eq(self.wl_wr_len_en),
+        ]
 
-            # Assignments
-            assign_mem.wr_addr.eq(self.assign_wr_addr),
-            assign_mem.wr_data.eq(self.assign_wr_data),
-            assign_mem.wr_en.eq(self.assign_wr_en),
+        # Assignments: an implication accepted by the FIFO is applied
+        # directly; otherwise the host write port drives the memory.  The
+        # host only writes between BCP rounds, so the two never collide.
+        with m.If(impl_push & ~impl_fifo.fifo_full):
+            m.d.comb += [
+                assign_mem.wr_addr.eq(impl_var),
+                assign_mem.wr_data.eq(Mux(impl_val, ASSIGN_TRUE, ASSIGN_FALSE)),
+                assign_mem.wr_en.eq(1),
+            ]
+        with m.Else():
+            m.d.comb += [
+                assign_mem.wr_addr.eq(self.assign_wr_addr),
+                assign_mem.wr_data.eq(self.assign_wr_data),
+                assign_mem.wr_en.eq(self.assign_wr_en),
+                assign_mem.wr_decision.eq(self.assign_wr_decision),
+            ]
+        m.d.comb += [
+            assign_mem.bt_level.eq(self.assign_bt_level),
+            assign_mem.bt_start.eq(self.assign_bt_start),
+            self.assign_bt_busy.eq(assign_mem.bt_busy),
+            assign_mem.rst_trail.eq(self.assign_rst),
         ]
 
         # =============================================================
@@ -239,16 +371,20 @@ class BCPAccelerator(Elaboratable):
         wlm_done_seen = Signal()
         fsm_starting = Signal()
 
+        # The dispatcher and the PEs only run in ACTIVE, so nothing left
+        # over from a round cut short by a conflict reaches the next one
+        flush = Signal(init=1)
+        m.d.comb += dispatcher.flush.eq(flush)
+        for pe in pes:
+            m.d.comb += pe.flush.eq(flush)
+
         do_inc = watch_mgr.clause_id_valid
-        do_dec = evaluator.result_valid
 
-        # --- In-flight counter ---
+        # --- In-flight counter: clauses between the stream and a result ---
         with m.If(fsm_starting):
             m.d.sync += in_flight.eq(0)
-        with m.Elif(do_inc & ~do_dec):
-            m.d.sync += in_flight.eq(in_flight + 1)
-        with m.Elif(do_dec & ~do_inc):
-            m.d.sync += in_flight.eq(in_flight - 1)
+        with m.Else():
+            m.d.sync += in_flight.eq(in_flight + do_inc - n_retire)
 
         # --- Conflict latch ---
         with m.If(fsm_starting):
@@ -256,12 +392,10 @@ class BCPAccelerator(Elaboratable):
                 conflict_reg.eq(0),
                 conflict_cid_reg.eq(0),
             ]
-        with m.Elif(evaluator.result_valid
-                     & (evaluator.result_status == CONFLICT)
-                     & ~conflict_reg):
+        with m.Elif(detect_conflict & ~conflict_reg):
             m.d.sync += [
                 conflict_reg.eq(1),
-                conflict_cid_reg.eq(evaluator.result_clause_id),
+                conflict_cid_reg.eq(detect_cid),
             ]
 
         m.d.comb += [
@@ -276,9 +410,6 @@ class BCPAccelerator(Elaboratable):
             m.d.sync += wlm_done_seen.eq(1)
 
         # --- Top-level FSM ---
-        detect_conflict = (evaluator.result_valid
-                           & (evaluator.result_status == CONFLICT))
-
         with m.FSM():
             with m.State("IDLE"):
                 with m.If(self.start):
@@ -289,7 +420,10 @@ class BCPAccelerator(Elaboratable):
                     m.next = "ACTIVE"
 
             with m.State("ACTIVE"):
-                m.d.comb += self.busy.eq(1)
+                m.d.comb += [
+                    self.busy.eq(1),
+                    flush.eq(0),
+                ]
 
                 with m.If(conflict_reg | detect_conflict):
                     m.next = "DONE"
@@ -301,4 +435,17 @@ class BCPAccelerator(Elaboratable):
                 m.d.comb += self.done.eq(1)
                 m.next = "IDLE"
 
+        # =============================================================
+        # Performance counter events
+        # =============================================================
+
+        m.d.comb += [
+            self.perf_wlm_busy.eq(self.busy & ~wlm_done_seen),
+            self.perf_fetch_stall.eq(dispatcher.stall),
+            self.perf_pe_busy.eq(sum(~pe.idle for pe in pes)),
+            self.perf_evaluated.eq(n_retire),
+            self.perf_sat_skip.eq(dispatcher.deliver_valid & prefetcher.out_sat_bit),
+            self.perf_fifo_full.eq(impl_push & impl_fifo.fifo_full),
+        ]
+
         return m
@@ -0,0 +1,180 @@
+"""
+Clause Dispatcher Module for the BCP Accelerator.
+
+Sits between the Watch List Manager and the Clause Prefetcher and hands
+clauses to the parallel evaluator PEs in round-robin order.
+
+The Watch List Manager streams one clause ID per cycle and cannot stall, so
+the IDs go into a queue deep enough for a whole watch list.  An ID leaves
+the queue only when the PE whose turn it is is idle; the PE is then
+reserved until the prefetched clause reaches it two cycles later.  That
+is the backpressure the single sequential evaluator lacked: it dropped a
+clause that arrived while it was still busy with the previous one.
+
+Strict round robin keeps the order of the watch list.  All PEs take the
+same number of cycles per clause, so the PE whose turn it is is the one
+that has been busy the longest.
+
+flush empties the queue and cancels reservations; the accelerator asserts
+it between rounds.
+
+See: Hardware Description/BCP_Accelerator_System_Architecture.md, Sub-Module 1
+"""
+
+from amaranth import *
+from amaranth.lib.memory import Memory
+
+from memory.watch_list_memory import MAX_WATCH_LEN, CLAUSE_ID_WIDTH
+from memory.clause_memory import MAX_CLAUSES
+
+
+# Default number of evaluator PEs
+NUM_PES = 4
+
+
+class ClauseDispatcher(Elaboratable):
+    """
+    Clause Dispatcher.
+
+    Parameters
+    ----------
+    num_pes : int
+        Number of evaluator PEs (default 4).
+    depth : int
+        Clause ID queue depth (default MAX_WATCH_LEN, one whole watch list).
+    max_clauses : int
+        Maximum clause count (default 8192).
+
+    Ports — inputs (from Watch List Manager)
+    -----------------------------------------
+    clause_id_in    : Signal(range(max_clauses)), in
+    clause_id_valid : Signal(), in
+
+    Ports — outputs (to Clause Prefetcher)
+    ---------------------------------------
+    fetch_id    : Signal(range(max_clauses)), out
+    fetch_valid : Signal(), out  — an ID leaves the queue this cycle
+
+    Ports — PE interface
+    ---------------------
+    pe_idle       : Signal(num_pes), in   — idle output of each PE
+    deliver_valid : Signal(), out  — prefetched clause arriving this cycle
+    deliver_pe    : Signal(range(num_pes)), out — the PE it is for
+
+    Ports — control
+    ----------------
+    flush : Signal(), in
+    stall : Signal(), out  — IDs queued but none fetched this cycle
+                             (performance counter event)
+    """
+
+    def __init__(self, num_pes=NUM_PES, depth=MAX_WATCH_LEN,
+                 max_clauses=MAX_CLAUSES):
+        self.num_pes = num_pes
+        self.depth = depth
+        self.max_clauses = max_clauses
+
+        # Inputs (from Watch List Manager)
+        self.clause_id_in = Signal(range(max_clauses))
+        self.clause_id_valid = Signal()
+
+        # Outputs (to Clause Prefetcher)
+        self.fetch_id = Signal(range(max_clauses))
+        self.fetch_valid = Signal()
+
+        # PE interface
+        self.pe_idle = Signal(num_pes)
+        self.deliver_valid = Signal()
+        self.deliver_pe = Signal(range(num_pes))
+
+        # Control
+        self.flush = Signal()
+        self.stall = Signal()
+
+    def elaborate(self, platform):
+        m = Module()
+
+        # --- Clause ID queue ---
+        m.submodules.queue = queue = Memory(
+            shape=CLAUSE_ID_WIDTH, depth=self.depth, init=[]
+        )
+        q_wr = queue.write_port()
+        q_rd = queue.read_port(domain="comb")
+
+        wr_ptr = Signal(range(self.depth))
+        rd_ptr = Signal(range(self.depth))
+        count = Signal(range(self.depth + 1))
+
+        push = Signal()
+        pop = Signal()
+        m.d.comb += push.eq(self.clause_id_valid & (count != self.depth))
+
+        m.d.comb += [
+            q_wr.addr.eq(wr_ptr),
+            q_wr.data.eq(self.clause_id_in),
+            q_wr.en.eq(push),
+            q_rd.addr.eq(rd_ptr),
+        ]
+
+        # --- Round-robin issue ---
+        rr = Signal(range(self.num_pes))
+        reserved = Signal(self.num_pes)
+        pe_free = Signal(self.num_pes)
+        m.d.comb += pe_free.eq(self.pe_idle & ~reserved)
+
+        m.d.comb += [
+            pop.eq((count != 0) & pe_free.bit_select(rr, 1) & ~self.flush),
+            self.fetch_id.eq(q_rd.data),
+            self.fetch_valid.eq(pop),
+            self.stall.eq((count != 0) & ~pop & ~self.flush),
+        ]
+
+        # The PE of each fetch travels alongside the clause memory read
+        stage1_valid = Signal()
+        stage1_pe = Signal(range(self.num_pes))
+        stage2_valid = Signal()
+        stage2_pe = Signal(range(self.num_pes))
+        m.d.sync += [
+            stage1_valid.eq(pop),
+            stage1_pe.eq(rr),
+            stage2_valid.eq(stage1_valid),
+            stage2_pe.eq(stage1_pe),
+        ]
+        m.d.comb += [
+            self.deliver_valid.eq(stage2_valid & ~self.flush),
+            self.deliver_pe.eq(stage2_pe),
+        ]
+
+        # Reserved from the fetch until the delivery
+        set_mask = Signal(self.num_pes)
+        clr_mask = Signal(self.num_pes)
+        with m.If(pop):
+            m.d.comb += set_mask.eq(Const(1, self.num_pes) << rr)
+        with m.If(stage2_valid):
+            m.d.comb += clr_mask.eq(Const(1, self.num_pes) << stage2_pe)
+
+        with m.If(self.flush):
+            m.d.sync += [
+                wr_ptr.eq(0),
+                rd_ptr.eq(0),
+                count.eq(0),
+                rr.eq(0),
+                reserved.eq(0),
+                stage1_valid.eq(0),
+                stage2_valid.eq(0),
+            ]
+        with m.Else():
+            m.d.sync += reserved.eq((reserved & ~clr_mask) | set_mask)
+            with m.If(push):
+                m.d.sync += wr_ptr.eq(Mux(wr_ptr == self.depth - 1, 0, wr_ptr + 1))
+            with m.If(pop):
+                m.d.sync += [
+                    rd_ptr.eq(Mux(rd_ptr == self.depth - 1, 0, rd_ptr + 1)),
+                    rr.eq(Mux(rr == self.num_pes - 1, 0, rr + 1)),
+                ]
+            with m.If(push & ~pop):
+                m.d.sync += count.eq(count + 1)
+            with m.Elif(pop & ~push):
+                m.d.sync += count.eq(count - 1)
+
+        return m
@@ -0,0 +1,201 @@
+"""
+Parallel Clause Evaluator (processing element) for the BCP Accelerator.
+
+Evaluates a prefetched clause like the Clause Evaluator, but reads all
+MAX_K literals at once through MAX_K assignment memory read ports instead
+of walking them one per cycle.  The BCP Accelerator runs several of these
+side by side, fed by the Clause Dispatcher.
+
+A result is held in OUTPUT until result_ready is high, so several PEs can
+share the implication FIFO: the accelerator grants one UNIT result per
+cycle and a PE waiting for its turn accepts no new clause.
+
+FSM: IDLE → EVAL → OUTPUT
+
+Latency: 1 cycle (latch) + 1 cycle (eval) + 1 cycle (output).
+Sat-bit early exit: 2 cycles total.
+
+Sources: SAT-Accel, FYalSAT (parallel clause evaluation)
+
+See: Hardware Description/BCP_Accelerator_System_Architecture.md, Module 3
+"""
+
+from amaranth import *
+
+from memory.clause_memory import MAX_CLAUSES, MAX_K, LIT_WIDTH
+from memory.assignment_memory import MAX_VARS, UNASSIGNED, FALSE, TRUE
+
+from .clause_evaluator import SATISFIED, UNIT, CONFLICT, UNRESOLVED
+
+
+class ClauseEvaluatorPE(Elaboratable):
+    """
+    Parallel Clause Evaluator.
+
+    Parameters
+    ----------
+    max_clauses : int
+        Maximum number of clauses (default 8192).
+    max_vars : int
+        Maximum number of variables (default 512).
+
+    Ports — inputs (from Clause Prefetcher, via the Clause Dispatcher)
+    -------------------------------------------------------------------
+    clause_id_in : Signal(range(max_clauses)), in
+    meta_valid   : Signal(), in   — only asserted while idle is high
+    sat_bit      : Signal(), in
+    size         : Signal(3), in
+    lit0–lit4    : Signal(LIT_WIDTH), in
+
+    Ports — assignment memory interface (one read port per literal)
+    ----------------------------------------------------------------
+    assign_rd_addr0–4 : Signal(range(max_vars)), out
+    assign_rd_data0–4 : Signal(2), in
+
+    Ports — outputs (evaluation result)
+    ------------------------------------
+    result_status      : Signal(2), out
+    result_implied_var : Signal(range(max_vars)), out
+    result_implied_val : Signal(), out
+    result_clause_id   : Signal(range(max_clauses)), out
+    result_valid       : Signal(), out  — held until result_ready
+    result_ready       : Signal(), in   — the result is taken this cycle
+
+    Ports — control
+    ----------------
+    idle  : Signal(), out  — ready to take a clause
+    flush : Signal(), in   — drop any clause in progress
+    """
+
+    def __init__(self, max_clauses=MAX_CLAUSES, max_vars=MAX_VARS):
+        self.max_clauses = max_clauses
+        self.max_vars = max_vars
+
+        # Inputs from Clause Prefetcher
+        self.clause_id_in = Signal(range(max_clauses))
+        self.meta_valid = Signal()
+        self.sat_bit = Signal()
+        self.size = Signal(3)
+        self.lit0 = Signal(LIT_WIDTH)
+        self.lit1 = Signal(LIT_WIDTH)
+        self.lit2 = Signal(LIT_WIDTH)
+        self.lit3 = Signal(LIT_WIDTH)
+        self.lit4 = Signal(LIT_WIDTH)
+
+        # Assignment memory read interface, one port per literal
+        self.assign_rd_addr0 = Signal(range(max_vars))
+        self.assign_rd_addr1 = Signal(range(max_vars))
+        self.assign_rd_addr2 = Signal(range(max_vars))
+        self.assign_rd_addr3 = Signal(range(max_vars))
+        self.assign_rd_addr4 = Signal(range(max_vars))
+        self.assign_rd_data0 = Signal(2)
+        self.assign_rd_data1 = Signal(2)
+        self.assign_rd_data2 = Signal(2)
+        self.assign_rd_data3 = Signal(2)
+        self.assign_rd_data4 = Signal(2)
+
+        # Evaluation result outputs
+        self.result_status = Signal(2)
+        self.result_implied_var = Signal(range(max_vars))
+        self.result_implied_val = Signal()
+        self.result_clause_id = Signal(range(max_clauses))
+        self.result_valid = Signal()
+        self.result_ready = Signal()
+
+        # Control
+        self.idle = Signal()
+        self.flush = Signal()
+
+    def elaborate(self, platform):
+        m = Module()
+
+        rd_addrs = [self.assign_rd_addr0, self.assign_rd_addr1,
+                    self.assign_rd_addr2, self.assign_rd_addr3,
+                    self.assign_rd_addr4]
+        rd_datas = [self.assign_rd_data0, self.assign_rd_data1,
+                    self.assign_rd_data2, self.assign_rd_data3,
+                    self.assign_rd_data4]
+        lits_in = [self.lit0, self.lit1, self.lit2, self.lit3, self.lit4]
+
+        # Internal registers
+        clause_id_reg = Signal(range(self.max_clauses))
+        size_reg = Signal(3)
+        status_reg = Signal(2)
+        implied_lit = Signal(LIT_WIDTH)
+        lit_regs = [Signal(LIT_WIDTH, name=f"lit_reg{i}") for i in range(MAX_K)]
+
+        # Variable ID = literal >> 1 (strip polarity bit)
+        for k in range(MAX_K):
+            m.d.comb += rd_addrs[k].eq(lit_regs[k] >> 1)
+
+        # Per-literal status, all literals at once.  Literals at or beyond
+        # size_reg are ignored.
+        lit_true = Signal(MAX_K)
+        lit_unassigned = Signal(MAX_K)
+        for k in range(MAX_K):
+            active = k < size_reg
+            pol = lit_regs[k][0]
+            val = rd_datas[k]
+            m.d.comb += [
+                lit_true[k].eq(active & (
+                    ((~pol) & (val == TRUE)) | (pol & (val == FALSE)))),
+                lit_unassigned[k].eq(active & (val == UNASSIGNED)),
+            ]
+
+        unassigned_count = Signal(range(MAX_K + 1))
+        m.d.comb += unassigned_count.eq(sum(lit_unassigned[k] for k in range(MAX_K)))
+
+        # The last unassigned literal, as the sequential evaluator reports
+        last_unassigned_lit = Signal(LIT_WIDTH)
+        for k in range(MAX_K):
+            with m.If(lit_unassigned[k]):
+                m.d.comb += last_unassigned_lit.eq(lit_regs[k])
+
+        with m.FSM(name="eval"):
+            with m.State("IDLE"):
+                m.d.comb += self.idle.eq(1)
+                with m.If(self.meta_valid & ~self.flush):
+                    m.d.sync += [
+                        clause_id_reg.eq(self.clause_id_in),
+                        size_reg.eq(self.size),
+                    ]
+                    m.d.sync += [lit_regs[k].eq(lits_in[k]) for k in range(MAX_K)]
+                    with m.If(self.sat_bit):
+                        # Early exit: clause already satisfied
+                        m.d.sync += status_reg.eq(SATISFIED)
+                        m.next = "OUTPUT"
+                    with m.Else():
+                        m.next = "EVAL"
+
+            with m.State("EVAL"):
+                with m.If(lit_true.any()):
+                    m.d.sync += status_reg.eq(SATISFIED)
+                with m.Elif(unassigned_count == 0):
+                    m.d.sync += status_reg.eq(CONFLICT)
+                with m.Elif(unassigned_count == 1):
+                    m.d.sync += [
+                        status_reg.eq(UNIT),
+                        implied_lit.eq(last_unassigned_lit),
+                    ]
+                with m.Else():
+                    m.d.sync += status_reg.eq(UNRESOLVED)
+
+                with m.If(self.flush):
+                    m.next = "IDLE"
+                with m.Else():
+                    m.next = "OUTPUT"
+
+            with m.State("OUTPUT"):
+                m.d.comb += [
+                    self.result_valid.eq(~self.flush),
+                    self.result_status.eq(status_reg),
+                    self.result_clause_id.eq(clause_id_reg),
+                    self.result_implied_var.eq(implied_lit >> 1),
+                    # Positive literal (pol=0) → assign TRUE (1)
+                    # Negative literal (pol=1) → assign FALSE (0)
+                    self.result_implied_val.eq(~implied_lit[0]),
+                ]
+                with m.If(self.flush | self.result_ready):
+                    m.next = "IDLE"
+
+        return m
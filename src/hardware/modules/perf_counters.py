@@ -0,0 +1,87 @@
+"""
+Performance Counters Module for the BCP Accelerator.
+
+A bank of free-running event counters that the host reads over JTAG to see
+where the accelerator's cycles go.  Each counter adds its increment input
+every cycle; most increments are one-bit strobes, the per-PE ones count
+how many PEs had the event that cycle.
+
+The counters are PERF_WIDTH bits wide and wrap.  The host samples them
+periodically and widens the differences, so they are never cleared.  A
+read goes through a snapshot bank: `snapshot` copies every counter at
+once, and `rd_data` then shows PERF_PER_READ consecutive snapshot values
+starting at `rd_idx`, so a set of values read over several commands is
+consistent.  Indices past the last counter read as zero.
+
+See: Hardware Description/BCP_Accelerator_System_Architecture.md,
+Performance Counters
+"""
+
+from amaranth import *
+
+
+# Counter names, in the order of their indices
+PERF_COUNTERS = [
+    "cycles",       # clock cycles
+    "bcp_rounds",   # BCP_START commands taken by the accelerator
+    "active",       # accelerator cycles in ACTIVE
+    "wlm_busy",     # ACTIVE cycles before the Watch List Manager is done
+    "fetch_stall",  # clause IDs queued at the dispatcher, none fetched
+    "pe_busy",      # PE-cycles spent holding a clause (summed over PEs)
+    "evaluated",    # clause results taken from the PEs
+    "sat_skips",    # clauses skipped on the sat bit (early exit)
+    "fifo_full",    # UNIT results lost to a full Implication FIFO
+    "drain_wait",   # cycles a full burst waits for the host's ACK_IMPL
+]
+NUM_PERF = len(PERF_COUNTERS)
+
+# Counter width
+PERF_WIDTH = 32
+
+# Consecutive counters shown by one read
+PERF_PER_READ = 3
+
+
+class PerfCounters(Elaboratable):
+    """
+    Performance counter bank.
+
+    Parameters
+    ----------
+    inc_width : int
+        Width of the increment inputs (default 3, up to 7 per cycle).
+
+    Ports
+    -----
+    inc      : dict of Signal(inc_width), in — increment per counter name
+    snapshot : Signal(), in  — copy every counter into the snapshot bank
+    rd_idx   : Signal(8), in — index of the first counter read
+    rd_data  : list of PERF_PER_READ Signal(PERF_WIDTH), out
+               — snapshot values of counters rd_idx, rd_idx + 1, ...
+    """
+
+    def __init__(self, inc_width=3):
+        self.inc = {name: Signal(inc_width, name=f"inc_{name}")
+                    for name in PERF_COUNTERS}
+        self.snapshot = Signal()
+        self.rd_idx = Signal(8)
+        self.rd_data = [Signal(PERF_WIDTH, name=f"rd_data{i}")
+                        for i in range(PERF_PER_READ)]
+
+    def elaborate(self, platform):
+        m = Module()
+
+        counts = [Signal(PERF_WIDTH, name=f"count_{name}") for name in PERF_COUNTERS]
+        shots = [Signal(PERF_WIDTH, name=f"shot_{name}") for name in PERF_COUNTERS]
+
+        for name, count, shot in zip(PERF_COUNTERS, counts, shots):
+            m.d.sync += count.eq(count + self.inc[name])
+            with m.If(self.snapshot):
+                m.d.sync += shot.eq(count)
+
+        # Zero padding: an out-of-range index selects the last element
+        bank = Array(shots + [Const(0, PERF_WIDTH)] * PERF_PER_READ)
+        for i in range(PERF_PER_READ):
+            m.d.comb += self.rd_data[i].eq(bank[self.rd_idx + i])
+
+        return m
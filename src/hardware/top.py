@@ -12,7 +12,10 @@ Wires together the four main submodules and connects them to FPGA I/O:
         └─ tx_pin ◄── UARTTransmitter ◄──────┘
 
 Build target: Lattice ECP5-5G Evaluation Board (12 MHz system clock).
-Baud rate: 1 Mbaud → divisor = 12.
+Baud rate: 1 Mbaud → divisor = 12 by default.  Any rate that divides the
+clock with a divisor of at least 4 can be built (up to 3 Mbaud at 12 MHz),
+e.g. `python top.py 3000000`; the host driver must be opened at the same
+rate (sat_solver -b uart -p /dev/cu.usbserial-XXX@3000000).
 """
 
 from amaranth import *
@@ -23,10 +26,15 @@ from communication.host_interface import HostInterface
 from modules.bcp_accelerator import BCPAccelerator
 
 
+CLK_FREQ = 12_000_000
+
+
 class BCPTop(Elaboratable):
-    def __init__(self):
-        self.uart_rx = UARTReceiver(divisor=12)
-        self.uart_tx = UARTTransmitter(divisor=12)
+    def __init__(self, baud=1_000_000):
+        divisor = CLK_FREQ // baud
+        assert divisor * baud == CLK_FREQ, "baud must divide the clock"
+        self.uart_rx = UARTReceiver(divisor=divisor)
+        self.uart_tx = UARTTransmitter(divisor=divisor)
         self.host_if = HostInterface()
         self.bcp     = BCPAccelerator()
 
@@ -63,6 +71,7 @@ class BCPTop(Elaboratable):
         m.d.comb += [
             host_if.rx_data.eq(uart_rx.rx_data),
             host_if.rx_valid.eq(uart_rx.rx_valid),
+            host_if.rx_err.eq(uart_rx.rx_err),
         ]
 
         # ── HostInterface → UART TX ─────────────────────────────────────
@@ -128,6 +137,8 @@ class BCPTop(Elaboratable):
 
 
 if __name__ == "__main__":
+    import sys
     from amaranth_boards.ecp5_5g_evn import ECP55GEVNPlatform
+    baud = int(sys.argv[1]) if len(sys.argv) > 1 else 1_000_000
     platform = ECP55GEVNPlatform()
-    platform.build(BCPTop(), do_program=False, name="bcp_accel")
+    platform.build(BCPTop(baud=baud), do_program=False, name="bcp_accel")
@@ -19,11 +19,12 @@ from modules.bcp_accelerator import BCPAccelerator
 
 class BCPTopJTAG(Elaboratable):
     def __init__(self, use_jtagg_primitive=True, diagnostic_mode=False):
+        self.bcp = BCPAccelerator()
         self.host_if = JTAGHostInterface(
             use_jtagg_primitive=use_jtagg_primitive,
             diagnostic_mode=diagnostic_mode,
+            num_pes=self.bcp.num_pes,
         )
-        self.bcp = BCPAccelerator()
 
     def elaborate(self, platform):
         m = Module()
@@ -84,6 +85,22 @@ class BCPTopJTAG(Elaboratable):
             bcp.assign_wr_addr.eq(host_if.assign_wr_addr),
             bcp.assign_wr_data.eq(host_if.assign_wr_data),
             bcp.assign_wr_en.eq(host_if.assign_wr_en),
+            bcp.assign_wr_decision.eq(host_if.assign_wr_decision),
+            bcp.assign_bt_level.eq(host_if.assign_bt_level),
+            bcp.assign_bt_start.eq(host_if.assign_bt_start),
+            host_if.assign_bt_busy.eq(bcp.assign_bt_busy),
+            bcp.assign_rst.eq(host_if.assign_rst),
+        ]
+
+        # ── BCP → JTAGHostInterface (performance counter events) ────────
+        m.d.comb += [
+            host_if.perf_active.eq(bcp.busy),
+            host_if.perf_wlm_busy.eq(bcp.perf_wlm_busy),
+            host_if.perf_fetch_stall.eq(bcp.perf_fetch_stall),
+            host_if.perf_pe_busy.eq(bcp.perf_pe_busy),
+            host_if.perf_evaluated.eq(bcp.perf_evaluated),
+            host_if.perf_sat_skip.eq(bcp.perf_sat_skip),
+            host_if.perf_fifo_full.eq(bcp.perf_fifo_full),
         ]
 
         return m
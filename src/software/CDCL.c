@@ -3,9 +3,15 @@
  *
  * A standard CDCL implementation following the modern architecture:
  *   1. Unit propagation (BCP) with a two-watched-literal scheme
- *   2. VSIDS-style decision heuristic
- *   3. First-UIP conflict analysis with clause learning
+ *   2. VSIDS-style decision heuristic (binary-heap decision queue)
+ *   3. First-UIP conflict analysis with recursive clause minimization
  *   4. Non-chronological backtracking
+ *   5. LBD-scored learned clause database reduction
+ *   6. Luby or Glucose-style (LBD moving average) restarts
+ *   7. Phase saving, with optional target phases and rephasing
+ *   8. Optional SatELite-style preprocessing: subsumption, self-subsuming
+ *      resolution and bounded variable elimination
+ *   9. Optional DRAT proof logging of UNSAT answers
  *
  * CNF formulas are provided in a simple internal representation.
  * Variables are numbered 1..n. Literals use the mapping:
@@ -18,13 +24,78 @@
 #include <string.h>
 #include <stdbool.h>
 #include <assert.h>
+#include <time.h>
 
 #include "CDCL.h"
+#include "bcp_backend.h"
+#include "portfolio.h"
+#include "proof.h"
+
+/* Learned clause database reduction schedule (Glucose-style): the first
+ * reduce_db runs after REDUCE_FIRST conflicts, and each interval is
+ * REDUCE_INC conflicts longer than the previous one.  Clauses with
+ * LBD <= REDUCE_KEEP_LBD ("glue" clauses) are never deleted. */
+#define REDUCE_FIRST    2000
+#define REDUCE_INC      300
+#define REDUCE_KEEP_LBD 2
+
+/* Restart parameters.  Luby restarts after LUBY_UNIT * luby(i) conflicts.
+ * Glucose-style restarts fire when the fast LBD average exceeds the slow
+ * one by GLUCOSE_MARGIN, at least GLUCOSE_MIN_CONFLICTS after the previous
+ * restart; once past GLUCOSE_BLOCK_START conflicts, a restart is postponed
+ * when the trail is GLUCOSE_BLOCK_MARGIN times longer than average (the
+ * solver is probably close to a model). */
+#define LUBY_UNIT             100
+#define GLUCOSE_EMA_FAST      (1.0 / 32)
+#define GLUCOSE_EMA_SLOW      (1.0 / 4096)
+#define GLUCOSE_EMA_TRAIL     (1.0 / 4096)
+#define GLUCOSE_MARGIN        1.25
+#define GLUCOSE_MIN_CONFLICTS 50
+#define GLUCOSE_BLOCK_START   10000
+#define GLUCOSE_BLOCK_MARGIN  1.4
+
+/* Rephasing (POLARITY_TARGET): the n-th rephase happens REPHASE_INTERVAL * n
+ * conflicts after the previous one. */
+#define REPHASE_INTERVAL 1000
+
+/* Phase timers.  With -DCDCL_PROFILE=1, PROF_START(t) reads the cycle
+ * counter into a local `t` and PROF_STOP() adds the cycles since then to
+ * s->stats.cycles[phase]; otherwise both compile to nothing. */
+#ifndef CDCL_PROFILE
+#define CDCL_PROFILE 0
+#endif
 
-#ifdef USE_HW_BCP
-#include "hw_interface.h"
+#if CDCL_PROFILE
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+static inline uint64_t cycle_count(void) { return __rdtsc(); }
+#elif defined(__aarch64__)
+static inline uint64_t cycle_count(void) {
+    uint64_t t;
+    __asm__ volatile("mrs %0, cntvct_el0" : "=r"(t));
+    return t;
+}
+#else
+static inline uint64_t cycle_count(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+#endif
+#define PROF_START(t)          uint64_t t = cycle_count()
+#define PROF_STOP(s, phase, t) ((s)->stats.cycles[phase] += cycle_count() - (t))
+#else
+#define PROF_START(t)          ((void)0)
+#define PROF_STOP(s, phase, t) ((void)0)
 #endif
 
+/* Preprocessing: a variable is eliminated only if it occurs in at most
+ * PP_OCC_MAX clauses and no resolvent is longer than PP_RESOLVENT_MAX
+ * literals.  PP_BUDGET bounds the literals one pass may visit. */
+#define PP_OCC_MAX       24
+#define PP_RESOLVENT_MAX 20
+#define PP_BUDGET        50000000
+
 /* ========================================================================= */
 /*  Utility helpers                                                          */
 /* ========================================================================= */
@@ -39,123 +110,527 @@ static inline int lit_var(int code) {
     return code / 2;
 }
 
+/* Convert an internal code back to a signed literal. */
+static inline int code_to_lit(int code) {
+    return (code & 1) ? -(code / 2) : code / 2;
+}
+
 /* Return the negation of an internal literal code. Does this by flipping least significant bit (+1/-1). */
 static inline int lit_neg(int code) {
     return code ^ 1;
 }
 
+/* Monotonic clock, in seconds. */
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* ========================================================================= */
+/*  VSIDS decision heap                                                      */
+/* ========================================================================= */
+
+/*
+ * Indexed binary max-heap of variables ordered by activity.  The root is the
+ * variable with the highest activity; heap_index[] gives each variable's
+ * position so a bumped variable can be moved up in O(log n).  Assigned
+ * variables are removed lazily by pick_decision_var() and re-inserted by
+ * backtrack() when they become unassigned again.
+ */
+
+static inline bool heap_contains(CDCLSolver *s, int var) {
+    return s->heap_index[var] >= 0;
+}
+
+/* Move the variable at position `i` towards the root while it beats its parent. */
+static void heap_percolate_up(CDCLSolver *s, int i) {
+    int    var = s->heap[i];
+    double act = s->activity[var];
+    while (i > 0) {
+        int parent = (i - 1) >> 1;
+        if (s->activity[s->heap[parent]] >= act) break;
+        s->heap[i] = s->heap[parent];
+        s->heap_index[s->heap[i]] = i;
+        i = parent;
+    }
+    s->heap[i] = var;
+    s->heap_index[var] = i;
+}
+
+/* Move the variable at position `i` towards the leaves while a child beats it. */
+static void heap_percolate_down(CDCLSolver *s, int i) {
+    int    var = s->heap[i];
+    double act = s->activity[var];
+    while (true) {
+        int child = 2 * i + 1;
+        if (child >= s->heap_size) break;
+        /* Pick the larger of the two children. */
+        if (child + 1 < s->heap_size &&
+            s->activity[s->heap[child + 1]] > s->activity[s->heap[child]])
+            child++;
+        if (s->activity[s->heap[child]] <= act) break;
+        s->heap[i] = s->heap[child];
+        s->heap_index[s->heap[i]] = i;
+        i = child;
+    }
+    s->heap[i] = var;
+    s->heap_index[var] = i;
+}
+
+/* Insert a variable into the decision heap (no-op if already present). */
+static void heap_insert(CDCLSolver *s, int var) {
+    if (heap_contains(s, var)) return;
+    int i = s->heap_size++;
+    s->heap[i] = var;
+    s->heap_index[var] = i;
+    heap_percolate_up(s, i);
+}
+
+/* Remove and return the variable with the highest activity. */
+static int heap_remove_max(CDCLSolver *s) {
+    int top = s->heap[0];
+    s->heap_index[top] = -1;
+    if (--s->heap_size > 0) {
+        s->heap[0] = s->heap[s->heap_size];
+        s->heap_index[s->heap[0]] = 0;
+        heap_percolate_down(s, 0);
+    }
+    return top;
+}
+
 /* ========================================================================= */
 /*  Solver creation / destruction                                            */
 /* ========================================================================= */
 
+/* Size the per-variable and per-literal arrays for `num_vars` variables.
+ * They only grow: a cdcl_reset() to fewer variables keeps them as they
+ * are.  Their contents are set by vars_init(). */
+static void vars_reserve(CDCLSolver *s, int num_vars) {
+    if (s->values && num_vars <= s->var_cap) return;
+    /* Internal literal codes range from 2..2*num_vars+1.  Allocate 2*n+2. */
+    int old_lits = s->values ? 2 * s->var_cap + 2 : 0;
+    int lits = 2 * num_vars + 2;
+    size_t vars = (size_t)num_vars + 1;
+
+    /* Assignment, one byte per literal code. */
+    s->values = (signed char *)realloc(s->values, lits * sizeof(signed char));
+
+    /* Watched-literal and binary implication lists: one per literal code.
+     * New lists start out empty and unallocated. */
+    s->watches     = (Watcher **)realloc(s->watches, lits * sizeof(Watcher *));
+    s->watch_cap   = (int *)realloc(s->watch_cap, lits * sizeof(int));
+    s->watch_size  = (int *)realloc(s->watch_size, lits * sizeof(int));
+    s->bin_watches = (Watcher **)realloc(s->bin_watches, lits * sizeof(Watcher *));
+    s->bin_cap     = (int *)realloc(s->bin_cap, lits * sizeof(int));
+    s->bin_size    = (int *)realloc(s->bin_size, lits * sizeof(int));
+    for (int i = old_lits; i < lits; i++) {
+        s->watches[i] = s->bin_watches[i] = NULL;
+        s->watch_cap[i] = s->bin_cap[i] = 0;
+    }
+
+    /* Variable-indexed arrays (index 0 unused). */
+    s->vardata         = (VarData *)realloc(s->vardata, vars * sizeof(VarData));
+    s->activity        = (double *)realloc(s->activity, vars * sizeof(double));
+    s->trail           = (int *)realloc(s->trail, vars * sizeof(int));
+    s->seen            = (char *)realloc(s->seen, vars * sizeof(char));
+    s->analyze_stack   = (int *)realloc(s->analyze_stack, vars * sizeof(int));
+    s->analyze_toclear = (int *)realloc(s->analyze_toclear, vars * sizeof(int));
+    s->learnt          = (int *)realloc(s->learnt, vars * sizeof(int));
+    s->phase           = (signed char *)realloc(s->phase, vars * sizeof(signed char));
+    s->target_phase    = (signed char *)realloc(s->target_phase, vars * sizeof(signed char));
+    s->best_phase      = (signed char *)realloc(s->best_phase, vars * sizeof(signed char));
+    s->model           = (int *)realloc(s->model, vars * sizeof(int));
+    s->frozen          = (char *)realloc(s->frozen, vars * sizeof(char));
+    s->eliminated      = (char *)realloc(s->eliminated, vars * sizeof(char));
+    s->heap            = (int *)realloc(s->heap, vars * sizeof(int));
+    s->heap_index      = (int *)realloc(s->heap_index, vars * sizeof(int));
+    s->var_cap = num_vars;
+
+    /* Per-level arrays; assumptions can add levels (cdcl_solve_assumptions()). */
+    if ((int)vars > s->level_cap) {
+        s->level_cap        = (int)vars;
+        s->trail_delimiters = (int *)realloc(s->trail_delimiters, vars * sizeof(int));
+        s->level_stamp      = (uint32_t *)realloc(s->level_stamp, vars * sizeof(uint32_t));
+    }
+}
+
+/* Put a solver with its arrays reserved and its configuration set into
+ * the state of a new one: no clauses, nothing assigned, no history. */
+static void vars_init(CDCLSolver *s) {
+    int num_vars = s->num_vars;
+
+    memset(s->values, 0xFF, (2 * num_vars + 2) * sizeof(signed char)); /* UNASSIGNED = -1 */
+    for (int i = 0; i <= num_vars; i++) {
+        s->vardata[i].level  = 0;
+        s->vardata[i].reason = CREF_UNDEF;
+    }
+    memset(s->activity, 0, (num_vars + 1) * sizeof(double));
+    int cap_lits = 2 * s->var_cap + 2;
+    memset(s->watch_size, 0, cap_lits * sizeof(int));
+    memset(s->bin_size, 0, cap_lits * sizeof(int));
+
+    /* VSIDS decay factor. (Baseline Conflict Bump) */
+    s->var_inc = 1.0;
+
+    /* Learned clause database reduction. */
+    s->cla_inc     = 1.0;
+    memset(s->level_stamp, 0, s->level_cap * sizeof(uint32_t));
+    s->next_reduce = REDUCE_FIRST;
+
+    /* Conflict analysis scratch space, allocated once. */
+    memset(s->seen, 0, (num_vars + 1) * sizeof(char));
+
+    /* Decision polarity — every phase starts out FALSE. */
+    memset(s->phase, 0, (num_vars + 1) * sizeof(signed char));
+    memset(s->target_phase, 0, (num_vars + 1) * sizeof(signed char));
+    memset(s->best_phase, 0, (num_vars + 1) * sizeof(signed char));
+    s->next_rephase = REPHASE_INTERVAL;
+
+    /* Incremental solving. */
+    memset(s->model, 0xFF, (num_vars + 1) * sizeof(int)); /* UNASSIGNED */
+
+    /* Preprocessing. */
+    memset(s->frozen, 0, (num_vars + 1) * sizeof(char));
+    memset(s->eliminated, 0, (num_vars + 1) * sizeof(char));
+
+    /* Decision heap — every variable starts out unassigned, so all are queued.
+     * With equal (zero) activities this keeps variable 1 at the root. */
+    s->heap_size = 0;
+    for (int v = 0; v <= num_vars; v++) s->heap_index[v] = -1;
+    for (int v = 1; v <= num_vars; v++) heap_insert(s, v);
+}
+
 CDCLSolver *cdcl_create(int num_vars) {
     CDCLSolver *s = (CDCLSolver *)calloc(1, sizeof(CDCLSolver));
     // calloc zero-initializes.
     s->num_vars = num_vars;
-    /* Internal literal codes range from 2..2*num_vars+1.  Allocate 2*n+2. */
-    int lits = 2 * num_vars + 2;
+    vars_reserve(s, num_vars);
 
-    /* Variable-indexed arrays (index 0 unused). */
-    // Store assignment, decision level, reason (Clause that implied 'v'), and activity (VSIDS) for each variable (1-indexed).
-    s->assigns    = (int *)malloc((num_vars + 1) * sizeof(int));
-    s->levels     = (int *)malloc((num_vars + 1) * sizeof(int));
-    s->reasons    = (int *)malloc((num_vars + 1) * sizeof(int));
-    s->activity   = (double *)calloc(num_vars + 1, sizeof(double));
-    memset(s->assigns, 0xFF, (num_vars + 1) * sizeof(int)); /* UNASSIGNED = -1 (Two's complement: 0xFF)*/
-    memset(s->levels, 0, (num_vars + 1) * sizeof(int));
-    for (int i = 0; i <= num_vars; i++) s->reasons[i] = -1;
-
-    /* Propagation trail. */
-    s->trail      = (int *)malloc((num_vars + 1) * sizeof(int));
-    s->trail_size = 0;
-    s->trail_delimiters = (int *)malloc((num_vars + 1) * sizeof(int));
-    s->num_decisions    = 0;
-
-    /* Watched-literal lists: one list per literal code. */
-    s->watch_cap  = (int *)calloc(lits, sizeof(int));
-    s->watch_size = (int *)calloc(lits, sizeof(int));
-    s->watches    = (int **)calloc(lits, sizeof(int *));
+    /* Clause arena — start with 64K words; grows geometrically. */
+    s->arena_cap = 1 << 16;
+    s->arena = (uint32_t *)malloc(s->arena_cap * sizeof(uint32_t));
 
     /* Clause database — start with room for 1024 clauses. */
     s->clause_cap = 1024;
-    s->clause_count = 0;
-    s->clauses = (Clause **)calloc(s->clause_cap, sizeof(Clause *));
+    s->clauses = (CRef *)calloc(s->clause_cap, sizeof(CRef));
 
-    /* VSIDS decay factor. (Baseline Conflict Bump) */
-    s->var_inc = 1.0;
+    /* Configuration defaults. */
+    s->restart_policy = RESTART_GLUCOSE;
+    s->polarity       = POLARITY_SAVED;
+    s->rand_state     = 0x9E3779B97F4A7C15ull;
+    s->backend        = &bcp_backend_sw;
+    s->backend_port   = NULL;
 
+    vars_init(s);
     return s;
 }
 
+void cdcl_reset(CDCLSolver *s, int num_vars) {
+    CDCLSolver old = *s;
+    memset(s, 0, sizeof(CDCLSolver));
+
+    /* Buffers, kept with their capacity. */
+    s->values          = old.values;
+    s->vardata         = old.vardata;
+    s->activity        = old.activity;
+    s->heap            = old.heap;
+    s->heap_index      = old.heap_index;
+    s->trail           = old.trail;
+    s->trail_delimiters = old.trail_delimiters;
+    s->watches         = old.watches;
+    s->watch_size      = old.watch_size;
+    s->watch_cap       = old.watch_cap;
+    s->bin_watches     = old.bin_watches;
+    s->bin_size        = old.bin_size;
+    s->bin_cap         = old.bin_cap;
+    s->arena           = old.arena;
+    s->arena_cap       = old.arena_cap;
+    s->clauses         = old.clauses;
+    s->clause_cap      = old.clause_cap;
+    s->level_stamp     = old.level_stamp;
+    s->seen            = old.seen;
+    s->analyze_stack   = old.analyze_stack;
+    s->analyze_toclear = old.analyze_toclear;
+    s->learnt          = old.learnt;
+    s->phase           = old.phase;
+    s->target_phase    = old.target_phase;
+    s->best_phase      = old.best_phase;
+    s->assumptions     = old.assumptions;
+    s->assumptions_cap = old.assumptions_cap;
+    s->core            = old.core;
+    s->level_cap       = old.level_cap;
+    s->model           = old.model;
+    s->frozen          = old.frozen;
+    s->eliminated      = old.eliminated;
+    s->elim_stack      = old.elim_stack;
+    s->elim_cap        = old.elim_cap;
+    s->var_cap         = old.var_cap;
+
+    /* Configuration. */
+    s->restart_policy = old.restart_policy;
+    s->polarity       = old.polarity;
+    s->rand_state     = old.rand_state;
+    s->backend        = old.backend;
+    s->backend_port   = old.backend_port;
+    s->stats_interval = old.stats_interval;
+
+    s->num_vars = num_vars;
+    vars_reserve(s, num_vars);
+    vars_init(s);
+}
+
 void cdcl_destroy(CDCLSolver *s) {
-    int lits = 2 * s->num_vars + 2;
+    int lits = 2 * s->var_cap + 2;
     for (int i = 0; i < lits; i++) free(s->watches[i]);
     free(s->watches);
     free(s->watch_cap);
     free(s->watch_size);
-    for (int i = 0; i < s->clause_count; i++) free(s->clauses[i]);
+    for (int i = 0; i < lits; i++) free(s->bin_watches[i]);
+    free(s->bin_watches);
+    free(s->bin_cap);
+    free(s->bin_size);
     free(s->clauses);
+    free(s->arena);
+    free(s->base_watch);
     free(s->trail);
     free(s->trail_delimiters);
-    free(s->assigns);
-    free(s->levels);
-    free(s->reasons);
+    free(s->values);
+    free(s->vardata);
     free(s->activity);
+    free(s->level_stamp);
+    free(s->seen);
+    free(s->analyze_stack);
+    free(s->analyze_toclear);
+    free(s->learnt);
+    free(s->phase);
+    free(s->target_phase);
+    free(s->best_phase);
+    free(s->heap);
+    free(s->heap_index);
+    free(s->assumptions);
+    free(s->core);
+    free(s->model);
+    free(s->frozen);
+    free(s->eliminated);
+    free(s->elim_stack);
     free(s);
 }
 
 /* ========================================================================= */
-/*  Watched-literal helpers                                                  */
+/*  Clause arena                                                             */
 /* ========================================================================= */
 
-/* Add clause index `ci` to the watch list of literal `lit`. */
-static void watch_add(CDCLSolver *s, int lit, int ci) {
-    // Dynamically grows the watch list if needed. Starts w/ capacity 4 and doubles as needed.
-    if (s->watch_size[lit] == s->watch_cap[lit]) {
-        s->watch_cap[lit] = s->watch_cap[lit] ? s->watch_cap[lit] * 2 : 4;
-        // reallocates, preserving existing contents.
-        s->watches[lit] = (int *)realloc(s->watches[lit],
-                                         s->watch_cap[lit] * sizeof(int));
+/* Words occupied by a clause of `size` literals (header + literals). */
+static inline uint32_t clause_words(uint32_t size) {
+    return (uint32_t)CLAUSE_HEADER_WORDS + size;
+}
+
+/*
+ * Make room for `need` more words in the arena.  Grows by at least 1.5x so
+ * repeated allocation stays amortized linear; CRefs must stay below
+ * REASON_BINARY, or below CREF_BASE in a solver with a ClauseBase.
+ */
+static void arena_reserve(CDCLSolver *s, uint64_t need) {
+    if ((uint64_t)(s->arena_cap - s->arena_size) >= need) return;
+    uint64_t limit = s->base_arena ? CREF_BASE : REASON_BINARY;
+    uint64_t cap = (uint64_t)s->arena_cap + s->arena_cap / 2;
+    if (cap < s->arena_size + need) cap = s->arena_size + need;
+    if (cap > limit) {
+        if (s->arena_size + need > limit) {
+            fprintf(stderr, "cdcl: clause arena exhausted\n");
+            abort();
+        }
+        cap = limit;
     }
-    // Add the clause index to the watch list and increment the size.
-    s->watches[lit][s->watch_size[lit]++] = ci;
+    s->arena = (uint32_t *)realloc(s->arena, (size_t)cap * sizeof(uint32_t));
+    s->arena_cap = (uint32_t)cap;
 }
 
-/* ========================================================================= */
-/*  Clause addition                                                          */
-/* ========================================================================= */
+/*
+ * Allocate a clause of `len` literals at the end of the arena and return its
+ * reference.  Any Clause pointer obtained before this call may be stale
+ * afterwards (the arena can move when it grows).
+ */
+static CRef clause_alloc(CDCLSolver *s, int len, bool learnt) {
+    uint32_t need = clause_words((uint32_t)len);
+    arena_reserve(s, need);
+
+    CRef cr = s->arena_size;
+    s->arena_size += need;
+
+    Clause *c = cdcl_clause(s, cr);
+    c->size     = (uint32_t)len;
+    c->learnt   = learnt;
+    c->deleted  = 0;
+    c->reloced  = 0;
+    c->hw       = 0;
+    c->lbd      = 0;
+    c->activity = 0.0f;
+    return cr;
+}
 
 /*
- * Add a clause given as an array of signed literals (1-based, negated = negative).
- * Returns the clause index, or -1 if the clause is a tautology / empty.
+ * Copy one clause into the new arena `to` (if it hasn't been moved yet) and
+ * rewrite `*cr` to its new location.  The old copy is marked `reloced` with
+ * the forwarding reference in its `lbd` field, so later references to the
+ * same clause resolve to the same new copy.  Clauses of a ClauseBase stay
+ * where they are.
  */
-int cdcl_add_clause(CDCLSolver *s, int *signed_lits, int len) {
-    /* Grow clause database if necessary. */
-    if (s->clause_count == s->clause_cap) {
-        s->clause_cap *= 2;
-        s->clauses = (Clause **)realloc(s->clauses,
-                                        s->clause_cap * sizeof(Clause *));
+static void clause_reloc(CDCLSolver *s, uint32_t *to, uint32_t *to_size, CRef *cr) {
+    if (*cr & CREF_BASE) return;
+    Clause *c = cdcl_clause(s, *cr);
+    if (c->reloced) {
+        *cr = c->lbd;
+        return;
     }
+    uint32_t words = clause_words(c->size);
+    CRef moved = *to_size;
+    memcpy(to + moved, c, (size_t)words * sizeof(uint32_t));
+    *to_size += words;
+
+    c->reloced = 1;
+    c->lbd     = moved;
+    *cr = moved;
+}
 
-    /* Allocate and populate clause. */
-    Clause *c = (Clause *)malloc(sizeof(Clause) + len * sizeof(int));
-    c->size = len;
-    c->learnt = false;
-    for (int i = 0; i < len; i++) {
-        c->lits[i] = lit_to_code(signed_lits[i]);
+/*
+ * Compacting garbage collector.  Copies every live clause into a fresh arena
+ * and rewrites all clause references — watch lists, reasons and the clause
+ * list — to the new offsets.  Watchers of deleted clauses are dropped here,
+ * so deletion only has to mark the clause.
+ */
+static void collect_garbage(CDCLSolver *s) {
+    uint32_t  cap = s->arena_size - s->arena_wasted;
+    if (cap < (1u << 16)) cap = 1u << 16;
+    uint32_t *to = (uint32_t *)malloc((size_t)cap * sizeof(uint32_t));
+    uint32_t  to_size = 0;
+
+    /* Watch lists first: clauses watched by the same literal end up
+     * adjacent in the new arena, which is the order BCP visits them. */
+    int lits = 2 * s->num_vars + 2;
+    for (int lit = 0; lit < lits; lit++) {
+        Watcher *ws = s->watches[lit];
+        int j = 0;
+        for (int i = 0; i < s->watch_size[lit]; i++) {
+            if (cdcl_clause(s, ws[i].cref)->deleted) continue;
+            clause_reloc(s, to, &to_size, &ws[i].cref);
+            ws[j++] = ws[i];
+        }
+        s->watch_size[lit] = j;
+    }
+
+    /* Binary implication lists, keeping the BIN_RESIDENT flags. */
+    for (int lit = 0; lit < lits; lit++) {
+        Watcher *ws = s->bin_watches[lit];
+        int j = 0;
+        for (int i = 0; i < s->bin_size[lit]; i++) {
+            CRef flag = ws[i].cref & BIN_RESIDENT;
+            CRef cr   = ws[i].cref & ~BIN_RESIDENT;
+            if (cdcl_clause(s, cr)->deleted) continue;
+            clause_reloc(s, to, &to_size, &cr);
+            ws[j].cref    = cr | flag;
+            ws[j].blocker = ws[i].blocker;
+            j++;
+        }
+        s->bin_size[lit] = j;
+    }
+
+    /* Reasons of assigned variables (never deleted: they are locked).
+     * Inline binary reasons hold a literal, not a reference. */
+    for (int i = 0; i < s->trail_size; i++) {
+        int var = lit_var(s->trail[i]);
+        if (s->vardata[var].reason != CREF_UNDEF && !(s->vardata[var].reason & REASON_BINARY))
+            clause_reloc(s, to, &to_size, &s->vardata[var].reason);
+    }
+
+    /* Clauses resident on the accelerator (deleted ones were dropped by
+     * the backend's `reduced` hook before the collection). */
+    if (s->backend->refs) {
+        int hw_count;
+        CRef *hw_refs = s->backend->refs(&hw_count);
+        for (int i = 0; i < hw_count; i++) {
+            if (hw_refs[i] != CREF_UNDEF)
+                clause_reloc(s, to, &to_size, &hw_refs[i]);
+        }
+    }
+
+    /* Clause list — also picks up unwatched (unit / empty) clauses. */
+    int j = 0, scanned = s->clauses_scanned;
+    for (int i = 0; i < s->clause_count; i++) {
+        CRef cr = s->clauses[i];
+        if (cdcl_clause(s, cr)->deleted) {
+            if (i < s->clauses_scanned) scanned--;
+            continue;
+        }
+        clause_reloc(s, to, &to_size, &cr);
+        s->clauses[j++] = cr;
     }
+    s->clause_count    = j;
+    s->clauses_scanned = scanned;
+
+    free(s->arena);
+    s->arena        = to;
+    s->arena_size   = to_size;
+    s->arena_cap    = cap;
+    s->arena_wasted = 0;
+}
+
+/* Run the garbage collector once deleted clauses waste 20% of the arena. */
+static void check_garbage(CDCLSolver *s) {
+    if (s->arena_wasted > s->arena_size / 5)
+        collect_garbage(s);
+}
 
-    int ci = s->clause_count;
-    s->clauses[ci] = c;
-    s->clause_count++;
+/* ========================================================================= */
+/*  Watched-literal helpers                                                  */
+/* ========================================================================= */
 
-    /* Set up watched literals: watch the first two literals (if >= 2). */
-    if (len >= 2) {
-        watch_add(s, c->lits[0], ci);
-        watch_add(s, c->lits[1], ci);
+/* Append a watcher to a watch (or binary implication) list. */
+static void watcher_push(Watcher **list, int *size, int *cap,
+                         CRef cr, int blocker) {
+    // Dynamically grows the list if needed. Starts w/ capacity 4 and doubles as needed.
+    if (*size == *cap) {
+        *cap = *cap ? *cap * 2 : 4;
+        // reallocates, preserving existing contents.
+        *list = (Watcher *)realloc(*list, *cap * sizeof(Watcher));
     }
+    // Add the watcher to the list and increment the size.
+    Watcher *w = &(*list)[(*size)++];
+    w->cref    = cr;
+    w->blocker = blocker;
+}
+
+/* Add clause `cr` to the watch list of literal `lit`, with `blocker` as its
+ * blocking literal. */
+static void watch_add(CDCLSolver *s, int lit, CRef cr, int blocker) {
+    watcher_push(&s->watches[lit], &s->watch_size[lit], &s->watch_cap[lit],
+                 cr, blocker);
+}
+
+/* Record binary clause `cr` = (lit ∨ other) in the implication list of `lit`. */
+static void bin_add(CDCLSolver *s, int lit, CRef cr, int other) {
+    watcher_push(&s->bin_watches[lit], &s->bin_size[lit], &s->bin_cap[lit],
+                 cr, other);
+}
 
-    return ci;
+/* Hook a clause into BCP: binary clauses go to the implication lists, longer
+ * ones watch their first two literals.  Units and empty clauses are handled
+ * by cdcl_solve() directly. */
+static void attach_clause(CDCLSolver *s, CRef cr) {
+    Clause *c = cdcl_clause(s, cr);
+    if (c->size == 2) {
+        bin_add(s, c->lits[0], cr, c->lits[1]);
+        bin_add(s, c->lits[1], cr, c->lits[0]);
+    } else if (c->size > 2) {
+        watch_add(s, c->lits[0], cr, c->lits[1]);
+        watch_add(s, c->lits[1], cr, c->lits[0]);
+        if (cr & CREF_BASE) {
+            int *w = s->base_watch + 2 * (size_t)c->lbd;
+            w[0] = c->lits[0];
+            w[1] = c->lits[1];
+        }
+    }
 }
 
 /* ========================================================================= */
@@ -164,45 +639,362 @@ int cdcl_add_clause(CDCLSolver *s, int *signed_lits, int len) {
 
 /* Return the current truth value of an internal literal code. */
 static inline int lit_value(CDCLSolver *s, int code) {
-    int var = lit_var(code);
-    if (s->assigns[var] == UNASSIGNED) return UNASSIGNED;
-    /* Positive literal (even code): value matches assignment.
-       Negative literal (odd code): value is flipped.
-       Returns 0 for FALSE, 1 for TRUE, -1 for UNASSIGNED */
-    if (code & 1)
-        return s->assigns[var] ^ 1; /* flip 0<->1 */
-    else
-        return s->assigns[var];
+    /* Returns 0 for FALSE, 1 for TRUE, -1 for UNASSIGNED */
+    return s->values[code];
 }
 
 /* Enqueue a literal assignment at the current decision level.
- * `reason` is the clause index that implied this assignment, or -1 for decisions. */
-static void enqueue(CDCLSolver *s, int code, int reason) {
+ * `reason` is the clause that implied this assignment, or CREF_UNDEF for decisions. */
+static void enqueue(CDCLSolver *s, int code, CRef reason) {
     int var = lit_var(code);
-    s->assigns[var] = (code & 1) ? 0 : 1;  /* even code -> TRUE, odd -> FALSE */
-    s->levels[var]  = s->num_decisions;
-    s->reasons[var] = reason;
+    s->values[code]          = 1;
+    s->values[lit_neg(code)] = 0;
+    s->vardata[var].level  = s->num_decisions;
+    s->vardata[var].reason = reason;
     s->trail[s->trail_size++] = code;
 }
 
+/* ========================================================================= */
+/*  Clause addition                                                          */
+/* ========================================================================= */
+
+/*
+ * Attach a clause added between solves.  The solver is at level 0 then and
+ * some literals may already be fixed: the watches go on literals that are
+ * not false, a clause with only one of those is enqueued as a unit, and one
+ * with none makes the formula UNSAT.
+ */
+static void attach_late_clause(CDCLSolver *s, CRef cr) {
+    Clause *c = cdcl_clause(s, cr);
+    int k = 0;  /* literals not false, moved to the front */
+    bool satisfied = false;
+    for (int i = 0; i < (int)c->size; i++) {
+        int val = lit_value(s, c->lits[i]);
+        if (val == 1) satisfied = true;
+        if (val != 0) {
+            int tmp = c->lits[k];
+            c->lits[k++] = c->lits[i];
+            c->lits[i] = tmp;
+        }
+    }
+    attach_clause(s, cr);
+    if (satisfied) return;
+    if (k == 0) {
+        s->unsat = true;
+        if (s->proof) proof_add(s->proof, NULL, 0);
+    } else if (k == 1) enqueue(s, c->lits[0], cr);
+}
+
+/* Remove clause `cr` from the watch list of literal `lit`. */
+static void watch_remove(CDCLSolver *s, int lit, CRef cr) {
+    Watcher *ws = s->watches[lit];
+    int n = s->watch_size[lit];
+    for (int i = 0; i < n; i++) {
+        if (ws[i].cref == cr) {
+            ws[i] = ws[n - 1];
+            s->watch_size[lit] = n - 1;
+            return;
+        }
+    }
+}
+
+/* Set or clear BIN_RESIDENT on the entry of binary clause `cr` in the
+ * implication list of `lit`. */
+static void bin_mark(CDCLSolver *s, int lit, CRef cr, bool resident) {
+    Watcher *ws = s->bin_watches[lit];
+    for (int i = 0; i < s->bin_size[lit]; i++) {
+        if ((ws[i].cref & ~BIN_RESIDENT) == cr) {
+            ws[i].cref = resident ? cr | BIN_RESIDENT : cr;
+            return;
+        }
+    }
+}
+
+void cdcl_set_resident(CDCLSolver *s, CRef cr, bool resident) {
+    Clause *c = cdcl_clause(s, cr);
+    c->hw = resident;
+    if (c->size == 2) {
+        bin_mark(s, c->lits[0], cr, resident);
+        bin_mark(s, c->lits[1], cr, resident);
+    }
+}
+
+/*
+ * Hand a clause back to software BCP when the accelerator evicts it.  While
+ * it was resident propagate() left its watches alone, so they may have
+ * become false since: two literals that are not false are moved into the
+ * watch positions.  A clause with fewer than two is unit or conflicting at
+ * a level below the current one, which software would not notice; it is
+ * left as it is and false is returned, so that it stays resident.
+ */
+bool cdcl_rewatch(CDCLSolver *s, CRef cr) {
+    Clause *c = cdcl_clause(s, cr);
+    int w[2], n = 0;
+    for (int k = 0; k < (int)c->size && n < 2; k++)
+        if (lit_value(s, c->lits[k]) != 0) w[n++] = k;
+    if (n < 2) return false;
+
+    /* Binary clauses are in the implication lists of both literals. */
+    if (c->size == 2 || (w[0] == 0 && w[1] == 1)) return true;
+
+    watch_remove(s, c->lits[0], cr);
+    watch_remove(s, c->lits[1], cr);
+    for (int i = 0; i < 2; i++) {
+        int tmp = c->lits[i];
+        c->lits[i] = c->lits[w[i]];
+        c->lits[w[i]] = tmp;
+    }
+    watch_add(s, c->lits[0], cr, c->lits[1]);
+    watch_add(s, c->lits[1], cr, c->lits[0]);
+    return true;
+}
+
+/* Make room for `n` more entries in the clause list. */
+static void clause_list_reserve(CDCLSolver *s, int n) {
+    if (s->clause_cap - s->clause_count >= n) return;
+    int cap = s->clause_cap * 2;
+    if (cap < s->clause_count + n) cap = s->clause_count + n;
+    s->clauses = (CRef *)realloc(s->clauses, cap * sizeof(CRef));
+    s->clause_cap = cap;
+}
+
+/* Append a clause reference to the clause list, growing it if necessary. */
+static void clause_list_push(CDCLSolver *s, CRef cr) {
+    clause_list_reserve(s, 1);
+    s->clauses[s->clause_count++] = cr;
+}
+
+/*
+ * Add a clause given as an array of signed literals (1-based, negated = negative).
+ * Returns the clause reference, or -1 if the clause is a tautology / empty.
+ */
+/* True (with a message) if a clause of signed literals uses a variable that
+ * cdcl_preprocess() eliminated: its clauses are gone, so it cannot take
+ * new ones. */
+static bool uses_eliminated(CDCLSolver *s, const int *signed_lits, int len) {
+    if (s->num_eliminated == 0) return false;
+    for (int i = 0; i < len; i++) {
+        int var = abs(signed_lits[i]);
+        if (var <= s->num_vars && s->eliminated[var]) {
+            fprintf(stderr, "cdcl: clause uses eliminated variable %d\n", var);
+            return true;
+        }
+    }
+    return false;
+}
+
+int cdcl_add_clause(CDCLSolver *s, int *signed_lits, int len) {
+    if (uses_eliminated(s, signed_lits, len)) return -1;
+
+    /* Allocate and populate clause in the arena. */
+    CRef cr = clause_alloc(s, len, false);
+    Clause *c = cdcl_clause(s, cr);
+    for (int i = 0; i < len; i++) {
+        c->lits[i] = lit_to_code(signed_lits[i]);
+    }
+
+    clause_list_push(s, cr);
+    if (s->trail_size > 0) attach_late_clause(s, cr);
+    else attach_clause(s, cr);
+
+    return (int)cr;
+}
+
+void cdcl_reserve(CDCLSolver *s, int num_clauses, int64_t total_lits) {
+    if (num_clauses < 0 || total_lits < 0) return;
+    clause_list_reserve(s, num_clauses);
+    arena_reserve(s, (uint64_t)num_clauses * CLAUSE_HEADER_WORDS + (uint64_t)total_lits);
+}
+
+/*
+ * Attach clauses s->clauses[first..clause_count) in two passes: count the
+ * new watchers per literal, grow every watch / implication list once to its
+ * final size, then fill them.  Equivalent to attach_clause() on each clause,
+ * without the repeated per-list reallocation.
+ */
+static void attach_clauses_bulk(CDCLSolver *s, int first) {
+    int lits = 2 * s->num_vars + 2;
+    int *wcount = (int *)calloc(2 * (size_t)lits, sizeof(int));
+    int *bcount = wcount + lits;
+
+    for (int i = first; i < s->clause_count; i++) {
+        Clause *c = cdcl_clause(s, s->clauses[i]);
+        if (c->size == 2) {
+            bcount[c->lits[0]]++;
+            bcount[c->lits[1]]++;
+        } else if (c->size > 2) {
+            wcount[c->lits[0]]++;
+            wcount[c->lits[1]]++;
+        }
+    }
+
+    for (int lit = 0; lit < lits; lit++) {
+        int need = s->watch_size[lit] + wcount[lit];
+        if (need > s->watch_cap[lit]) {
+            s->watches[lit] = (Watcher *)realloc(s->watches[lit], need * sizeof(Watcher));
+            s->watch_cap[lit] = need;
+        }
+        need = s->bin_size[lit] + bcount[lit];
+        if (need > s->bin_cap[lit]) {
+            s->bin_watches[lit] = (Watcher *)realloc(s->bin_watches[lit], need * sizeof(Watcher));
+            s->bin_cap[lit] = need;
+        }
+    }
+    free(wcount);
+
+    /* Every list now has room, so attaching never reallocates. */
+    for (int i = first; i < s->clause_count; i++)
+        attach_clause(s, s->clauses[i]);
+}
+
+int cdcl_add_clauses(CDCLSolver *s, const int *signed_lits, int64_t num_lits) {
+    /* Pass 1: size the batch so the arena and clause list grow at most once. */
+    int n = 0;
+    for (int64_t i = 0; i < num_lits; i++)
+        if (signed_lits[i] == 0) n++;
+    cdcl_reserve(s, n, num_lits - n);
+
+    /* Pass 2: copy the clauses into the arena, then attach them together. */
+    int first = s->clause_count;
+    int64_t start = 0;
+    for (int64_t i = 0; i < num_lits; i++) {
+        if (signed_lits[i] != 0) continue;
+        int len = (int)(i - start);
+        if (uses_eliminated(s, signed_lits + start, len)) {
+            n--;
+            start = i + 1;
+            continue;
+        }
+        CRef cr = clause_alloc(s, len, false);
+        Clause *c = cdcl_clause(s, cr);
+        for (int k = 0; k < len; k++)
+            c->lits[k] = lit_to_code(signed_lits[start + k]);
+        s->clauses[s->clause_count++] = cr;
+        start = i + 1;
+    }
+    if (s->trail_size > 0) {
+        for (int i = first; i < s->clause_count; i++) attach_late_clause(s, s->clauses[i]);
+    } else {
+        attach_clauses_bulk(s, first);
+    }
+    return n;
+}
+
+/* Original clauses shared by clones, laid out like CDCLSolver.arena. */
+struct ClauseBase {
+    uint32_t *arena;
+    uint32_t  size;         /* words in use                             */
+    int       num_long;     /* clauses of more than two literals        */
+};
+
+ClauseBase *cdcl_base_create(const CDCLSolver *s) {
+    uint64_t words = 0;
+    for (int i = 0; i < s->clause_count; i++) {
+        const Clause *c = cdcl_clause(s, s->clauses[i]);
+        if (!c->learnt && !c->deleted) words += clause_words(c->size);
+    }
+    if (words >= CREF_BASE) return NULL;
+
+    ClauseBase *b = (ClauseBase *)calloc(1, sizeof(ClauseBase));
+    b->arena = (uint32_t *)malloc((words ? words : 1) * sizeof(uint32_t));
+    for (int i = 0; i < s->clause_count; i++) {
+        const Clause *from = cdcl_clause(s, s->clauses[i]);
+        if (from->learnt || from->deleted) continue;
+        Clause *to = (Clause *)(b->arena + b->size);
+        memcpy(to, from, clause_words(from->size) * sizeof(uint32_t));
+        to->hw  = 0;
+        to->lbd = from->size > 2 ? (uint32_t)b->num_long++ : 0;
+        b->size += clause_words(from->size);
+    }
+    return b;
+}
+
+void cdcl_base_destroy(ClauseBase *b) {
+    if (!b) return;
+    free(b->arena);
+    free(b);
+}
+
+CDCLSolver *cdcl_clone(const CDCLSolver *s, const ClauseBase *base) {
+    CDCLSolver *c = cdcl_create(s->num_vars);
+    c->restart_policy = s->restart_policy;
+    c->polarity       = s->polarity;
+    c->rand_state     = s->rand_state;
+
+    /* Reference the base's clauses, then copy the rest (all of them
+     * without a base) and attach everything in one pass. */
+    uint32_t own = s->arena_size - s->arena_wasted;
+    if (base) {
+        c->base_arena = base->arena;
+        c->base_watch = (int *)malloc((2 * (size_t)base->num_long + 1) * sizeof(int));
+        for (uint32_t off = 0; off < base->size;
+             off += clause_words(((const Clause *)(base->arena + off))->size))
+            clause_list_push(c, CREF_BASE | off);
+        own -= base->size;
+    }
+    cdcl_reserve(c, s->clause_count - c->clause_count, own);
+    for (int i = 0; i < s->clause_count; i++) {
+        const Clause *from = cdcl_clause(s, s->clauses[i]);
+        if (from->deleted || (base && !from->learnt)) continue;
+        CRef cr = clause_alloc(c, (int)from->size, from->learnt);
+        Clause *to = cdcl_clause(c, cr);
+        memcpy(to->lits, from->lits, from->size * sizeof(int));
+        to->lbd      = from->lbd;
+        to->activity = from->activity;
+        c->clauses[c->clause_count++] = cr;
+        if (from->learnt) c->num_learnts++;
+    }
+    attach_clauses_bulk(c, 0);
+
+    /* Facts learnt by earlier solves. */
+    for (int t = 0; t < s->trail_size; t++)
+        if (s->vardata[lit_var(s->trail[t])].level == 0) enqueue(c, s->trail[t], CREF_UNDEF);
+    c->unsat = s->unsat;
+
+    /* Variable elimination, so that the copy extends its models too. */
+    memcpy(c->frozen, s->frozen, (s->num_vars + 1) * sizeof(char));
+    memcpy(c->eliminated, s->eliminated, (s->num_vars + 1) * sizeof(char));
+    c->num_eliminated = s->num_eliminated;
+    if (s->elim_size > 0) {
+        c->elim_stack = (int *)malloc(s->elim_size * sizeof(int));
+        memcpy(c->elim_stack, s->elim_stack, s->elim_size * sizeof(int));
+        c->elim_size = c->elim_cap = s->elim_size;
+    }
+    return c;
+}
+
 /* ========================================================================= */
 /*  Boolean Constraint Propagation (BCP)                                     */
 /* ========================================================================= */
 
 /*
  * Perform unit propagation using two-watched-literal scheme.
- * Returns -1 if no conflict, otherwise returns the index of a conflicting clause.
+ * Returns CREF_UNDEF if no conflict, otherwise the conflicting clause.
  */
-static int propagate(CDCLSolver *s) {
+static CRef propagate(CDCLSolver *s) {
     /* Process from the current propagation pointer to the end of the trail. */
     while (s->prop_head < s->trail_size) 
     {
         /* The literal that just became true; we need to look at watchers of
          * its negation (those clauses might now be unit or conflicting). */
         int false_lit = lit_neg(s->trail[s->prop_head++]);
+        s->stats.propagations++;
+
+        /* Binary clauses first: the other literal is stored in the entry,
+         * so no clause memory is touched and the reason is kept inline.
+         * Clauses resident on an accelerator are skipped by their flag. */
+        Watcher *blist = s->bin_watches[false_lit];
+        int      blen  = s->bin_size[false_lit];
+        for (int i = 0; i < blen; i++) {
+            int other = blist[i].blocker;
+            int val   = lit_value(s, other);
+            if (val == 1 || (blist[i].cref & BIN_RESIDENT)) continue;
+            if (val == 0) return blist[i].cref; /* CONFLICT */
+            enqueue(s, other, REASON_BINARY | (CRef)false_lit);
+        }
 
         /* ============== HARDWARE CALLED HERE ==============*/
-        int *wlist = s->watches[false_lit];
+        Watcher *wlist = s->watches[false_lit];
         int  wlen  = s->watch_size[false_lit];
         // Optimization: Defer Watch List Update to after processing all clauses (Removes Loop Dependency). Source: FYalSAT (Choi & Kim, 2024) — Section III-B, deferred break score aggregation as a general technique for decoupling dependent writes from parallel reads.
         int  j = 0; /* write pointer for compacting the watch list */
@@ -211,22 +1003,42 @@ static int propagate(CDCLSolver *s) {
         // Optimization: Conflict-Free Partitioning of Watch Lists to avoid bank access conflicts. Source: FYalSAT (Choi & Kim, 2024) — Section III-A, modulo-P conflict-free occurrence list rearrangement.
         for (int i = 0; i < wlen; i++) {
             // Pipeline 1 and 2 by prefetching the next clause index while the current clause is being processed. Source: FYalSAT (Choi & Kim, 2024) — Section III-C, unsatisfied clause prefetching to overlap DRAM access with computation.
-            int ci = wlist[i]; // 1
-            Clause *c = s->clauses[ci]; //2 
+            /* Blocker already true — clause satisfied, skip the clause load. */
+            if (lit_value(s, wlist[i].blocker) == 1) {
+                wlist[j++] = wlist[i];
+                continue;
+            }
+
+            CRef cr = wlist[i].cref; // 1
+            Clause *c = cdcl_clause(s, cr); //2 
+
+            /* Resident clauses are propagated by the accelerator.  Keep the
+             * watcher: an evicted learnt clause comes back to software. */
+            if (c->hw) {
+                wlist[j++] = wlist[i];
+                continue;
+            }
+
+            /* The watched pair: the first two literals, or this solver's
+             * copy of them for a clause of a shared ClauseBase. */
+            int *w = (cr & CREF_BASE) ? s->base_watch + 2 * (size_t)c->lbd : c->lits;
 
             /* Make sure the false literal is in position 1. Always check first literal and swap the two literals.
             (Simplifies logic so we never need to iterate over the clause) */
             // Optimization: Remove Swap and utilize hardware multiplexer to select the other watched literal: Source: SAT-Accel (Lo et al., 2025) — Section V, signature-based clause representation eliminates positional literal dependency entirely, removing the need for this normalization.
-            if (c->lits[0] == false_lit) {
-                int tmp = c->lits[0];
-                c->lits[0] = c->lits[1];
-                c->lits[1] = tmp;
+            if (w[0] == false_lit) {
+                w[0] = w[1];
+                w[1] = false_lit;
             }
 
             /* If the other watched literal is already true, clause is satisfied. */
             // Optimization: Remove in favor of a satisfaction bit we store with the clause in memory to avoid checking literal value. Source: FYalSAT (Choi & Kim, 2024) — Section IV-B, Partial SAT Evaluator module (Stage C) using precomputed satisfaction status per clause.
-            if (lit_value(s, c->lits[0]) == 1) {
-                wlist[j++] = ci; /* keep watching */
+            /* The other watch becomes the new blocker either way. */
+            int first = w[0];
+            if (first != wlist[i].blocker && lit_value(s, first) == 1) {
+                wlist[j].cref    = cr; /* keep watching */
+                wlist[j].blocker = first;
+                j++;
                 continue;
             }
 
@@ -234,44 +1046,116 @@ static int propagate(CDCLSolver *s) {
             // Optimization Option 1: Compute each in parallel (Unroll Loop Fully). Source: FYalSAT (Choi & Kim, 2024) — Section IV-B3, Sub Clause Evaluator units evaluating all literals in a clause simultaneously.
             // Optimization Option 2: Use state-based approach (ucnt + XOR signature) eliminates this search entirely. Source: SAT-Accel (Lo et al., 2025) — Section V-A, signature-based clause representation with ucnt and XOR of unassigned variable indices.
             bool found = false;
-            for (int k = 2; k < c->size; k++) {
-                if (lit_value(s, c->lits[k]) != 0) { /* not false */
-                    /* Swap lits[1] and lits[k]. */
-                    int tmp = c->lits[1];
-                    c->lits[1] = c->lits[k];
-                    c->lits[k] = tmp;
-                    watch_add(s, c->lits[1], ci);
-                    found = true;
-                    break;
+            if (w == c->lits) {
+                for (int k = 2; k < c->size; k++) {
+                    if (lit_value(s, c->lits[k]) != 0) { /* not false */
+                        /* Swap lits[1] and lits[k]. */
+                        int tmp = c->lits[1];
+                        c->lits[1] = c->lits[k];
+                        c->lits[k] = tmp;
+                        watch_add(s, c->lits[1], cr, first);
+                        found = true;
+                        break;
+                    }
+                }
+            } else {
+                /* The base is read-only: scan all of it, skipping the watches
+                 * (false_lit is false, so only `first` needs a test). */
+                for (int k = 0; k < c->size; k++) {
+                    int lit = c->lits[k];
+                    if (lit != first && lit_value(s, lit) != 0) {
+                        w[1] = lit;
+                        watch_add(s, lit, cr, first);
+                        found = true;
+                        break;
+                    }
                 }
             }
             if (found) continue; /* don't keep in this watch list */
 
             /* No replacement found — clause is either unit or conflicting. */
             // Optimization: Defer Watch List Update to after processing all clauses (Removes Loop Dependency). Source: FYalSAT (Choi & Kim, 2024) — Section III-B, deferred break score aggregation as a general technique for decoupling dependent writes from parallel reads.
-            wlist[j++] = ci;
+            wlist[j].cref    = cr;
+            wlist[j].blocker = first;
+            j++;
 
-            if (lit_value(s, c->lits[0]) == 0) {
+            if (lit_value(s, first) == 0) {
                 /* CONFLICT: all literals are false. */
                 /* Copy remaining watches and update size. */
                 // Optimization: priority-encoded reduction — all clauses evaluate simultaneously, and a conflict anywhere triggers a single combined result without sequential drain. Source: SAT-Accel (Lo et al., 2025) — Section IV-B, conflict detection unit operating across all parallel processing elements with priority encoding.  
+                s->stats.watch_visits += i + 1;
                 while (i + 1 < wlen) {
                     wlist[j++] = wlist[++i];
                 }
                 // Optimization: Defer Watch List Update to after processing all clauses (Removes Loop Dependency). Source: FYalSAT (Choi & Kim, 2024) — Section III-B, deferred break score aggregation as a general technique for decoupling dependent writes from parallel reads.
                 s->watch_size[false_lit] = j;
-                return ci;
+                return cr;
             }
 
             /* Unit clause: lits[0] is the only unassigned literal. */
             // Optimization: Implement as FIFO in hardware to pipeline with (Prefetch, Evaluation, Enqueue). Source: SAT-Accel (Lo et al., 2025) — Section IV-B, pipelined BCP with overlapped implication propagation and clause evaluation.
-            enqueue(s, c->lits[0], ci);
+            enqueue(s, first, cr);
         }
 
         s->watch_size[false_lit] = j;
+        s->stats.watch_visits += wlen;
         /* ============== HARDWARE CALLED HERE ==============*/
     }
-    return -1; /* no conflict */
+    return CREF_UNDEF; /* no conflict */
+}
+
+/*
+ * BCP through the selected backend.  Without an accelerator this is just
+ * propagate().  Otherwise the clauses that fit the accelerator (see
+ * hw_clausedb.h) are propagated there, the rest by propagate(), which
+ * skips resident clauses.
+ * Both read the same trail with their own queue head, so implications from
+ * either side are picked up by the other until both heads reach the end.
+ * Software implications are written to the accelerator before its next
+ * round so that it evaluates clauses against the full assignment.
+ */
+static CRef backend_propagate(CDCLSolver *s) {
+    const BCPBackend *b = s->backend;
+    if (!b->propagate) {
+        PROF_START(t0);
+        CRef conflict = propagate(s);
+        PROF_STOP(s, PHASE_PROPAGATE, t0);
+        return conflict;
+    }
+
+    while (s->prop_head < s->trail_size || s->hw_head < s->trail_size) {
+        int sw_from = s->trail_size;
+        PROF_START(t0);
+        CRef conflict = propagate(s);
+        PROF_STOP(s, PHASE_PROPAGATE, t0);
+        if (conflict != CREF_UNDEF) return conflict;
+
+        PROF_START(t1);
+        int64_t scans = bcp_hw_scans;
+        for (int t = sw_from; t < s->trail_size; t++) {
+            int var = lit_var(s->trail[t]);
+            b->assign(var, cdcl_var_value(s, var), false);
+        }
+        conflict = b->propagate(s);
+        s->stats.hw_calls++;
+        s->stats.hw_scans += bcp_hw_scans - scans;
+        PROF_STOP(s, PHASE_BACKEND, t1);
+        if (conflict != CREF_UNDEF) return conflict;
+    }
+    return CREF_UNDEF;
+}
+
+/* Software-only BCP: the solver needs no hooks. */
+int64_t bcp_hw_scans = 0;
+
+const BCPBackend bcp_backend_sw = {
+    .name = "sw",
+    .desc = "software BCP (two watched literals)",
+};
+
+void cdcl_set_backend(CDCLSolver *s, const BCPBackend *backend, const char *port) {
+    s->backend      = backend ? backend : &bcp_backend_sw;
+    s->backend_port = port;
 }
 
 /* ========================================================================= */
@@ -283,12 +1167,17 @@ static int propagate(CDCLSolver *s) {
 /* Bump the activity score of a variable (called during conflict analysis). */
 static void var_bump_activity(CDCLSolver *s, int var) {
     s->activity[var] += s->var_inc;
-    /* Rescale if activity gets too large to prevent overflow. */
+    /* Rescale if activity gets too large to prevent overflow.
+     * Scaling every key by the same factor preserves their order, so the
+     * decision heap stays valid without being rebuilt. */
     if (s->activity[var] > 1e100) {
         for (int i = 1; i <= s->num_vars; i++)
             s->activity[i] *= 1e-100;
         s->var_inc *= 1e-100;
     }
+    /* Activity only grows, so the variable can only move towards the root. */
+    if (heap_contains(s, var))
+        heap_percolate_up(s, s->heap_index[var]);
 }
 
 /* Decay all activities (called once per conflict). */
@@ -296,92 +1185,201 @@ static void var_decay_activity(CDCLSolver *s) {
     s->var_inc /= VSIDS_DECAY;
 }
 
+#define CLAUSE_DECAY 0.999
+
+/* Bump the activity of a learned clause that took part in a conflict.
+ * Used to break ties between clauses of equal LBD in reduce_db(). */
+static void cla_bump_activity(CDCLSolver *s, Clause *c) {
+    c->activity += (float)s->cla_inc;
+    if (c->activity > 1e20f) {
+        for (int i = 0; i < s->clause_count; i++) {
+            Clause *lc = cdcl_clause(s, s->clauses[i]);
+            if (lc->learnt) lc->activity *= 1e-20f;
+        }
+        s->cla_inc *= 1e-20;
+    }
+}
+
+static void cla_decay_activity(CDCLSolver *s) {
+    s->cla_inc /= CLAUSE_DECAY;
+}
+
 /* ========================================================================= */
 /*  Conflict analysis — First-UIP scheme                                     */
 /* ========================================================================= */
 
 /*
- * Analyze a conflict clause and produce a learned clause.
- * Sets `out_bt_level` to the backtrack level.
- * Returns the number of literals in the learned clause stored in `learnt_buf`.
+ * Literals of the reason for `var`, other than `var` itself, are the ones
+ * resolved against.  Binary reasons are stored inline, so `tmp` provides
+ * storage for their single other literal.  Sets `*size` to the literal count
+ * (the returned array may still contain `var`'s own literal; callers skip it).
+ */
+static inline const int *reason_lits(CDCLSolver *s, CRef reason,
+                                     int *tmp, int *size) {
+    if (reason & REASON_BINARY) {
+        *tmp  = (int)(reason & ~REASON_BINARY);
+        *size = 1;
+        return tmp;
+    }
+    Clause *rc = cdcl_clause(s, reason);
+    *size = rc->size;
+    return rc->lits;
+}
+
+/* One bit per decision level (mod 32): a cheap over-approximation of the
+ * set of levels in a clause, used to prune the redundancy search. */
+static inline uint32_t abstract_level(CDCLSolver *s, int var) {
+    return 1u << (s->vardata[var].level & 31);
+}
+
+/*
+ * MiniSat-style recursive minimization: is literal `p` of the learned clause
+ * implied by the other literals?  It is if every path back through the
+ * implication graph ends in a literal already in the clause (seen) or at
+ * level 0.  A literal whose level is not among `abstract_levels` cannot be
+ * resolved away, so the search gives up on it immediately.  Variables
+ * proven redundant stay marked seen (and are appended to analyze_toclear)
+ * so later queries reuse the result.
+ */
+static bool lit_redundant(CDCLSolver *s, int p, uint32_t abstract_levels) {
+    int stack_size = 0;
+    int top = s->toclear_size;
+    s->analyze_stack[stack_size++] = p;
+
+    while (stack_size > 0) {
+        int q = s->analyze_stack[--stack_size];
+        int qvar = lit_var(q);
+        int tmp, rsize;
+        const int *rlits = reason_lits(s, s->vardata[qvar].reason, &tmp, &rsize);
+
+        for (int i = 0; i < rsize; i++) {
+            int l = rlits[i];
+            int v = lit_var(l);
+            const VarData *vd = &s->vardata[v];
+            if (v == qvar || s->seen[v] || vd->level == 0) continue;
+
+            if (vd->reason != CREF_UNDEF &&
+                (abstract_level(s, v) & abstract_levels)) {
+                s->seen[v] = 1;
+                s->analyze_stack[stack_size++] = l;
+                s->analyze_toclear[s->toclear_size++] = l;
+            } else {
+                /* Reached a decision or a level outside the clause: undo
+                 * the marks made by this query. */
+                for (int j = top; j < s->toclear_size; j++)
+                    s->seen[lit_var(s->analyze_toclear[j])] = 0;
+                s->toclear_size = top;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/*
+ * Analyze a conflict clause and produce a learned clause in s->learnt.
+ * Sets `out_bt_level` to the backtrack level and `out_lbd` to the learned
+ * clause's literal block distance (number of distinct decision levels).
+ * Returns the number of literals in the learned clause.  The asserting
+ * literal is s->learnt[0] and the highest-level other literal s->learnt[1].
+ *
+ * All scratch state (seen[], the minimization stack and the toclear list)
+ * lives in the solver and is reset incrementally, so a conflict costs time
+ * proportional to the literals it touches, not to num_vars.
  */
-static int analyze(CDCLSolver *s, int conflict_ci,
-                   int *learnt_buf, int *out_bt_level) {
+static int analyze(CDCLSolver *s, CRef conflict,
+                   int *out_bt_level, int *out_lbd) {
     int current_level = s->num_decisions;
+    int *learnt_buf = s->learnt;
     // Logs variables we have already processed in the current analysis.
-    bool *seen = (bool *)calloc(s->num_vars + 1, sizeof(bool));
+    char *seen = s->seen;
 
-    // Size of learned clause.
-    int learnt_count = 0;
+    // Size of learned clause. Slot 0 is reserved for the UIP literal.
+    int learnt_count = 1;
     int counter = 0; /* number of literals at current decision level still to resolve */
 
-    /* Start with the conflict clause. (Fetches clause with only false literals) */
-    Clause *c = s->clauses[conflict_ci];
-    for (int i = 0; i < c->size; i++) {
-        int var = lit_var(c->lits[i]);
-        if (!seen[var]) {
-            seen[var] = true;
+    /* Start with the conflict clause, then resolve with reasons walking the
+     * trail backwards until only one literal of the current level remains:
+     * the first UIP. */
+    int trail_idx = s->trail_size - 1;
+    int uip_lit = 0;
+    int pivot = 0;  /* variable just resolved away (0 = none yet) */
+    int tmp, rsize;
+    const int *rlits;
+    Clause *c = cdcl_clause(s, conflict);
+    if (c->learnt) cla_bump_activity(s, c);
+    rlits = c->lits;
+    rsize = c->size;
+
+    // Iterate until resolution: One literal.
+    while (true) {
+        for (int i = 0; i < rsize; i++) {
+            int rvar = lit_var(rlits[i]);
+            int rlevel = s->vardata[rvar].level;
+            /* Skip the pivot itself and anything fixed at level 0. */
+            if (rvar == pivot || seen[rvar] || rlevel == 0) continue;
+            seen[rvar] = 1;
             // Variable activity bumps as it is involved in more conflicts (VSIDS).
-            var_bump_activity(s, var);
-            if (s->levels[var] == current_level) {
+            var_bump_activity(s, rvar);
+            if (rlevel == current_level) {
                 // If the variable occurred at the current decision level, it is part of the reason for the conflict. We add to the count of needed resolutions and do not add to the learned clause.
                 counter++;
-            } else if (s->levels[var] > 0) {
-                learnt_buf[learnt_count++] = c->lits[i];
+            } else {
+                learnt_buf[learnt_count++] = rlits[i];
             }
         }
-    }
-
-    /* Walk the trail backwards, resolving until we reach the first UIP. */
-    int trail_idx = s->trail_size - 1;
-    int uip_lit = 0;
 
-    // Iterate until resolution: One literal.
-    while (counter > 0) {
         /* Find the next literal on the trail that was seen. */
         while (!seen[lit_var(s->trail[trail_idx])]) trail_idx--;
         int p = s->trail[trail_idx--];
-        // First unseen variable we encounter.
-        int var = lit_var(p);
-        seen[var] = false;
+        pivot = lit_var(p);
+        seen[pivot] = 0;
         counter--;
 
         if (counter == 0) {
             /* This is the first UIP — negate it for the learned clause. */
             uip_lit = lit_neg(p);
-        } else {
-            /* Resolve with the reason clause. Same as conflict loop earlier at line 311. */
-            int reason_ci = s->reasons[var];
-            assert(reason_ci >= 0);
-            Clause *rc = s->clauses[reason_ci];
-            for (int i = 0; i < rc->size; i++) {
-                int rvar = lit_var(rc->lits[i]);
-                if (!seen[rvar]) {
-                    seen[rvar] = true;
-                    var_bump_activity(s, rvar);
-                    if (s->levels[rvar] == current_level) {
-                        counter++;
-                    } else if (s->levels[rvar] > 0) {
-                        learnt_buf[learnt_count++] = rc->lits[i];
-                    }
-                }
-            }
+            break;
         }
-    }
 
-    /* The UIP literal goes first in the learned clause. */
-    /* Shift existing learnt literals right to make room at index 0. */
-    for (int i = learnt_count; i > 0; i--)
-        learnt_buf[i] = learnt_buf[i - 1];
+        CRef reason = s->vardata[pivot].reason;
+        assert(reason != CREF_UNDEF);
+        /* Only clauses resolved here count as used, not the ones the
+         * minimization or analyze_final() merely visit. */
+        if (!(reason & REASON_BINARY)) {
+            Clause *rc = cdcl_clause(s, reason);
+            if (rc->learnt) cla_bump_activity(s, rc);
+        }
+        rlits = reason_lits(s, reason, &tmp, &rsize);
+    }
     learnt_buf[0] = uip_lit;
-    learnt_count++;
+
+    /* Recursive minimization.  Every literal still marked seen is in the
+     * clause; toclear starts as that set and grows with the redundant
+     * variables found, so seen[] can be cleared precisely at the end. */
+    s->toclear_size = 0;
+    uint32_t abstract_levels = 0;
+    for (int i = 1; i < learnt_count; i++) {
+        s->analyze_toclear[s->toclear_size++] = learnt_buf[i];
+        abstract_levels |= abstract_level(s, lit_var(learnt_buf[i]));
+    }
+    int j = 1;
+    for (int i = 1; i < learnt_count; i++) {
+        int var = lit_var(learnt_buf[i]);
+        if (s->vardata[var].reason == CREF_UNDEF ||
+            !lit_redundant(s, learnt_buf[i], abstract_levels))
+            learnt_buf[j++] = learnt_buf[i];
+    }
+    learnt_count = j;
+    for (int i = 0; i < s->toclear_size; i++)
+        seen[lit_var(s->analyze_toclear[i])] = 0;
 
     /* Determine the backtrack level: the highest level among the non-UIP
      * literals in the learned clause (or 0 if the clause is unit). */
     int bt_level = 0;
     int max_idx = 1; /* index of literal with the highest level (for watch) */
     for (int i = 1; i < learnt_count; i++) {
-        int lv = s->levels[lit_var(learnt_buf[i])];
+        int lv = s->vardata[lit_var(learnt_buf[i])].level;
         if (lv > bt_level) {
             bt_level = lv;
             max_idx = i;
@@ -389,25 +1387,70 @@ static int analyze(CDCLSolver *s, int conflict_ci,
     }
     /* Swap the highest-level literal into position 1 for watching. */
     if (learnt_count > 1) {
-        int tmp = learnt_buf[1];
+        int t = learnt_buf[1];
         learnt_buf[1] = learnt_buf[max_idx];
-        learnt_buf[max_idx] = tmp;
+        learnt_buf[max_idx] = t;
+    }
+
+    /* LBD: count the distinct decision levels among the literals. */
+    if (++s->lbd_stamp == 0) {
+        memset(s->level_stamp, 0, s->level_cap * sizeof(uint32_t));
+        s->lbd_stamp = 1;
+    }
+    int lbd = 0;
+    for (int i = 0; i < learnt_count; i++) {
+        int lv = s->vardata[lit_var(learnt_buf[i])].level;
+        if (s->level_stamp[lv] != s->lbd_stamp) {
+            s->level_stamp[lv] = s->lbd_stamp;
+            lbd++;
+        }
     }
 
     *out_bt_level = bt_level;
-    free(seen);
+    *out_lbd = lbd;
 
     var_decay_activity(s);
+    cla_decay_activity(s);
 
     return learnt_count;
 }
 
+/*
+ * Assumption `p` is false: collect in s->core the assumptions that imply ~p,
+ * together with p itself (MiniSat's analyzeFinal).  Called while deciding
+ * assumptions, so every decision on the trail is one of them.
+ */
+static void analyze_final(CDCLSolver *s, int p) {
+    s->core_size = 0;
+    s->core[s->core_size++] = code_to_lit(p);
+    if (s->vardata[lit_var(p)].level == 0) return;
+
+    s->seen[lit_var(p)] = 1;
+    for (int i = s->trail_size - 1; i >= s->trail_delimiters[0]; i--) {
+        int var = lit_var(s->trail[i]);
+        if (!s->seen[var]) continue;
+        if (s->vardata[var].reason == CREF_UNDEF) {
+            s->core[s->core_size++] = code_to_lit(s->trail[i]);
+        } else {
+            int tmp, rsize;
+            const int *rlits = reason_lits(s, s->vardata[var].reason, &tmp, &rsize);
+            for (int k = 0; k < rsize; k++) {
+                int v = lit_var(rlits[k]);
+                if (v != var && s->vardata[v].level > 0) s->seen[v] = 1;
+            }
+        }
+        s->seen[var] = 0;
+    }
+    s->seen[lit_var(p)] = 0;
+}
+
 /* ========================================================================= */
 /*  Backtracking                                                             */
 /* ========================================================================= */
 
 /* Undo all assignments above the given decision level. */
 static void backtrack(CDCLSolver *s, int level) {
+    s->trail_popped = s->trail_size;
     while (s->trail_size > 0) {
         /* If we've unwound past the target level, stop. */
         if (s->num_decisions <= level) break;
@@ -421,8 +1464,11 @@ static void backtrack(CDCLSolver *s, int level) {
 
         int code = s->trail[--s->trail_size];
         int var = lit_var(code);
-        s->assigns[var] = UNASSIGNED;
-        s->reasons[var] = -1;
+        s->phase[var] = cdcl_var_value(s, var);  /* phase saving */
+        s->values[code]          = UNASSIGNED;
+        s->values[lit_neg(code)] = UNASSIGNED;
+        s->vardata[var].reason   = CREF_UNDEF;
+        heap_insert(s, var);  /* eligible for decisions again */
     }
     /* Also pop any remaining decision-level markers. */
     while (s->num_decisions > level) {
@@ -430,6 +1476,7 @@ static void backtrack(CDCLSolver *s, int level) {
     }
     /* Reset the propagation pointer so BCP re-processes from the new trail end. */
     s->prop_head = s->trail_size;
+    s->hw_head   = s->trail_size;
 }
 
 /* ========================================================================= */
@@ -437,138 +1484,1143 @@ static void backtrack(CDCLSolver *s, int level) {
 /* ========================================================================= */
 
 /* Pick the unassigned variable with the highest activity score.
- * Returns 0 if all variables are assigned (SAT). */
+ * Pops the decision heap, discarding variables that were assigned since they
+ * were queued and eliminated ones, which are never assigned.  Returns 0 if
+ * all variables are assigned (SAT). */
 static int pick_decision_var(CDCLSolver *s) {
-    int best_var = 0;
-    double best_act = -1.0;
-    for (int v = 1; v <= s->num_vars; v++) {
-        if (s->assigns[v] == UNASSIGNED && s->activity[v] > best_act) {
-            best_act = s->activity[v];
-            best_var = v;
+    while (s->heap_size > 0) {
+        int v = heap_remove_max(s);
+        if (cdcl_var_value(s, v) == UNASSIGNED && !s->eliminated[v]) return v;
+    }
+    return 0;
+}
+
+/* ========================================================================= */
+/*  Decision polarity                                                        */
+/* ========================================================================= */
+
+void cdcl_set_polarity(CDCLSolver *s, PolarityMode mode) {
+    s->polarity = mode;
+}
+
+void cdcl_set_seed(CDCLSolver *s, uint64_t seed) {
+    s->rand_state = seed ? seed : 0x9E3779B97F4A7C15ull; /* xorshift needs nonzero */
+}
+
+/* xorshift64 pseudo-random generator. */
+static inline uint64_t rand_next(CDCLSolver *s) {
+    uint64_t x = s->rand_state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    s->rand_state = x;
+    return x;
+}
+
+/* Choose the value (0/1) to assign to decision variable `var`. */
+static int pick_polarity(CDCLSolver *s, int var) {
+    switch (s->polarity) {
+    case POLARITY_TRUE:   return 1;
+    case POLARITY_FALSE:  return 0;
+    case POLARITY_RANDOM: return (int)(rand_next(s) >> 63);
+    case POLARITY_TARGET: return s->target_phase[var];
+    default:              return s->phase[var];
+    }
+}
+
+/*
+ * Called on each conflict, before backtracking.  The trail below the
+ * conflicting decision level is consistent; if it is the longest seen since
+ * the last restart (target) or rephase (best), record its phases.
+ */
+static void update_target_phase(CDCLSolver *s) {
+    int consistent = s->trail_delimiters[s->num_decisions - 1];
+    if (consistent > s->target_size) {
+        for (int i = 0; i < consistent; i++) {
+            int var = lit_var(s->trail[i]);
+            s->target_phase[var] = cdcl_var_value(s, var);
+        }
+        s->target_size = consistent;
+    }
+    if (consistent > s->best_size) {
+        for (int i = 0; i < consistent; i++) {
+            int var = lit_var(s->trail[i]);
+            s->best_phase[var] = cdcl_var_value(s, var);
         }
+        s->best_size = consistent;
     }
-    return best_var;
+}
+
+/*
+ * Periodically reset the target phases to move the search elsewhere, cycling
+ * through best, original (all FALSE), best, inverted.
+ */
+static void rephase(CDCLSolver *s) {
+    int n = s->num_vars;
+    switch (s->num_rephases % 4) {
+    case 1:
+        memset(s->target_phase + 1, 0, n);
+        break;
+    case 3:
+        for (int v = 1; v <= n; v++) s->target_phase[v] = !s->phase[v];
+        break;
+    default:
+        memcpy(s->target_phase + 1, s->best_phase + 1, n);
+        break;
+    }
+    s->target_size = 0;
+    s->best_size   = 0;
+    s->num_rephases++;
+    s->next_rephase = s->conflicts + (int64_t)REPHASE_INTERVAL * (s->num_rephases + 1);
 }
 
 /* ========================================================================= */
-/*  Add a learned clause to the database                                     */
+/*  Proof logging                                                            */
 /* ========================================================================= */
 
-static int add_learnt_clause(CDCLSolver *s, int *lits, int len) {
-    if (s->clause_count == s->clause_cap) {
-        s->clause_cap *= 2;
-        s->clauses = (Clause **)realloc(s->clauses,
-                                        s->clause_cap * sizeof(Clause *));
+void cdcl_set_proof(CDCLSolver *s, Proof *proof) {
+    s->proof = proof;
+}
+
+/* Copy the literals of clause c to *buf (grown as needed) before they are
+ * rewritten in place, for proof_shrink(). */
+static const int *proof_save(const Clause *c, int **buf, int *cap) {
+    if ((int)c->size > *cap) {
+        *cap = (int)c->size;
+        *buf = (int *)realloc(*buf, *cap * sizeof(int));
     }
-    Clause *c = (Clause *)malloc(sizeof(Clause) + len * sizeof(int));
-    c->size = len;
-    c->learnt = true;
+    memcpy(*buf, c->lits, c->size * sizeof(int));
+    return *buf;
+}
+
+/* Log that clause c, which held old[0..old_size), now holds its current
+ * literals: the new clause goes first, while the checker still has the
+ * old one to derive it from. */
+static void proof_shrink(Proof *p, const Clause *c, const int *old, int old_size) {
+    proof_add(p, c->lits, (int)c->size);
+    proof_delete(p, old, old_size);
+}
+
+/* ========================================================================= */
+/*  Add a learned clause to the database                                     */
+/* ========================================================================= */
+
+static CRef add_learnt_clause(CDCLSolver *s, int *lits, int len, int lbd) {
+    CRef cr = clause_alloc(s, len, true);
+    Clause *c = cdcl_clause(s, cr);
     memcpy(c->lits, lits, len * sizeof(int));
+    c->lbd = (uint32_t)lbd;
+    cla_bump_activity(s, c);
 
-    int ci = s->clause_count;
-    s->clauses[ci] = c;
-    s->clause_count++;
+    clause_list_push(s, cr);
+    attach_clause(s, cr);
+    s->num_learnts++;
+    return cr;
+}
 
-    if (len >= 2) {
-        watch_add(s, c->lits[0], ci);
-        watch_add(s, c->lits[1], ci);
+/* ========================================================================= */
+/*  Learned clause database reduction                                        */
+/* ========================================================================= */
+
+/* Sort key of a reduce_db candidate. */
+typedef struct {
+    CRef     cr;
+    uint32_t lbd;
+    float    activity;
+} LearntRank;
+
+/* Order candidates worst first: higher LBD, then lower activity. */
+static int learnt_rank_cmp(const void *a, const void *b) {
+    const LearntRank *x = (const LearntRank *)a;
+    const LearntRank *y = (const LearntRank *)b;
+    if (x->lbd != y->lbd) return (x->lbd > y->lbd) ? -1 : 1;
+    if (x->activity != y->activity) return (x->activity < y->activity) ? -1 : 1;
+    return 0;
+}
+
+/* A clause is locked while it is the reason for its (true) first literal. */
+static bool clause_locked(CDCLSolver *s, CRef cr, Clause *c) {
+    if (s->backend->propagate) {
+        /* The accelerator does not move the implied literal to lits[0]. */
+        for (int k = 0; k < (int)c->size; k++) {
+            if (s->vardata[lit_var(c->lits[k])].reason == cr && lit_value(s, c->lits[k]) == 1)
+                return true;
+        }
+        return false;
     }
-    return ci;
+    int var = lit_var(c->lits[0]);
+    return s->vardata[var].reason == cr && lit_value(s, c->lits[0]) == 1;
+}
+
+/*
+ * Delete roughly half of the learned clauses, worst LBD first.  Binary and
+ * glue clauses are kept, as are locked reasons.  Deleted clauses are marked,
+ * their arena space is counted as wasted, and they are detached from the
+ * watch lists straight away; check_garbage() reclaims the memory.
+ */
+static void reduce_db(CDCLSolver *s) {
+    LearntRank *cand = (LearntRank *)malloc((s->num_learnts + 1) * sizeof(LearntRank));
+    int n = 0;
+    for (int i = 0; i < s->clause_count; i++) {
+        CRef cr = s->clauses[i];
+        Clause *c = cdcl_clause(s, cr);
+        if (!c->learnt || c->deleted || c->size <= 2) continue;
+        if (c->lbd <= REDUCE_KEEP_LBD) continue;
+        cand[n].cr       = cr;
+        cand[n].lbd      = c->lbd;
+        cand[n].activity = c->activity;
+        n++;
+    }
+    qsort(cand, n, sizeof(LearntRank), learnt_rank_cmp);
+
+    int target = s->num_learnts / 2;
+    int removed = 0;
+    for (int i = 0; i < n && removed < target; i++) {
+        Clause *c = cdcl_clause(s, cand[i].cr);
+        if (clause_locked(s, cand[i].cr, c)) continue;
+        if (s->proof) proof_delete(s->proof, c->lits, (int)c->size);
+        c->deleted = 1;
+        s->arena_wasted += clause_words(c->size);
+        s->num_learnts--;
+        removed++;
+    }
+    free(cand);
+
+    /* Detach deleted clauses from the (long-clause) watch lists. */
+    int lits = 2 * s->num_vars + 2;
+    for (int lit = 0; lit < lits; lit++) {
+        Watcher *ws = s->watches[lit];
+        int j = 0;
+        for (int i = 0; i < s->watch_size[lit]; i++) {
+            if (!cdcl_clause(s, ws[i].cref)->deleted) ws[j++] = ws[i];
+        }
+        s->watch_size[lit] = j;
+    }
+
+    s->num_reduces++;
+    s->next_reduce = s->conflicts + REDUCE_FIRST + (int64_t)REDUCE_INC * s->num_reduces;
 }
 
 /* ========================================================================= */
-/*  Top-level solve loop                                                     */
+/*  Restarts                                                                 */
+/* ========================================================================= */
+
+void cdcl_set_restart(CDCLSolver *s, RestartPolicy policy) {
+    s->restart_policy = policy;
+}
+
+/* Element `x` (0-based) of the Luby sequence 1 1 2 1 1 2 4 1 1 2 ... */
+static double luby(int x) {
+    int size = 1, seq = 0;
+    while (size < x + 1) {
+        seq++;
+        size = 2 * size + 1;
+    }
+    while (size - 1 != x) {
+        size = (size - 1) >> 1;
+        seq--;
+        x = x % size;
+    }
+    return (double)(1 << seq);
+}
+
+/* Exponential moving average; the first samples use 1/n so the average is
+ * not biased towards its zero initial value. */
+static inline void ema_update(double *ema, double x, double alpha, int64_t n) {
+    double a = 1.0 / (double)n;
+    if (a < alpha) a = alpha;
+    *ema += a * (x - *ema);
+}
+
+/* Update restart bookkeeping for a conflict whose learned clause has `lbd`.
+ * Called before backtracking, while the trail still holds the conflict. */
+static void restart_on_conflict(CDCLSolver *s, int lbd) {
+    s->conflicts_since_restart++;
+    if (s->restart_policy != RESTART_GLUCOSE) return;
+
+    ema_update(&s->trail_ema, s->trail_size, GLUCOSE_EMA_TRAIL, s->conflicts);
+    /* Blocking: a much longer trail than usual suggests we may be close to
+     * a satisfying assignment, so hold off the next restart. */
+    if (s->conflicts > GLUCOSE_BLOCK_START &&
+        s->trail_size > GLUCOSE_BLOCK_MARGIN * s->trail_ema)
+        s->conflicts_since_restart = 0;
+
+    ema_update(&s->lbd_ema_fast, lbd, GLUCOSE_EMA_FAST, s->conflicts);
+    ema_update(&s->lbd_ema_slow, lbd, GLUCOSE_EMA_SLOW, s->conflicts);
+}
+
+/* Should the solver restart before its next decision? */
+static bool restart_due(CDCLSolver *s) {
+    switch (s->restart_policy) {
+    case RESTART_LUBY:
+        return s->conflicts_since_restart >= LUBY_UNIT * luby(s->luby_index);
+    case RESTART_GLUCOSE:
+        return s->conflicts_since_restart >= GLUCOSE_MIN_CONFLICTS &&
+               s->lbd_ema_fast > GLUCOSE_MARGIN * s->lbd_ema_slow;
+    default:
+        return false;
+    }
+}
+
+/* ========================================================================= */
+/*  Preprocessing                                                            */
 /* ========================================================================= */
 
 /*
- * Main CDCL solving routine.
- * Returns SAT (1) or UNSAT (0).
- * If SAT, the satisfying assignment is available via s->assigns[].
+ * cdcl_preprocess() works on occurrence lists of the original clauses,
+ * built for the pass:
+ *
+ *   - Level-0 facts are applied: satisfied clauses are removed, false
+ *     literals dropped, and the units this leaves are propagated the same
+ *     way.
+ *   - Backward subsumption: a clause C removes every clause D ⊇ C.  With
+ *     self-subsuming resolution, C = C' ∨ l also removes ~l from every
+ *     D ⊇ C' ∨ ~l.  Candidates D are taken from the occurrence lists of
+ *     the variable of C that occurs least.
+ *   - Bounded variable elimination: the clauses of a variable x are
+ *     replaced by their non-tautological resolvents on x when there are no
+ *     more of those than clauses removed.  Variables are tried cheapest
+ *     first (fewest occurrences) and the resolvents go through subsumption.
+ *
+ * The clauses of an eliminated variable are kept on the extension stack as
+ * [x-literal, other literals..., length].  extend_model() walks it from the
+ * top and makes each clause true by flipping its x-literal where needed:
+ * the resolvents hold in the model, so the clauses with x and those with ~x
+ * never both need flipping.
+ *
+ * Learnt clauses are not in the pass; afterwards those on an eliminated
+ * variable are dropped and the others cleaned of level-0 literals.
  */
-int cdcl_solve(CDCLSolver *s) {
-    /* Handle any unit clauses present at the start. */
+
+typedef struct {
+    CRef     *cls;          /* clauses in the pass, by index             */
+    uint64_t *sig;          /* variable signature of each clause         */
+    char     *queued;       /* clause waits in queue[]                   */
+    int       count, cap;
+    int     **occ;          /* occ[lit]: indices of the clauses with lit;
+                             * entries of removed clauses are skipped    */
+    int      *occ_size, *occ_cap;
+    int      *queue;        /* clauses to run backward subsumption on    */
+    int       queue_size, queue_cap;
+    int      *tmp;          /* copy of the occurrence list being walked  */
+    int       tmp_cap;
+    uint32_t *mark;         /* per literal; == stamp while marked        */
+    uint32_t  stamp;
+    int       facts;        /* trail position of the next fact to apply  */
+    int64_t   budget;       /* literal visits left                       */
+} Prep;
+
+static inline Clause *pp_clause(CDCLSolver *s, Prep *p, int i) {
+    return cdcl_clause(s, p->cls[i]);
+}
+
+static uint64_t pp_signature(const Clause *c) {
+    uint64_t sig = 0;
+    for (int k = 0; k < (int)c->size; k++) sig |= 1ull << (lit_var(c->lits[k]) & 63);
+    return sig;
+}
+
+static void pp_queue(Prep *p, int i) {
+    if (p->queued[i]) return;
+    if (p->queue_size == p->queue_cap) {
+        p->queue_cap = p->queue_cap ? p->queue_cap * 2 : 64;
+        p->queue = (int *)realloc(p->queue, p->queue_cap * sizeof(int));
+    }
+    p->queue[p->queue_size++] = i;
+    p->queued[i] = 1;
+}
+
+static void pp_occ_push(Prep *p, int lit, int i) {
+    if (p->occ_size[lit] == p->occ_cap[lit]) {
+        p->occ_cap[lit] = p->occ_cap[lit] ? p->occ_cap[lit] * 2 : 4;
+        p->occ[lit] = (int *)realloc(p->occ[lit], p->occ_cap[lit] * sizeof(int));
+    }
+    p->occ[lit][p->occ_size[lit]++] = i;
+}
+
+/* Take clause `cr` (at least two literals, none assigned) into the pass. */
+static void pp_add(CDCLSolver *s, Prep *p, CRef cr) {
+    if (p->count == p->cap) {
+        p->cap    = p->cap ? p->cap * 2 : 1024;
+        p->cls    = (CRef *)realloc(p->cls, p->cap * sizeof(CRef));
+        p->sig    = (uint64_t *)realloc(p->sig, p->cap * sizeof(uint64_t));
+        p->queued = (char *)realloc(p->queued, p->cap * sizeof(char));
+    }
+    int i = p->count++;
+    Clause *c = cdcl_clause(s, cr);
+    p->cls[i]    = cr;
+    p->sig[i]    = pp_signature(c);
+    p->queued[i] = 0;
+    for (int k = 0; k < (int)c->size; k++) pp_occ_push(p, c->lits[k], i);
+    pp_queue(p, i);
+}
+
+static void pp_remove(CDCLSolver *s, Prep *p, int i) {
+    Clause *c = pp_clause(s, p, i);
+    if (s->proof) proof_delete(s->proof, c->lits, (int)c->size);
+    c->deleted = 1;
+    s->arena_wasted += clause_words(c->size);
+}
+
+/* Copy the live entries of occ[lit] to p->tmp (walks that change the list
+ * go over the copy).  Returns their number. */
+static int pp_snapshot(CDCLSolver *s, Prep *p, int lit) {
+    int n = 0;
+    int *occ = p->occ[lit];
+    for (int k = 0; k < p->occ_size[lit]; k++)
+        if (!pp_clause(s, p, occ[k])->deleted) occ[n++] = occ[k];
+    p->occ_size[lit] = n;
+    if (n > p->tmp_cap) {
+        p->tmp_cap = n;
+        p->tmp = (int *)realloc(p->tmp, n * sizeof(int));
+    }
+    memcpy(p->tmp, occ, n * sizeof(int));
+    return n;
+}
+
+/* Make `code` a level-0 fact.  Returns false if it is already false. */
+static bool pp_fact(CDCLSolver *s, int code) {
+    int val = lit_value(s, code);
+    if (val == UNASSIGNED) enqueue(s, code, CREF_UNDEF);
+    return val != 0;
+}
+
+/* Remove literal `lit` from clause i.  A clause left with one literal
+ * becomes a fact.  Returns false if that fact is already false. */
+static bool pp_strengthen(CDCLSolver *s, Prep *p, int i, int lit) {
+    Clause *c = pp_clause(s, p, i);
+    int k = 0;
+    while (c->lits[k] != lit) k++;
+    c->lits[k] = c->lits[--c->size];
+    s->arena_wasted++;
+    if (s->proof) {
+        proof_add(s->proof, c->lits, (int)c->size);
+        proof_begin(s->proof, true);
+        for (k = 0; k < (int)c->size; k++) proof_lit(s->proof, c->lits[k]);
+        proof_lit(s->proof, lit);
+        proof_end(s->proof);
+    }
+
+    int *occ = p->occ[lit];
+    int n = p->occ_size[lit];
+    for (k = 0; occ[k] != i; k++) { }
+    occ[k] = occ[n - 1];
+    p->occ_size[lit] = n - 1;
+
+    if (c->size == 1) {
+        /* The unit stays in the proof: the checker needs it as a fact. */
+        int unit = c->lits[0];
+        c->deleted = 1;
+        s->arena_wasted += clause_words(c->size);
+        return pp_fact(s, unit);
+    }
+    p->sig[i] = pp_signature(c);
+    pp_queue(p, i);
+    return true;
+}
+
+/* Apply the facts on the trail from p->facts on.  Returns false on a
+ * conflict. */
+static bool pp_propagate(CDCLSolver *s, Prep *p) {
+    while (p->facts < s->trail_size) {
+        int lit = s->trail[p->facts++];
+        int n = pp_snapshot(s, p, lit);
+        for (int k = 0; k < n; k++) pp_remove(s, p, p->tmp[k]);
+        p->occ_size[lit] = 0;
+
+        n = pp_snapshot(s, p, lit ^ 1);
+        for (int k = 0; k < n; k++) {
+            if (pp_clause(s, p, p->tmp[k])->deleted) continue;
+            if (!pp_strengthen(s, p, p->tmp[k], lit ^ 1)) return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * Compare clauses c and d.  Returns -1 if c subsumes d, a literal l of c
+ * if (c with ~l for l) subsumes d, so that ~l can be removed from d, or -2
+ * otherwise.
+ */
+static int pp_subsumes(Prep *p, const Clause *c, const Clause *d) {
+    p->stamp++;
+    for (int k = 0; k < (int)d->size; k++) p->mark[d->lits[k]] = p->stamp;
+    p->budget -= c->size + d->size;
+
+    int ret = -1;
+    for (int k = 0; k < (int)c->size; k++) {
+        int lit = c->lits[k];
+        if (p->mark[lit] == p->stamp) continue;
+        if (ret == -1 && p->mark[lit ^ 1] == p->stamp) {
+            ret = lit;
+            continue;
+        }
+        return -2;
+    }
+    return ret;
+}
+
+/* Run backward subsumption and self-subsumption with clause i.  Returns
+ * false if a strengthened clause contradicts a fact. */
+static bool pp_backward(CDCLSolver *s, Prep *p, int i) {
+    Clause *c = pp_clause(s, p, i);
+    if (c->deleted) return true;
+
+    int best = c->lits[0];
+    for (int k = 1; k < (int)c->size; k++) {
+        int lit = c->lits[k];
+        if (p->occ_size[lit] + p->occ_size[lit ^ 1] <
+            p->occ_size[best] + p->occ_size[best ^ 1])
+            best = lit;
+    }
+
+    for (int pol = 0; pol < 2; pol++) {
+        int n = pp_snapshot(s, p, best ^ pol);
+        for (int k = 0; k < n; k++) {
+            int j = p->tmp[k];
+            Clause *d = pp_clause(s, p, j);
+            if (j == i || d->deleted || d->size < c->size) continue;
+            if (p->sig[i] & ~p->sig[j]) continue;
+
+            int r = pp_subsumes(p, c, d);
+            if (r == -1) pp_remove(s, p, j);
+            else if (r >= 0 && !pp_strengthen(s, p, j, r ^ 1)) return false;
+        }
+    }
+    return true;
+}
+
+/* Empty the subsumption queue.  Returns false on a conflict. */
+static bool pp_subsume_queued(CDCLSolver *s, Prep *p) {
+    while (p->queue_size > 0 && p->budget > 0) {
+        int i = p->queue[--p->queue_size];
+        p->queued[i] = 0;
+        if (!pp_backward(s, p, i) || !pp_propagate(s, p)) return false;
+    }
+    return true;
+}
+
+/* Resolve clause c (with x-literal `x`) against d (with ~x) into `out`,
+ * which holds PP_RESOLVENT_MAX literals.  Returns the resolvent length
+ * (PP_RESOLVENT_MAX + 1 if longer), or -1 for a tautology. */
+static int pp_resolve(Prep *p, const Clause *c, const Clause *d, int x, int *out) {
+    p->stamp++;
+    p->budget -= c->size + d->size;
+    int len = 0;
+    for (int k = 0; k < (int)c->size; k++) {
+        int lit = c->lits[k];
+        if (lit == x) continue;
+        p->mark[lit] = p->stamp;
+        if (len < PP_RESOLVENT_MAX) out[len] = lit;
+        len++;
+    }
+    for (int k = 0; k < (int)d->size; k++) {
+        int lit = d->lits[k];
+        if (lit == (x ^ 1) || p->mark[lit] == p->stamp) continue;
+        if (p->mark[lit ^ 1] == p->stamp) return -1;
+        if (len < PP_RESOLVENT_MAX) out[len] = lit;
+        len++;
+    }
+    return len > PP_RESOLVENT_MAX ? PP_RESOLVENT_MAX + 1 : len;
+}
+
+/* Save clause c, x-literal first, on the extension stack. */
+static void elim_push(CDCLSolver *s, const Clause *c, int x) {
+    int need = s->elim_size + (int)c->size + 1;
+    if (need > s->elim_cap) {
+        s->elim_cap = need > 2 * s->elim_cap ? need : 2 * s->elim_cap;
+        s->elim_stack = (int *)realloc(s->elim_stack, s->elim_cap * sizeof(int));
+    }
+    s->elim_stack[s->elim_size++] = x;
+    for (int k = 0; k < (int)c->size; k++)
+        if (c->lits[k] != x) s->elim_stack[s->elim_size++] = c->lits[k];
+    s->elim_stack[s->elim_size++] = (int)c->size;
+}
+
+/* Eliminate variable `var` if that does not add clauses.  Returns false
+ * if a resolvent contradicts a fact. */
+static bool pp_eliminate(CDCLSolver *s, Prep *p, int var) {
+    int pos = 2 * var, neg = 2 * var + 1;
+    int np = pp_snapshot(s, p, pos);
+    int nn = pp_snapshot(s, p, neg);
+    if (np + nn == 0 || np + nn > PP_OCC_MAX) return true;
+
+    /* Resolvents, each stored as [len, lits...]. */
+    int res[(PP_OCC_MAX + 1) * (PP_RESOLVENT_MAX + 1)];
+    int res_size = 0, num_res = 0;
+    for (int a = 0; a < np; a++) {
+        for (int b = 0; b < nn; b++) {
+            const Clause *c = pp_clause(s, p, p->occ[pos][a]);
+            const Clause *d = pp_clause(s, p, p->occ[neg][b]);
+            int len = pp_resolve(p, c, d, pos, &res[res_size + 1]);
+            if (len < 0) continue;
+            if (len > PP_RESOLVENT_MAX || ++num_res > np + nn) return true;
+            res[res_size] = len;
+            res_size += len + 1;
+        }
+    }
+
+    /* The resolvents go into the proof before the clauses they come from
+     * leave it. */
+    if (s->proof)
+        for (int r = 0; r < res_size; r += res[r] + 1) proof_add(s->proof, &res[r + 1], res[r]);
+
+    for (int a = 0; a < np; a++) {
+        elim_push(s, pp_clause(s, p, p->occ[pos][a]), pos);
+        pp_remove(s, p, p->occ[pos][a]);
+    }
+    for (int b = 0; b < nn; b++) {
+        elim_push(s, pp_clause(s, p, p->occ[neg][b]), neg);
+        pp_remove(s, p, p->occ[neg][b]);
+    }
+    p->occ_size[pos] = p->occ_size[neg] = 0;
+    s->eliminated[var] = 1;
+    s->num_eliminated++;
+
+    for (int r = 0; r < res_size; r += res[r] + 1) {
+        int len = res[r];
+        if (len == 0) return false;
+        if (len == 1) {
+            if (!pp_fact(s, res[r + 1])) return false;
+            continue;
+        }
+        CRef cr = clause_alloc(s, len, false);
+        memcpy(cdcl_clause(s, cr)->lits, &res[r + 1], len * sizeof(int));
+        clause_list_push(s, cr);
+        pp_add(s, p, cr);
+    }
+    return pp_propagate(s, p);
+}
+
+typedef struct {
+    int     var;
+    int64_t cost;
+} ElimCand;
+
+static int elim_cand_cmp(const void *a, const void *b) {
+    const ElimCand *x = (const ElimCand *)a;
+    const ElimCand *y = (const ElimCand *)b;
+    if (x->cost != y->cost) return (x->cost < y->cost) ? -1 : 1;
+    return x->var - y->var;
+}
+
+/* Run the pass.  Returns false if the formula is UNSAT. */
+static bool pp_run(CDCLSolver *s, Prep *p) {
+    /* Apply the facts to the original clauses, drop tautologies and
+     * repeated literals, and index what is left.  Facts found on the way
+     * are applied to the clauses before them by pp_propagate(). */
+    p->facts = s->trail_size;
+    int *old = NULL, old_cap = 0;
+    bool ok = true;
+    for (int i = 0; i < s->clause_count && ok; i++) {
+        CRef cr = s->clauses[i];
+        Clause *c = cdcl_clause(s, cr);
+        if (c->deleted || c->learnt) continue;
+
+        int old_size = (int)c->size;
+        if (s->proof) proof_save(c, &old, &old_cap);
+        int n = 0;
+        bool satisfied = false;
+        p->stamp++;
+        for (int k = 0; k < (int)c->size && !satisfied; k++) {
+            int lit = c->lits[k];
+            int val = lit_value(s, lit);
+            if (val == 1 || p->mark[lit ^ 1] == p->stamp) satisfied = true;
+            else if (val == UNASSIGNED && p->mark[lit] != p->stamp) {
+                p->mark[lit] = p->stamp;
+                c->lits[n++] = lit;
+            }
+        }
+        if (!satisfied) {
+            s->arena_wasted += c->size - n;
+            c->size = n;
+        }
+        if (s->proof) {
+            /* A unit that holds stays in the proof as a fact. */
+            if (satisfied && old_size > 1) proof_delete(s->proof, old, old_size);
+            else if (n < old_size) proof_shrink(s->proof, c, old, old_size);
+        }
+        if (satisfied || n <= 1) {
+            c->deleted = 1;
+            s->arena_wasted += clause_words(c->size);
+            if (satisfied) continue;
+            ok = n > 0 && pp_fact(s, c->lits[0]);
+        } else {
+            pp_add(s, p, cr);
+        }
+    }
+    free(old);
+    if (!ok || !pp_propagate(s, p)) return false;
+
+    /* Subsumption over the whole formula, then elimination. */
+    if (!pp_subsume_queued(s, p)) return false;
+
+    ElimCand *cand = (ElimCand *)malloc(s->num_vars * sizeof(ElimCand));
+    int n = 0;
+    for (int v = 1; v <= s->num_vars; v++) {
+        if (s->frozen[v] || s->eliminated[v] || cdcl_var_value(s, v) != UNASSIGNED) continue;
+        cand[n].var  = v;
+        cand[n].cost = (int64_t)p->occ_size[2 * v] * p->occ_size[2 * v + 1];
+        n++;
+    }
+    qsort(cand, n, sizeof(ElimCand), elim_cand_cmp);
+    for (int k = 0; k < n && ok && p->budget > 0; k++) {
+        int v = cand[k].var;
+        if (cdcl_var_value(s, v) != UNASSIGNED) continue;
+        ok = pp_eliminate(s, p, v) && pp_subsume_queued(s, p);
+    }
+    free(cand);
+    return ok;
+}
+
+/* Drop the learnt clauses on eliminated variables, clean the others of
+ * level-0 literals, and rebuild the watch lists over what is left. */
+static void pp_finish(CDCLSolver *s) {
+    int *old = NULL, old_cap = 0;
     for (int i = 0; i < s->clause_count; i++) {
-        Clause *c = s->clauses[i];
-        if (c->size == 0) return UNSAT;
-        if (c->size == 1) {
-            if (lit_value(s, c->lits[0]) == 0) return UNSAT; /* contradictory unit */
-            if (lit_value(s, c->lits[0]) == UNASSIGNED)
-                enqueue(s, c->lits[0], i);
+        Clause *c = cdcl_clause(s, s->clauses[i]);
+        if (c->deleted || !c->learnt) continue;
+        int old_size = (int)c->size;
+        if (s->proof) proof_save(c, &old, &old_cap);
+        int n = 0;
+        bool drop = false;
+        for (int k = 0; k < (int)c->size && !drop; k++) {
+            int lit = c->lits[k];
+            int val = lit_value(s, lit);
+            if (val == 1 || s->eliminated[lit_var(lit)]) drop = true;
+            else if (val == UNASSIGNED) c->lits[n++] = lit;
+        }
+        if (!drop) {
+            s->arena_wasted += c->size - n;
+            c->size = n;
+        }
+        if (drop || n < 2) {
+            if (s->proof) proof_delete(s->proof, old, old_size);
+            c->deleted = 1;
+            s->arena_wasted += clause_words(c->size);
+            s->num_learnts--;
+        } else if (s->proof && n < old_size) {
+            proof_shrink(s->proof, c, old, old_size);
         }
     }
+    free(old);
+
+    collect_garbage(s);
+    int lits = 2 * s->num_vars + 2;
+    for (int lit = 0; lit < lits; lit++) s->watch_size[lit] = s->bin_size[lit] = 0;
+    attach_clauses_bulk(s, 0);
+    s->clauses_scanned = s->clause_count;
+}
+
+int cdcl_preprocess(CDCLSolver *s) {
+    if (s->unsat) return UNSAT;
 
-    /* Buffer for learned clauses (max possible size = num_vars). */
-    int *learnt_buf = (int *)malloc((s->num_vars + 1) * sizeof(int));
+    /* Level-0 reasons are never looked at; forget them so that removing a
+     * reason clause is safe. */
+    for (int t = 0; t < s->trail_size; t++) s->vardata[lit_var(s->trail[t])].reason = CREF_UNDEF;
 
-#ifdef USE_HW_BCP
-    if (hw_open(hw_port) < 0) {
-        fprintf(stderr, "cdcl_solve: failed to open hardware interface\n");
-        free(learnt_buf);
+    /* For the same reason, the proof gets them as units: it may lose the
+     * clauses that implied them. */
+    if (s->proof)
+        for (int t = 0; t < s->trail_size; t++) proof_add(s->proof, &s->trail[t], 1);
+
+    Prep p;
+    memset(&p, 0, sizeof(p));
+    int lits = 2 * s->num_vars + 2;
+    p.occ      = (int **)calloc(lits, sizeof(int *));
+    p.occ_size = (int *)calloc(lits, sizeof(int));
+    p.occ_cap  = (int *)calloc(lits, sizeof(int));
+    p.mark     = (uint32_t *)calloc(lits, sizeof(uint32_t));
+    p.budget   = PP_BUDGET;
+
+    bool ok = pp_run(s, &p);
+
+    for (int lit = 0; lit < lits; lit++) free(p.occ[lit]);
+    free(p.occ);
+    free(p.occ_size);
+    free(p.occ_cap);
+    free(p.mark);
+    free(p.cls);
+    free(p.sig);
+    free(p.queued);
+    free(p.queue);
+    free(p.tmp);
+
+    if (!ok) {
+        s->unsat = true;
+        if (s->proof) proof_add(s->proof, NULL, 0);
         return UNSAT;
     }
-    hw_init(s);
-#endif
+    pp_finish(s);
+    return UNKNOWN;
+}
+
+void cdcl_freeze(CDCLSolver *s, int var) {
+    if (var >= 1 && var <= s->num_vars) s->frozen[var] = 1;
+}
+
+/* Give the eliminated variables values in s->model that satisfy their
+ * saved clauses (see above). */
+static void extend_model(CDCLSolver *s) {
+    int *model = s->model;
+    for (int i = s->elim_size; i > 0; ) {
+        int len = s->elim_stack[i - 1];
+        i -= len + 1;
+        const int *lits = &s->elim_stack[i];
+        int x = lit_var(lits[0]);
+        if (model[x] == UNASSIGNED) model[x] = 0;
+
+        bool satisfied = false;
+        for (int k = 0; k < len && !satisfied; k++)
+            satisfied = model[lit_var(lits[k])] == !(lits[k] & 1);
+        if (!satisfied) model[x] = !(lits[0] & 1);
+    }
+}
+
+/* ========================================================================= */
+/*  Statistics                                                               */
+/* ========================================================================= */
+
+static const char *const phase_names[NUM_PHASES] = {
+    "propagate", "backend", "analyze", "decide", "backtrack", "reduce", "search",
+};
+
+void cdcl_get_stats(const CDCLSolver *s, CDCLStats *out) {
+    *out = s->stats;
+    /* Kept by the solver for its own schedules. */
+    out->conflicts = s->conflicts;
+    out->restarts  = s->restarts;
+    out->reduces   = s->num_reduces;
+}
+
+/* Events per second, or 0 before any search time. */
+static inline double per_second(int64_t n, double seconds) {
+    return seconds > 0 ? (double)n / seconds : 0.0;
+}
+
+void cdcl_print_stats(const CDCLSolver *s, FILE *out) {
+    CDCLStats st;
+    cdcl_get_stats(s, &st);
+    double t = st.seconds;
+    fprintf(out, "c solve time      %.3f s\n", t);
+    fprintf(out, "c decisions       %-12lld (%.0f /s)\n",
+            (long long)st.decisions, per_second(st.decisions, t));
+    fprintf(out, "c propagations    %-12lld (%.0f /s)\n",
+            (long long)st.propagations, per_second(st.propagations, t));
+    fprintf(out, "c conflicts       %-12lld (%.0f /s)\n",
+            (long long)st.conflicts, per_second(st.conflicts, t));
+    fprintf(out, "c learnt literals %-12lld (%.1f per conflict)\n",
+            (long long)st.learnt_literals,
+            st.conflicts ? (double)st.learnt_literals / st.conflicts : 0.0);
+    fprintf(out, "c restarts        %lld\n", (long long)st.restarts);
+    fprintf(out, "c reductions      %lld\n", (long long)st.reduces);
+    fprintf(out, "c watch visits    %-12lld (%.1f per propagation)\n",
+            (long long)st.watch_visits,
+            st.propagations ? (double)st.watch_visits / st.propagations : 0.0);
+    if (st.hw_calls)
+        fprintf(out, "c backend calls   %-12lld (%lld accelerator transactions)\n",
+                (long long)st.hw_calls, (long long)st.hw_scans);
+
+    /* Phase cycles, as a share of the whole solve. */
+    uint64_t total = st.cycles[PHASE_SEARCH];
+    if (total == 0) return;
+    for (int p = 0; p < NUM_PHASES; p++)
+        fprintf(out, "c cycles %-9s %-14llu (%5.1f%%)\n", phase_names[p],
+                (unsigned long long)st.cycles[p], 100.0 * st.cycles[p] / total);
+}
+
+void cdcl_set_stats_interval(CDCLSolver *s, double seconds) {
+    s->stats_interval = seconds;
+    s->stats_next     = seconds;
+}
+
+/* One progress line once stats_interval more seconds of search have passed. */
+static void report_progress(CDCLSolver *s) {
+    double t = s->stats.seconds + (now_seconds() - s->solve_start);
+    if (t < s->stats_next) return;
+    s->stats_next = t + s->stats_interval;
+    printf("c [%8.1f s] %lld conflicts (%.0f /s), %lld decisions, %lld restarts, "
+           "%d learnts, %.0f props/s\n",
+           t, (long long)s->conflicts, per_second(s->conflicts, t),
+           (long long)s->stats.decisions, (long long)s->restarts, s->num_learnts,
+           per_second(s->stats.propagations, t));
+    fflush(stdout);
+}
+
+/* ========================================================================= */
+/*  Top-level solve loop                                                     */
+/* ========================================================================= */
+
+/*
+ * Take the clauses the other portfolio workers shared (portfolio.h).  Called
+ * at decision level 0, so each clause is simplified against the permanent
+ * assignment first.  Returns the number of clauses added, or -1 if one of
+ * them is falsified (the formula is UNSAT).
+ */
+static int import_shared(CDCLSolver *s) {
+    const BCPBackend *b = s->backend;
+    int lits[SHARE_CLAUSE_MAX];
+    int len, lbd, imported = 0;
+
+    while ((len = share_pull(s->share, s->share_id, lits, &lbd)) > 0) {
+        int n = 0;
+        bool satisfied = false;
+        for (int i = 0; i < len && !satisfied; i++) {
+            int val = lit_value(s, lits[i]);
+            if (val == 1) satisfied = true;
+            else if (val == UNASSIGNED) lits[n++] = lits[i];
+        }
+        if (satisfied) continue;
+        if (n == 0) return -1;
+
+        if (n == 1) {
+            enqueue(s, lits[0], CREF_UNDEF);
+            if (b->assign) b->assign(lit_var(lits[0]), cdcl_var_value(s, lit_var(lits[0])), false);
+        } else {
+            CRef cr = add_learnt_clause(s, lits, n, lbd < n ? lbd : n);
+            if (b->learnt) b->learnt(s, cr);
+        }
+        imported++;
+    }
+    return imported;
+}
+
+/*
+ * Main CDCL solving routine.
+ * Returns SAT (1), UNSAT (0) or UNKNOWN (2, cancelled, or the backend
+ * failed to open or stopped answering).
+ * If SAT, the satisfying assignment is available via cdcl_get_value().
+ */
+static int search(CDCLSolver *s) {
+    const BCPBackend *b = s->backend;
+    if (s->unsat) return UNSAT;
+
+    /* Handle the unit clauses added since the last call. */
+    for (int i = s->clauses_scanned; i < s->clause_count; i++) {
+        Clause *c = cdcl_clause(s, s->clauses[i]);
+        if (c->size == 0 ||
+            (c->size == 1 && lit_value(s, c->lits[0]) == 0)) { /* contradictory unit */
+            s->unsat = true;
+            if (s->proof) proof_add(s->proof, NULL, 0);
+            return UNSAT;
+        }
+        if (c->size == 1 && lit_value(s, c->lits[0]) == UNASSIGNED)
+            enqueue(s, c->lits[0], s->clauses[i]);
+    }
+    s->clauses_scanned = s->clause_count;
+
+    if (b->open && b->open(s->backend_port) < 0) {
+        fprintf(stderr, "cdcl_solve: failed to open the %s backend\n", b->name);
+        return UNKNOWN;
+    }
+    if (b->init) b->init(s);
 
     while (true) {
-#ifdef USE_HW_BCP
-        int conflict = hw_propagate(s);
-#else
-        int conflict = propagate(s);
-#endif
+        if (atomic_load_explicit(&s->cancel, memory_order_relaxed)) {
+            if (b->close) b->close();
+            return UNKNOWN;
+        }
+
+        CRef conflict = backend_propagate(s);
 
-        if (conflict >= 0) {
+        if (conflict == CREF_ERROR) {
+            fprintf(stderr, "cdcl_solve: the %s backend stopped answering\n", b->name);
+            if (b->close) b->close();
+            return UNKNOWN;
+        }
+        if (conflict != CREF_UNDEF) {
             /* CONFLICT */
             if (s->num_decisions == 0) {
                 /* Conflict at decision level 0 — formula is UNSAT. */
-#ifdef USE_HW_BCP
-                hw_close();
-#endif
-                free(learnt_buf);
+                s->unsat = true;
+                if (s->proof) proof_add(s->proof, NULL, 0);
+                if (b->close) b->close();
                 return UNSAT;
             }
 
+            s->conflicts++;
+            if (s->polarity == POLARITY_TARGET) update_target_phase(s);
+
             /* Analyze the conflict and derive a learned clause. */
+            PROF_START(t0);
             int bt_level = 0;
-            int learnt_len = analyze(s, conflict, learnt_buf, &bt_level);
+            int lbd = 0;
+            int learnt_len = analyze(s, conflict, &bt_level, &lbd);
+            int *learnt_buf = s->learnt;
+            s->stats.learnt_literals += learnt_len;
+            PROF_STOP(s, PHASE_ANALYZE, t0);
+            restart_on_conflict(s, lbd);
+            if (s->proof) proof_add(s->proof, learnt_buf, learnt_len);
+            if (s->share) share_push(s->share, s->share_id, learnt_buf, learnt_len, lbd);
 
             /* Backtrack to the computed level. */
+            PROF_START(t1);
             backtrack(s, bt_level);
-#ifdef USE_HW_BCP
-            hw_sync_assigns(s, bt_level);
-#endif
+            if (b->sync) b->sync(s, bt_level);
+            PROF_STOP(s, PHASE_BACKTRACK, t1);
 
             /* Add the learned clause and propagate the asserting literal. */
             if (learnt_len == 1) {
                 /* Unit learned clause — enqueue at level 0. */
-                enqueue(s, learnt_buf[0], -1);
+                enqueue(s, learnt_buf[0], CREF_UNDEF);
             } else {
-                int ci = add_learnt_clause(s, learnt_buf, learnt_len);
-                enqueue(s, learnt_buf[0], ci);
+                CRef cr = add_learnt_clause(s, learnt_buf, learnt_len, lbd);
+                enqueue(s, learnt_buf[0], cr);
+                if (b->learnt) b->learnt(s, cr);
+            }
+            /* The accelerator must see the asserting literal as assigned,
+             * or it may imply it the other way or miss conflicts on it. */
+            if (b->assign)
+                b->assign(lit_var(learnt_buf[0]), cdcl_var_value(s, lit_var(learnt_buf[0])), false);
+
+            if (s->polarity == POLARITY_TARGET && s->conflicts >= s->next_rephase)
+                rephase(s);
+
+            /* Periodically drop low-value learned clauses. */
+            PROF_START(t2);
+            if (s->conflicts >= s->next_reduce) {
+                reduce_db(s);
+                if (b->reduced) b->reduced(s);
             }
+            check_garbage(s);
+            PROF_STOP(s, PHASE_REDUCE, t2);
+
+            if (s->stats_interval > 0 && (s->conflicts & 255) == 0) report_progress(s);
         } else {
-            /* NO CONFLICT — make a decision. */
-            int dec_var = pick_decision_var(s);
-            if (dec_var == 0) {
-                /* All variables assigned — formula is SAT. */
-#ifdef USE_HW_BCP
-                hw_close();
-#endif
-                free(learnt_buf);
-                return SAT;
+            /* NO CONFLICT — pick up shared clauses at level 0, restart if
+             * the policy asks for it, else decide.  Without a restart for
+             * SHARE_IMPORT_CONFLICTS conflicts, go back to level 0 for
+             * clauses that are waiting. */
+            if (s->share && s->num_decisions > 0 && s->conflicts >= s->next_import) {
+                s->next_import = s->conflicts + SHARE_IMPORT_CONFLICTS;
+                if (share_pending(s->share, s->share_id)) {
+                    PROF_START(t0);
+                    backtrack(s, 0);
+                    if (b->sync) b->sync(s, 0);
+                    PROF_STOP(s, PHASE_BACKTRACK, t0);
+                }
+            }
+            if (s->share && s->num_decisions == 0) {
+                s->next_import = s->conflicts + SHARE_IMPORT_CONFLICTS;
+                int imported = import_shared(s);
+                if (imported < 0) {
+                    s->unsat = true;
+                    if (b->close) b->close();
+                    return UNSAT;
+                }
+                if (imported > 0) continue;  /* propagate them first */
+            }
+
+            if (s->num_decisions > 0 && restart_due(s)) {
+                PROF_START(t0);
+                backtrack(s, 0);
+                if (b->sync) b->sync(s, 0);
+                PROF_STOP(s, PHASE_BACKTRACK, t0);
+                s->restarts++;
+                s->luby_index++;
+                s->conflicts_since_restart = 0;
+                s->target_size = 0;
+                continue;
+            }
+
+            /* Assumptions come first, one decision level each. */
+            int dec_lit = -1;
+            while (s->num_decisions < s->num_assumptions) {
+                int p = s->assumptions[s->num_decisions];
+                int val = lit_value(s, p);
+                if (val == UNASSIGNED) {
+                    dec_lit = p;
+                    break;
+                }
+                if (val == 0) {
+                    analyze_final(s, p);
+                    if (b->close) b->close();
+                    return UNSAT;
+                }
+                /* Already true: an empty level keeps levels and assumptions
+                 * in step. */
+                s->trail_delimiters[s->num_decisions++] = s->trail_size;
+                if (b->assign) b->assign(0, UNASSIGNED, true);
+            }
+
+            if (dec_lit < 0) {
+                PROF_START(t1);
+                int dec_var = pick_decision_var(s);
+                if (dec_var == 0) {
+                    /* All variables assigned — formula is SAT. */
+                    for (int v = 0; v <= s->num_vars; v++) s->model[v] = cdcl_var_value(s, v);
+                    extend_model(s);
+                    if (b->close) b->close();
+                    return SAT;
+                }
+                /* Decide using the configured polarity heuristic. */
+                dec_lit = lit_to_code(pick_polarity(s, dec_var) ? dec_var : -dec_var);
+                PROF_STOP(s, PHASE_DECIDE, t1);
             }
 
             /* New decision level. */
+            s->stats.decisions++;
             s->trail_delimiters[s->num_decisions] = s->trail_size;
             s->num_decisions++;
+            enqueue(s, dec_lit, CREF_UNDEF);
+            if (b->assign) b->assign(lit_var(dec_lit), cdcl_var_value(s, lit_var(dec_lit)), true);
+        }
+    }
+}
 
-            /* Decide: assign the variable to FALSE (arbitrary polarity). */
-            int dec_lit = lit_to_code(-dec_var); /* negative literal = assign FALSE */
-            enqueue(s, dec_lit, -1);
-#ifdef USE_HW_BCP
-            hw_write_assign(dec_var, s->assigns[dec_var]);
-#endif
+int cdcl_solve_assumptions(CDCLSolver *s, const int *lits, int n) {
+    if (n > s->assumptions_cap) {
+        s->assumptions     = (int *)realloc(s->assumptions, n * sizeof(int));
+        s->core            = (int *)realloc(s->core, n * sizeof(int));
+        s->assumptions_cap = n;
+    }
+    for (int i = 0; i < n; i++) {
+        if (s->num_eliminated > 0 && s->eliminated[abs(lits[i])]) {
+            fprintf(stderr, "cdcl: assumption on eliminated variable %d\n", abs(lits[i]));
+            return UNKNOWN;
         }
     }
+    for (int i = 0; i < n; i++) s->assumptions[i] = lit_to_code(lits[i]);
+    s->num_assumptions = n;
+    s->core_size       = 0;
+
+    /* An assumption that is already true takes a level of its own. */
+    if (s->num_vars + 1 + n > s->level_cap) {
+        int cap = s->num_vars + 1 + n;
+        s->trail_delimiters = (int *)realloc(s->trail_delimiters, cap * sizeof(int));
+        s->level_stamp = (uint32_t *)realloc(s->level_stamp, cap * sizeof(uint32_t));
+        memset(s->level_stamp + s->level_cap, 0, (cap - s->level_cap) * sizeof(uint32_t));
+        s->level_cap = cap;
+    }
+
+    s->solve_start = now_seconds();
+    PROF_START(t0);
+    int result = search(s);
+
+    /* Leave the solver at level 0, ready for new clauses. */
+    backtrack(s, 0);
+    /* The accelerator handed its clauses back on close without their
+     * watches kept up to date; propagating the level-0 facts again at the
+     * next solve moves the watches off false literals. */
+    if (s->backend->propagate) s->prop_head = 0;
+    s->num_assumptions = 0;
+    atomic_store(&s->cancel, false);
+    PROF_STOP(s, PHASE_SEARCH, t0);
+    s->stats.seconds += now_seconds() - s->solve_start;
+    return result;
+}
+
+int cdcl_solve(CDCLSolver *s) {
+    return cdcl_solve_assumptions(s, NULL, 0);
+}
+
+const int *cdcl_final_conflict(const CDCLSolver *s, int *size) {
+    *size = s->core_size;
+    return s->core;
+}
+
+void cdcl_cancel(CDCLSolver *s) {
+    atomic_store(&s->cancel, true);
 }
 
 /* ========================================================================= */
@@ -577,5 +2629,5 @@ int cdcl_solve(CDCLSolver *s) {
 
 int cdcl_get_value(CDCLSolver *s, int var) {
     if (var < 1 || var > s->num_vars) return UNASSIGNED;
-    return s->assigns[var];
+    return s->model[var];
 }
@@ -8,66 +8,329 @@
  *   3. Call cdcl_solve() — returns SAT or UNSAT.
  *   4. If SAT, query variable values with cdcl_get_value().
  *   5. Free with cdcl_destroy().
+ *
+ * The solver is incremental: after a solve, more clauses may be added and
+ * cdcl_solve() or cdcl_solve_assumptions() called again.  Learnt clauses,
+ * activities and phases carry over from one call to the next.
  */
 
 #ifndef CDCL_H
 #define CDCL_H
 
 #include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdatomic.h>
 
 /* Solver return values. */
 #define SAT        1
 #define UNSAT      0
 #define UNASSIGNED (-1)
+#define UNKNOWN    2        /* cancelled, backend failed, or no answer yet */
 
 /* ========================================================================= */
 /*  Data structures                                                          */
 /* ========================================================================= */
 
 /*
- * Clause: a disjunction of literals.
- * Stored with a flexible array member for the literal list.
+ * Clause reference: offset (in 32-bit words) of a clause inside the
+ * solver's clause arena.  Clauses are stored back to back in one growable
+ * buffer, so a CRef stays meaningful across arena reallocation; it only
+ * changes when the garbage collector compacts the arena.
+ */
+typedef uint32_t CRef;
+#define CREF_UNDEF UINT32_MAX   /* "no clause" (decisions, no conflict) */
+#define CREF_ERROR (UINT32_MAX - 1)  /* backend failure, see bcp_backend.h */
+
+/*
+ * Reasons from binary clauses are stored inline in VarData.reason rather
+ * than as a clause reference: REASON_BINARY | <other literal of the
+ * clause>.  Arena offsets therefore stay below REASON_BINARY.
+ */
+#define REASON_BINARY 0x80000000u
+
+/*
+ * The entries of a binary clause resident on the BCP accelerator carry
+ * BIN_RESIDENT in their `cref` (the same unused top bit), so that the
+ * binary implication loop skips them without loading the clause.
+ */
+#define BIN_RESIDENT 0x80000000u
+
+/*
+ * A solver made by cdcl_clone() with a ClauseBase reads its original
+ * clauses from the base, which the portfolio workers share read-only:
+ * their references are CREF_BASE | <offset in the base>, and the solver's
+ * own arena stays below CREF_BASE.  BCP cannot move the watches of such a
+ * clause to its front, so each solver keeps them in base_watch[], at the
+ * index the base stores in the clause's `lbd` field.
+ */
+#define CREF_BASE 0x40000000u
+
+/*
+ * Clause: a disjunction of literals, laid out inline in the arena.
+ * Header fields are packed in front of a flexible array of literals.
  * Literals use the internal encoding: positive x -> 2*x, negative x -> 2*x+1.
  */
 typedef struct {
-    int  size;      /* number of literals                     */
-    bool learnt;    /* true if this clause was learned         */
-    int  lits[];    /* flexible array of internal literal codes */
+    uint32_t size    : 28;  /* number of literals                          */
+    uint32_t learnt  : 1;   /* true if this clause was learned             */
+    uint32_t deleted : 1;   /* freed; storage reclaimed by the next GC     */
+    uint32_t reloced : 1;   /* moved by GC; `lbd` holds the new CRef       */
+    uint32_t hw      : 1;   /* resident on the BCP accelerator             */
+    uint32_t lbd;           /* literal block distance (learnt clauses)     */
+    float    activity;      /* clause activity (learnt clauses)            */
+    int      lits[];        /* flexible array of internal literal codes    */
 } Clause;
 
+/* Restart strategies, selected with cdcl_set_restart(). */
+typedef enum {
+    RESTART_NONE,           /* never restart                                  */
+    RESTART_LUBY,           /* Luby sequence scaled by a fixed conflict unit  */
+    RESTART_GLUCOSE,        /* LBD moving averages with trail-size blocking   */
+} RestartPolicy;
+
+/* Decision polarity heuristics, selected with cdcl_set_polarity(). */
+typedef enum {
+    POLARITY_SAVED,         /* phase saving: reuse the last assigned value    */
+    POLARITY_TRUE,          /* always decide TRUE                             */
+    POLARITY_FALSE,         /* always decide FALSE                            */
+    POLARITY_RANDOM,        /* pseudo-random polarity (see cdcl_set_seed())   */
+    POLARITY_TARGET,        /* target phases with periodic rephasing          */
+} PolarityMode;
+
+/* BCP backend (software, FPGA drivers, simulator); see bcp_backend.h. */
+typedef struct BCPBackend BCPBackend;
+
+/* Learnt clause exchange between portfolio workers; see portfolio.h. */
+typedef struct ClauseShare ClauseShare;
+
+/* Original clauses shared read-only by cdcl_clone()s; see CREF_BASE. */
+typedef struct ClauseBase ClauseBase;
+
+/* DRAT proof output; see proof.h. */
+typedef struct Proof Proof;
+
+/* Phases timed by the cycle counters of CDCL_PROFILE builds. */
+typedef enum {
+    PHASE_PROPAGATE,        /* software BCP                                   */
+    PHASE_BACKEND,          /* the backend's propagate hook (driver, FPGA)    */
+    PHASE_ANALYZE,          /* conflict analysis and minimization             */
+    PHASE_DECIDE,           /* decision variable and polarity                 */
+    PHASE_BACKTRACK,        /* backtrack() and the backend's sync hook        */
+    PHASE_REDUCE,           /* learnt clause reduction, garbage collection    */
+    PHASE_SEARCH,           /* all of cdcl_solve(), the total of the others   */
+    NUM_PHASES
+} CDCLPhase;
+
+/*
+ * Search statistics, summed over all solves; read with cdcl_get_stats().
+ * The cycle counts are the time stamp counter (rdtsc or the platform's
+ * equivalent) and stay zero unless built with -DCDCL_PROFILE=1.
+ */
+typedef struct {
+    int64_t  decisions;       /* including assumptions                       */
+    int64_t  propagations;    /* literals taken off the trail by BCP         */
+    int64_t  conflicts;
+    int64_t  learnt_literals; /* literals of learnt clauses, after minimization */
+    int64_t  restarts;
+    int64_t  reduces;         /* learnt clause reductions                    */
+    int64_t  watch_visits;    /* long-clause watchers inspected by BCP       */
+    int64_t  hw_calls;        /* calls of the backend's propagate hook       */
+    int64_t  hw_scans;        /* accelerator transactions (see bcp_hw_scans) */
+    double   seconds;         /* wall time spent in cdcl_solve()             */
+    uint64_t cycles[NUM_PHASES];
+} CDCLStats;
+
+/* Number of arena words taken by a clause header. */
+#define CLAUSE_HEADER_WORDS (sizeof(Clause) / sizeof(uint32_t))
+
+/*
+ * Watch list entry.  `blocker` is some other literal of the clause; if it
+ * is already true the clause is satisfied and BCP can skip it without
+ * touching clause memory.
+ */
+typedef struct {
+    CRef cref;              /* watched clause                           */
+    int  blocker;           /* internal literal code of a blocking literal */
+} Watcher;
+
+/*
+ * Per-variable assignment record.  analyze() looks at the level and the
+ * reason of each variable it visits, so the two share a record.
+ */
+typedef struct {
+    int  level;             /* decision level at which the variable was assigned */
+    CRef reason;            /* implying clause (or inline binary reason), or CREF_UNDEF */
+} VarData;
+
 /*
  * CDCLSolver: the main solver state.
  */
 typedef struct {
     int num_vars;           /* number of variables (1-indexed)       */
+    int var_cap;            /* variables the arrays below are sized for */
+
+    /* Current assignment, indexed by literal code (2..2*num_vars+1):
+     * 0=FALSE, 1=TRUE, -1=UNASSIGNED.  Both literals of a variable are kept
+     * up to date, so the value of a literal is one load. */
+    signed char *values;
 
     /* Per-variable data (indexed 1..num_vars). */
-    int    *assigns;        /* current assignment: 0=FALSE, 1=TRUE, -1=UNASSIGNED */
-    int    *levels;         /* decision level at which variable was assigned       */
-    int    *reasons;        /* clause index that implied the assignment, or -1     */
-    double *activity;       /* VSIDS activity score                               */
+    VarData *vardata;       /* level and reason of each assigned variable    */
+    double  *activity;      /* VSIDS activity score                          */
+
+    /* VSIDS decision queue: indexed binary max-heap keyed on activity. */
+    int *heap;              /* heap[i] = variable stored at heap position i  */
+    int  heap_size;         /* number of variables currently in the heap     */
+    int *heap_index;        /* position of each variable in heap[], or -1    */
 
     /* Propagation trail. */
     int *trail;             /* sequence of assigned literal codes      */
     int  trail_size;        /* current length of the trail             */
     int  prop_head;         /* propagation queue head pointer          */
+    int  hw_head;           /* queue head of hw_propagate()            */
     int *trail_delimiters;  /* trail_size at the start of each decision level */
+    int  trail_popped;      /* trail_size before the last backtrack(); the
+                             * popped literals remain in trail[trail_size..
+                             * trail_popped) until the next enqueue */
     int  num_decisions;     /* current decision level                  */
 
     /* Two-watched-literal scheme: one watch list per literal code. */
-    int **watches;          /* watches[lit] = array of clause indices  */
+    Watcher **watches;      /* watches[lit] = array of watchers         */
     int  *watch_size;       /* current size of each watch list         */
     int  *watch_cap;        /* allocated capacity of each watch list   */
 
+    /* Binary implication lists: bin_watches[lit] holds one entry per binary
+     * clause containing `lit`, with the clause's other literal as blocker. */
+    Watcher **bin_watches;
+    int  *bin_size;
+    int  *bin_cap;
+
+    /* Clause arena: every clause stored contiguously, addressed by CRef. */
+    uint32_t *arena;        /* backing store, in 32-bit words           */
+    uint32_t  arena_size;   /* words in use                             */
+    uint32_t  arena_cap;    /* words allocated                          */
+    uint32_t  arena_wasted; /* words held by deleted clauses            */
+    const uint32_t *base_arena; /* shared original clauses, or NULL     */
+    int      *base_watch;   /* watched pair of each long base clause    */
+
     /* Clause database. */
-    Clause **clauses;       /* array of clause pointers    */
-    int      clause_count;  /* number of clauses           */
-    int      clause_cap;    /* allocated capacity          */
+    CRef *clauses;          /* references of all live clauses, in order */
+    int   clause_count;     /* number of clauses                        */
+    int   clause_cap;       /* allocated capacity                       */
+    int   num_learnts;      /* live learned clauses                     */
+
+    /* Learned clause database reduction. */
+    double    cla_inc;      /* clause activity increment (grows on decay)  */
+    uint32_t *level_stamp;  /* per-level marks used when computing LBD     */
+    uint32_t  lbd_stamp;    /* current mark value for level_stamp[]        */
+    int64_t   conflicts;    /* conflicts seen so far                       */
+    int64_t   next_reduce;  /* conflict count that triggers the next reduce_db */
+    int       num_reduces;  /* reduce_db passes run so far                 */
+
+    /* Conflict analysis scratch space (persistent, reset incrementally). */
+    char *seen;                   /* per-variable mark, all zero between conflicts */
+    int  *analyze_stack;          /* DFS stack for recursive minimization    */
+    int  *analyze_toclear;        /* literals whose seen mark must be reset  */
+    int   toclear_size;
+    int  *learnt;                 /* learned clause output buffer            */
+
+    /* Restarts. */
+    RestartPolicy restart_policy;
+    int64_t restarts;             /* restarts performed                      */
+    int64_t conflicts_since_restart;
+    int     luby_index;           /* position in the Luby sequence           */
+    double  lbd_ema_fast;         /* short-window moving average of LBD      */
+    double  lbd_ema_slow;         /* long-window moving average of LBD       */
+    double  trail_ema;            /* moving average of trail size at conflicts */
+
+    /* Decision polarity. */
+    PolarityMode polarity;
+    signed char *phase;           /* saved phase per variable (0/1), set by backtrack */
+    signed char *target_phase;    /* phases of the longest conflict-free trail since restart */
+    signed char *best_phase;      /* phases of the longest conflict-free trail since rephase */
+    int      target_size;         /* trail length recorded in target_phase   */
+    int      best_size;           /* trail length recorded in best_phase     */
+    int64_t  next_rephase;        /* conflict count of the next rephase      */
+    int      num_rephases;        /* rephase passes run so far               */
+    uint64_t rand_state;          /* xorshift64 state for random decisions   */
 
     /* VSIDS increment (grows on each decay). */
     double var_inc;
+
+    /* BCP backend (default: software only). */
+    const BCPBackend *backend;
+    const char       *backend_port; /* passed to backend->open()       */
+
+    /* Incremental solving.  Between calls the solver is at decision level 0
+     * and the trail holds only facts that hold under any assumptions. */
+    int  *assumptions;            /* internal codes, decided at levels 1..n   */
+    int   num_assumptions;
+    int   assumptions_cap;        /* entries allocated in assumptions[], core[] */
+    int  *core;                   /* failed assumptions (signed) of the last UNSAT */
+    int   core_size;
+    int   level_cap;              /* entries in trail_delimiters[] and level_stamp[] */
+    int  *model;                  /* assignment of the last SAT answer       */
+    int   clauses_scanned;        /* clauses[0..) already checked for units  */
+    bool  unsat;                  /* UNSAT without assumptions: final        */
+
+    /* Preprocessing (cdcl_preprocess()). */
+    char *frozen;                 /* per-variable: never eliminated          */
+    char *eliminated;             /* per-variable: removed by elimination    */
+    int   num_eliminated;
+    int  *elim_stack;             /* removed clauses, see extend_model()     */
+    int   elim_size;
+    int   elim_cap;
+
+    /* Statistics (cdcl_get_stats()). */
+    CDCLStats stats;
+    double    stats_interval;     /* seconds between progress lines, 0 = none */
+    double    stats_next;         /* stats.seconds of the next progress line  */
+    double    solve_start;        /* clock at the start of the current solve  */
+
+    /* Portfolio solving (portfolio.h). */
+    ClauseShare *share;           /* exchange with the other workers, or NULL */
+    int          share_id;        /* this solver's worker number             */
+    int64_t      next_import;     /* conflict count of the next forced import */
+    atomic_bool  cancel;          /* set by cdcl_cancel()                    */
+
+    /* Proof logging (proof.h). */
+    Proof *proof;                 /* DRAT output, or NULL; not owned         */
 } CDCLSolver;
 
+/* Resolve a clause reference to the clause it names.  The pointer is only
+ * valid until the next clause allocation or garbage collection. */
+static inline Clause *cdcl_clause(const CDCLSolver *s, CRef cr) {
+    if (cr & CREF_BASE) return (Clause *)(s->base_arena + (cr & ~CREF_BASE));
+    return (Clause *)(s->arena + cr);
+}
+
+/* Current value of variable `var`: 0=FALSE, 1=TRUE, -1=UNASSIGNED. */
+static inline int cdcl_var_value(const CDCLSolver *s, int var) {
+    return s->values[2 * var];
+}
+
+/* Assign variable `var` the value `val` (0 or 1) at the current decision
+ * level and push it on the trail.  This is how the BCP backends record the
+ * implications the accelerator reports. */
+static inline void cdcl_imply(CDCLSolver *s, int var, int val, CRef reason) {
+    int code = val ? 2 * var : 2 * var + 1;
+    s->values[code]     = 1;
+    s->values[code ^ 1] = 0;
+    s->vardata[var].level  = s->num_decisions;
+    s->vardata[var].reason = reason;
+    s->trail[s->trail_size++] = code;
+}
+
+/* Mark clause `cr` resident on the accelerator or not: its `hw` bit and,
+ * for a binary clause, BIN_RESIDENT in its implication list entries. */
+void cdcl_set_resident(CDCLSolver *s, CRef cr, bool resident);
+
+/* Give clause `cr` back to software BCP after the accelerator held it:
+ * watch two literals that are not false.  Returns false, changing nothing,
+ * if it has fewer than two; the clause must then stay resident. */
+bool cdcl_rewatch(CDCLSolver *s, CRef cr);
+
 /* ========================================================================= */
 /*  Public API                                                               */
 /* ========================================================================= */
@@ -78,22 +341,139 @@ CDCLSolver *cdcl_create(int num_vars);
 /* Free all memory associated with the solver. */
 void cdcl_destroy(CDCLSolver *s);
 
+/*
+ * Empty `s` for a new problem with `num_vars` variables, as if it had just
+ * been created, but keep its memory: the clause arena, the watch lists and
+ * the other arrays are reused, and only grow if `num_vars` needs more.
+ * The configuration stays (restart policy, polarity, random state, BCP
+ * backend, statistics interval); clauses, assignments, eliminated
+ * variables, statistics and an attached proof do not.
+ */
+void cdcl_reset(CDCLSolver *s, int num_vars);
+
+/*
+ * Copy the original clauses of `s` into a ClauseBase for cdcl_clone(), or
+ * return NULL if they do not fit below CREF_BASE.  The base must outlive
+ * the solvers that use it.
+ */
+ClauseBase *cdcl_base_create(const CDCLSolver *s);
+void        cdcl_base_destroy(ClauseBase *base);
+
+/*
+ * Create a solver with the clauses (original and learnt) and the restart,
+ * polarity and seed settings of `s`, but none of its search state.  The
+ * copy uses the software backend.  With a `base` made from `s`, the
+ * original clauses are read from it instead of being copied, so that each
+ * copy only adds its learnt clauses and two watched literals per long
+ * original clause; with NULL, the copy has all clauses in its own arena.
+ */
+CDCLSolver *cdcl_clone(const CDCLSolver *s, const ClauseBase *base);
+
 /*
  * Add a clause to the formula.
  * `signed_lits` is an array of signed integers: positive = var, negative = ~var.
- * `len` is the number of literals.
- * Returns the clause index, or -1 on error.
+ * `len` is the number of literals.  Clauses may also be added between
+ * solves.
+ * Returns the clause reference (arena offset), or -1 on error.
  */
 int cdcl_add_clause(CDCLSolver *s, int *signed_lits, int len);
 
+/*
+ * Pre-size clause storage for `num_clauses` more clauses holding
+ * `total_lits` literals in total, so that loading them does not reallocate.
+ * Either count may be an estimate; 0 reserves nothing for that part.
+ */
+void cdcl_reserve(CDCLSolver *s, int num_clauses, int64_t total_lits);
+
+/*
+ * Add a batch of clauses.  `signed_lits` holds `num_lits` signed literals in
+ * DIMACS order, each clause terminated by 0 (literals after the last 0 are
+ * ignored).  Storage is sized in one step and watch lists are built with a
+ * count-then-fill pass, which is much cheaper than repeated
+ * cdcl_add_clause() calls for large formulas.
+ * Returns the number of clauses added.
+ */
+int cdcl_add_clauses(CDCLSolver *s, const int *signed_lits, int64_t num_lits);
+
+/* Select the restart strategy (default RESTART_GLUCOSE). */
+void cdcl_set_restart(CDCLSolver *s, RestartPolicy policy);
+
+/* Select the decision polarity heuristic (default POLARITY_SAVED). */
+void cdcl_set_polarity(CDCLSolver *s, PolarityMode mode);
+
+/* Seed the solver's pseudo-random number generator. */
+void cdcl_set_seed(CDCLSolver *s, uint64_t seed);
+
+/* Select the BCP backend (default &bcp_backend_sw) and the port handed to
+ * its open hook (NULL for the backend's default). */
+void cdcl_set_backend(CDCLSolver *s, const BCPBackend *backend, const char *port);
+
+/* Log the clause database changes of `s` to `proof` (NULL: stop logging).
+ * Attach it before cdcl_preprocess() and cdcl_solve(); the solver does not
+ * close it. */
+void cdcl_set_proof(CDCLSolver *s, Proof *proof);
+
+/*
+ * Simplify the formula before cdcl_solve(): remove subsumed clauses and
+ * literals, and eliminate variables whose clauses can be replaced by their
+ * resolvents without adding clauses.  Models found afterwards are extended
+ * to the eliminated variables, so cdcl_get_value() answers for every
+ * variable.  Clauses added and assumptions made later must not mention an
+ * eliminated variable; freeze the variables they will use beforehand.
+ * Returns UNSAT if the formula was found unsatisfiable, otherwise UNKNOWN.
+ */
+int cdcl_preprocess(CDCLSolver *s);
+
+/* Keep `var` out of variable elimination. */
+void cdcl_freeze(CDCLSolver *s, int var);
+
 /*
  * Solve the formula.
- * Returns SAT (1) if satisfiable, UNSAT (0) if unsatisfiable.
+ * Returns SAT (1) if satisfiable, UNSAT (0) if unsatisfiable, or UNKNOWN (2)
+ * if cdcl_cancel() stopped it or the BCP backend could not be opened or
+ * stopped answering.
  */
 int cdcl_solve(CDCLSolver *s);
 
 /*
- * After a SAT result, query the value of a variable (1-indexed).
+ * Solve under `n` assumptions: signed literals that are decided first, in
+ * order, and hold in any model returned.  Returns SAT, UNSAT or UNKNOWN.
+ * UNSAT means the formula has no model that satisfies every assumption;
+ * cdcl_final_conflict() tells which of them are to blame.  An assumption
+ * on an eliminated variable (cdcl_preprocess()) is refused with UNKNOWN.
+ */
+int cdcl_solve_assumptions(CDCLSolver *s, const int *lits, int n);
+
+/*
+ * After an UNSAT answer, the failed assumptions: a subset of the
+ * assumptions that is UNSAT together with the formula.  Empty if the
+ * formula is UNSAT on its own.  Stores the count in `*size`; the array is
+ * valid until the next solve.
+ */
+const int *cdcl_final_conflict(const CDCLSolver *s, int *size);
+
+/*
+ * Ask cdcl_solve() on `s` to stop and return UNKNOWN.  Safe to call from
+ * any thread.  The request is consumed by the solve it stops; one made
+ * while `s` is not solving stops its next cdcl_solve() straight away.
+ */
+void cdcl_cancel(CDCLSolver *s);
+
+/*
+ * Copy the search statistics of `s` into `*out`.  Safe to call between
+ * solves; during one, only from the solving thread.
+ */
+void cdcl_get_stats(const CDCLSolver *s, CDCLStats *out);
+
+/* Print the statistics as DIMACS comment (`c`) lines. */
+void cdcl_print_stats(const CDCLSolver *s, FILE *out);
+
+/* Print a one-line progress report every `seconds` of search (0: never). */
+void cdcl_set_stats_interval(CDCLSolver *s, double seconds);
+
+/*
+ * After a SAT result, query the value of a variable (1-indexed) in the
+ * model found.
  * Returns 0 (FALSE), 1 (TRUE), or UNASSIGNED (-1).
  */
 int cdcl_get_value(CDCLSolver *s, int var);
@@ -0,0 +1,216 @@
+/*
+ * batch.c — Batch and server mode: many CNF jobs in one process
+ *
+ * See batch.h.
+ *
+ * The job source is shared by the workers under a lock; a worker holds it
+ * only to read the next path.  Each result is printed with the output
+ * stream locked (flockfile()), so that the lines of one job stay together
+ * even when a driver prints its own `c` lines from another worker.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#include "CDCL.h"
+#include "dimacs.h"
+#include "bcp_backend.h"
+#include "batch.h"
+
+#define JOB_PATH_MAX 4096
+
+/* Where the jobs come from and where their results go. */
+typedef struct {
+    pthread_mutex_t lock;
+    FILE       *in;             /* one path per line, or NULL           */
+    DIR        *dir;            /* every regular file in it, or NULL    */
+    const char *dir_path;
+    FILE       *out;
+    int         jobs, sat, unsat, errors;   /* under `lock`             */
+} JobSource;
+
+typedef struct {
+    JobSource         *src;
+    CDCLSolver        *s;
+    const BatchConfig *cfg;
+} Worker;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* Take the next job's path.  Returns false once there are no more. */
+static bool next_job(JobSource *src, char *path) {
+    bool found = false;
+    pthread_mutex_lock(&src->lock);
+    while (!found) {
+        if (src->in) {
+            if (!fgets(path, JOB_PATH_MAX, src->in)) break;
+            path[strcspn(path, "\r\n")] = '\0';
+            found = path[0] != '\0';
+        } else {
+            struct dirent *e = readdir(src->dir);
+            if (!e) break;
+            snprintf(path, JOB_PATH_MAX, "%s/%s", src->dir_path, e->d_name);
+            struct stat st;
+            found = e->d_name[0] != '.' && stat(path, &st) == 0 && S_ISREG(st.st_mode);
+        }
+    }
+    pthread_mutex_unlock(&src->lock);
+    return found;
+}
+
+static void print_result(Worker *w, const char *path, int result, double seconds) {
+    FILE *out = w->src->out;
+    flockfile(out);
+    fprintf(out, "c job %.3f %s\n", seconds, path);
+    if (result == SAT) {
+        fprintf(out, "s SATISFIABLE\n");
+        if (w->cfg->models) {
+            fprintf(out, "v ");
+            for (int v = 1; v <= w->s->num_vars; v++)
+                fprintf(out, "%d ", cdcl_get_value(w->s, v) == 1 ? v : -v);
+            fprintf(out, "0\n");
+        }
+    } else {
+        fprintf(out, result == UNSAT ? "s UNSATISFIABLE\n" : "s UNKNOWN\n");
+    }
+    fflush(out);
+    funlockfile(out);
+}
+
+static void *worker_main(void *arg) {
+    Worker *w = (Worker *)arg;
+    char path[JOB_PATH_MAX];
+
+    while (next_job(w->src, path)) {
+        double start = now_seconds();
+        int result = UNKNOWN;
+        if (cdcl_load_dimacs_into(w->s, path, NULL) == 0) {
+            /* Every job starts from the same random state, whatever this
+             * worker solved before, so it can be rerun on its own. */
+            cdcl_set_seed(w->s, w->cfg->seed);
+            if (w->cfg->preprocess) cdcl_preprocess(w->s);
+            result = cdcl_solve(w->s);
+        }
+        print_result(w, path, result, now_seconds() - start);
+
+        pthread_mutex_lock(&w->src->lock);
+        w->src->jobs++;
+        if (result == SAT) w->src->sat++;
+        else if (result == UNSAT) w->src->unsat++;
+        else w->src->errors++;
+        pthread_mutex_unlock(&w->src->lock);
+    }
+    return NULL;
+}
+
+/* Run the jobs of `src` on the workers' solvers.  Returns the number of
+ * jobs that could not be loaded. */
+static int run_jobs(JobSource *src, Worker *workers, int n) {
+    pthread_mutex_init(&src->lock, NULL);
+    src->jobs = src->sat = src->unsat = src->errors = 0;
+    double start = now_seconds();
+
+    pthread_t *threads = (pthread_t *)malloc(n * sizeof(pthread_t));
+    for (int i = 0; i < n; i++) {
+        workers[i].src = src;
+        pthread_create(&threads[i], NULL, worker_main, &workers[i]);
+    }
+    for (int i = 0; i < n; i++) pthread_join(threads[i], NULL);
+    free(threads);
+
+    fprintf(src->out, "c batch: %d jobs, %d SAT, %d UNSAT, %d failed, %.3f s\n",
+            src->jobs, src->sat, src->unsat, src->errors, now_seconds() - start);
+    fflush(src->out);
+    pthread_mutex_destroy(&src->lock);
+    return src->errors;
+}
+
+/* Serve one connection after another on the Unix socket at `path`. */
+static int serve(const char *path, Worker *workers, int n) {
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "batch: socket path too long: %s\n", path);
+        return -1;
+    }
+    strcpy(addr.sun_path, path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(path);  /* a socket left by an earlier server */
+    if (fd < 0 || bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(fd, 8) < 0) {
+        perror(path);
+        if (fd >= 0) close(fd);
+        return -1;
+    }
+    fprintf(stderr, "c batch: listening on %s\n", path);
+    signal(SIGPIPE, SIG_IGN);  /* a client that goes away is not fatal */
+
+    for (;;) {
+        int conn = accept(fd, NULL, NULL);
+        if (conn < 0) {
+            perror("batch: accept");
+            break;
+        }
+        JobSource src;
+        memset(&src, 0, sizeof(src));
+        int conn_out = dup(conn);
+        src.in  = fdopen(conn, "r");
+        src.out = conn_out >= 0 ? fdopen(conn_out, "w") : NULL;
+        if (src.in && src.out) run_jobs(&src, workers, n);
+        if (src.in) fclose(src.in);
+        else close(conn);
+        if (src.out) fclose(src.out);
+        else if (conn_out >= 0) close(conn_out);
+    }
+    close(fd);
+    unlink(path);
+    return -1;
+}
+
+int batch_run(const char *source, const BatchConfig *cfg) {
+    int n = cfg->workers > 1 ? cfg->workers : 1;
+    JobSource src;
+    memset(&src, 0, sizeof(src));
+    src.out = stdout;
+
+    bool socket_mode = strncmp(source, "unix:", 5) == 0;
+    if (!socket_mode) {
+        if (strcmp(source, "-") == 0) {
+            src.in = stdin;
+        } else if (!(src.dir = opendir(source))) {
+            perror(source);
+            return -1;
+        }
+        src.dir_path = source;
+    }
+
+    Worker *workers = (Worker *)calloc(n, sizeof(Worker));
+    for (int i = 0; i < n; i++) {
+        workers[i].cfg = cfg;
+        workers[i].s   = cdcl_create(0);
+        cdcl_set_restart(workers[i].s, cfg->restart);
+        cdcl_set_polarity(workers[i].s, cfg->polarity);
+        cdcl_set_backend(workers[i].s, i == 0 ? cfg->backend : NULL, cfg->port);
+    }
+
+    int ret = socket_mode ? serve(source + 5, workers, n) : run_jobs(&src, workers, n);
+
+    for (int i = 0; i < n; i++) cdcl_destroy(workers[i].s);
+    free(workers);
+    if (src.dir) closedir(src.dir);
+    return ret;
+}
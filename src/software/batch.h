@@ -0,0 +1,59 @@
+/*
+ * batch.h — Batch and server mode: many CNF jobs in one process
+ *
+ * Usage:
+ *   BatchConfig cfg = { .workers = 4, .restart = RESTART_GLUCOSE };
+ *   batch_run("jobs/", &cfg);                 every file in a directory
+ *   batch_run("-", &cfg);                     paths on stdin, one per line
+ *   batch_run("unix:/tmp/sat.sock", &cfg);    the same over a socket
+ *
+ * A pool of `workers` threads takes jobs from the source, each with a
+ * solver of its own that is recycled with cdcl_reset() from one job to the
+ * next: the process starts once, the clause arena and the watch lists are
+ * allocated once per worker, and a hardware backend keeps its connection
+ * (the JTAG driver its OpenOCD session) across jobs.  Worker 0 runs on
+ * `backend`; the others on the software backend, as the drivers are single
+ * instances.
+ *
+ * Results go out as each job finishes, so not in job order:
+ *
+ *   c job <seconds> <path>
+ *   s SATISFIABLE | UNSATISFIABLE | UNKNOWN
+ *   v <model> 0                  (SAT, with `models`)
+ *
+ * UNKNOWN is a job that could not be loaded; the reason is on stderr.
+ *
+ * With "unix:PATH" the process is a server: it listens on a Unix socket at
+ * PATH and serves one connection after another until it is killed.  A
+ * client writes job paths and reads the results from the same connection;
+ * the job list ends when it shuts down its writing side.
+ */
+
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "CDCL.h"
+
+typedef struct {
+    int               workers;      /* solver threads (at least 1)          */
+    const BCPBackend *backend;      /* worker 0's, NULL for software        */
+    const char       *port;         /* its port, NULL for the default       */
+    RestartPolicy     restart;
+    PolarityMode      polarity;
+    uint64_t          seed;         /* 0 for the default                    */
+    bool              preprocess;   /* cdcl_preprocess() each job first     */
+    bool              models;       /* print a v line for SAT answers       */
+} BatchConfig;
+
+/*
+ * Run every job of `source` (see above) and print the results to stdout,
+ * or to the connection for a socket.  Returns the number of jobs that
+ * could not be loaded, or -1 (with a message) if the source cannot be
+ * opened.  A server only returns on an error.
+ */
+int batch_run(const char *source, const BatchConfig *cfg);
+
+#endif /* BATCH_H */
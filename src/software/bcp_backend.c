@@ -0,0 +1,25 @@
+/*
+ * bcp_backend.c — Registry of the BCP backends
+ *
+ * See bcp_backend.h.  The software backend lives in CDCL.c so that the
+ * solver links without any driver.
+ */
+
+#include <string.h>
+
+#include "bcp_backend.h"
+
+const BCPBackend *const bcp_backends[] = {
+    &bcp_backend_sw,
+    &bcp_backend_jtag,
+    &bcp_backend_uart,
+    &bcp_backend_sim,
+    NULL,
+};
+
+const BCPBackend *bcp_backend_find(const char *name) {
+    for (int i = 0; bcp_backends[i]; i++) {
+        if (strcmp(bcp_backends[i]->name, name) == 0) return bcp_backends[i];
+    }
+    return NULL;
+}
@@ -0,0 +1,118 @@
+/*
+ * bcp_backend.h — Pluggable BCP backends
+ *
+ * cdcl_solve() reaches the hardware only through a BCPBackend.  The
+ * backend is selected at runtime with cdcl_set_backend(); every backend is
+ * linked into every binary, so they can be compared on the same input in
+ * one process (main.c: -b sw,sim).
+ *
+ *   sw    software propagate() only; every hook is NULL
+ *   jtag  FPGA accelerator over JTAG and OpenOCD (hw_interface_jtag.c)
+ *   uart  FPGA accelerator over UART, legacy (hw_interface.c)
+ *   sim   cycle model of the accelerator, in process (hw_sim.c)
+ *
+ * With an accelerator backend, BCP is split by clause: the clauses that fit
+ * the accelerator are resident there (hw_clausedb.h) and the rest are
+ * propagated in software.  `propagate` only sees the resident clauses; the
+ * solver interleaves it with its own propagate() over one trail.
+ *
+ * Hooks may be NULL, in which case the solver skips them.
+ */
+
+#ifndef BCP_BACKEND_H
+#define BCP_BACKEND_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "CDCL.h"
+
+/*
+ * Accelerator performance counters, indexed as the FPGA numbers them (see
+ * src/hardware/modules/perf_counters.py).  Cycle counts are accelerator
+ * clock cycles.
+ */
+enum {
+    BCP_PERF_CYCLES,        /* clock cycles (0 from the sim backend)         */
+    BCP_PERF_ROUNDS,        /* BCP rounds started                            */
+    BCP_PERF_ACTIVE,        /* cycles with a round in progress               */
+    BCP_PERF_WLM_BUSY,      /* active cycles the watch list is still fetched */
+    BCP_PERF_FETCH_STALL,   /* clauses queued, none fetched: PEs all busy    */
+    BCP_PERF_PE_BUSY,       /* PE-cycles spent holding a clause              */
+    BCP_PERF_EVALUATED,     /* clauses evaluated                             */
+    BCP_PERF_SAT_SKIPS,     /* clauses skipped on their sat bit              */
+    BCP_PERF_FIFO_FULL,     /* implications lost to a full implication FIFO  */
+    BCP_PERF_DRAIN_WAIT,    /* cycles a full burst waits for the host        */
+    BCP_PERF_COUNTERS
+};
+
+typedef struct {
+    uint64_t count[BCP_PERF_COUNTERS];  /* since the first read after open() */
+    int      num_pes;                   /* evaluator PEs                     */
+    double   link_seconds;  /* host time in transport I/O since open()       */
+} BCPPerf;
+
+struct BCPBackend {
+    const char *name;       /* selector used on the command line            */
+    const char *desc;       /* one-line description                         */
+
+    /* Connect to the accelerator.  `port` is backend specific (the serial
+     * device for UART); NULL selects the default.  Returns 0 or -1. */
+    int  (*open)(const char *port);
+
+    /* Upload the solver's clauses and assignments. */
+    void (*init)(CDCLSolver *s);
+
+    /* Write one variable.  `val` uses the software encoding: 0=FALSE,
+     * 1=TRUE, -1=UNASSIGNED.  A decision also opens a new decision level.
+     * Variables from HW_MAX_VARS up are not held by the accelerator. */
+    void (*assign)(int var, int val, bool decision);
+
+    /* After backtracking to `from_level`, unassign the variables that
+     * backtrack() popped off the trail (see `trail_popped`). */
+    void (*sync)(CDCLSolver *s, int from_level);
+
+    /* BCP over the resident clauses for trail entries s->hw_head to
+     * s->trail_size.  Enqueues implications into the solver and returns
+     * the conflicting clause, CREF_UNDEF, or CREF_ERROR if the device
+     * stopped answering; the solve then ends with UNKNOWN. */
+    CRef (*propagate)(CDCLSolver *s);
+
+    /* Disconnect; called once the solver has an answer. */
+    void (*close)(void);
+
+    /* Read the accelerator's performance counters, between propagate
+     * calls of a solve.  Returns 0, or -1 if there are none. */
+    int  (*perf)(BCPPerf *out);
+
+    /* Clause residency, called after add_learnt_clause(), after
+     * reduce_db() and by the garbage collector (see hw_clausedb.h). */
+    void  (*learnt)(CDCLSolver *s, CRef cr);
+    void  (*reduced)(CDCLSolver *s);
+    CRef *(*refs)(int *count);
+
+    /* Raw clause memory and watch list writes, used by hw_clausedb.c.
+     * `id` is a hardware clause id; `lits` holds at most HW_MAX_K
+     * internal literal codes. */
+    void (*write_clause)(int id, const int *lits, int size);
+    void (*write_wl_entry)(int lit, int idx, int id);
+    void (*write_wl_len)(int lit, int len);
+};
+
+/* Host-accelerator transactions so far, counted by the drivers: JTAG DR
+ * scans, UART writes, or BCP rounds of the simulator.  Read into
+ * CDCLStats.hw_scans around each propagate call. */
+extern int64_t bcp_hw_scans;
+
+extern const BCPBackend bcp_backend_sw;
+extern const BCPBackend bcp_backend_jtag;
+extern const BCPBackend bcp_backend_uart;
+extern const BCPBackend bcp_backend_sim;
+
+/* Backend called `name`, or NULL. */
+const BCPBackend *bcp_backend_find(const char *name);
+
+/* NULL-terminated list of all backends, in the order above. */
+extern const BCPBackend *const bcp_backends[];
+
+#endif /* BCP_BACKEND_H */
@@ -0,0 +1,377 @@
+/*
+ * dimacs.c — DIMACS CNF loader
+ *
+ * The parser works on a byte window [p, end).  For plain files the window is
+ * the whole memory-mapped file and never needs refilling; for compressed
+ * files it is a block buffer refilled from the decompressor's pipe.  Integers
+ * are scanned with a hand-written loop instead of fscanf().
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <limits.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#include "CDCL.h"
+#include "dimacs.h"
+
+#define STREAM_BLOCK (1 << 20)  /* bytes per read() from a decompressor */
+#define CLAUSE_BATCH (1 << 20)  /* literals handed to cdcl_add_clauses() at once */
+#define STREAM_WIDTH 3          /* literals per clause assumed without a file size */
+
+/* ========================================================================= */
+/*  Input window                                                             */
+/* ========================================================================= */
+
+typedef struct {
+    const unsigned char *p;     /* next unread byte                        */
+    const unsigned char *end;   /* end of the current window               */
+
+    /* Memory-mapped plain file. */
+    void  *map;
+    size_t map_len;
+
+    /* Decompressor pipe (fd < 0 when reading a mapped file). */
+    int            fd;
+    pid_t          child;
+    unsigned char *buf;
+    bool           eof;         /* the stream has been read to the end     */
+
+    int line;                   /* current line number, for diagnostics    */
+} Reader;
+
+/* Refill the window from the decompressor.  Returns false at end of input. */
+static bool refill(Reader *r) {
+    if (r->fd < 0 || r->eof) return false;
+    for (;;) {
+        ssize_t n = read(r->fd, r->buf, STREAM_BLOCK);
+        if (n > 0) {
+            r->p   = r->buf;
+            r->end = r->buf + n;
+            return true;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        r->eof = true;
+        return false;
+    }
+}
+
+/* Current byte, or EOF. */
+static inline int peek(Reader *r) {
+    if (r->p == r->end && !refill(r)) return EOF;
+    return *r->p;
+}
+
+/* Skip spaces and line breaks; returns the next byte (not consumed). */
+static inline int skip_space(Reader *r) {
+    for (;;) {
+        int c = peek(r);
+        if (c == '\n') r->line++;
+        else if (c != ' ' && c != '\t' && c != '\r') return c;
+        r->p++;
+    }
+}
+
+/* Skip the rest of the current line, including its newline. */
+static void skip_line(Reader *r) {
+    for (;;) {
+        int c = peek(r);
+        if (c == EOF) return;
+        r->p++;
+        if (c == '\n') {
+            r->line++;
+            return;
+        }
+    }
+}
+
+/* Scan a signed decimal integer at the current position.
+ * Returns false if there are no digits or the value overflows an int. */
+static bool scan_int(Reader *r, int *out) {
+    bool neg = false;
+    if (peek(r) == '-') {
+        neg = true;
+        r->p++;
+    }
+    int c = peek(r);
+    if (c < '0' || c > '9') return false;
+
+    long long v = 0;
+    do {
+        v = v * 10 + (c - '0');
+        if (v > INT_MAX) return false;
+        r->p++;
+        c = peek(r);
+    } while (c >= '0' && c <= '9');
+
+    *out = neg ? (int)-v : (int)v;
+    return true;
+}
+
+/* ========================================================================= */
+/*  Opening plain and compressed files                                       */
+/* ========================================================================= */
+
+/* Decompressor for the file's magic bytes, or NULL for a plain file. */
+static const char *detect_compression(const unsigned char *b, size_t len) {
+    if (len >= 2 && b[0] == 0x1F && b[1] == 0x8B)
+        return "gzip";
+    if (len >= 6 && memcmp(b, "\xFD" "7zXZ\0", 6) == 0)
+        return "xz";
+    return NULL;
+}
+
+/* Start `tool -dc path` with its stdout connected to r->fd. */
+static int spawn_decompressor(Reader *r, const char *tool, const char *path) {
+    int pfd[2];
+    if (pipe(pfd) < 0) {
+        perror("pipe");
+        return -1;
+    }
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("fork");
+        close(pfd[0]);
+        close(pfd[1]);
+        return -1;
+    }
+    if (pid == 0) {
+        dup2(pfd[1], STDOUT_FILENO);
+        close(pfd[0]);
+        close(pfd[1]);
+        execlp(tool, tool, "-dc", path, (char *)NULL);
+        fprintf(stderr, "%s: cannot run %s: %s\n", path, tool, strerror(errno));
+        _exit(127);
+    }
+    close(pfd[1]);
+    r->fd    = pfd[0];
+    r->child = pid;
+    r->buf   = (unsigned char *)malloc(STREAM_BLOCK);
+    r->p = r->end = r->buf;
+    return 0;
+}
+
+static int reader_open(Reader *r, const char *path) {
+    memset(r, 0, sizeof(*r));
+    r->fd   = -1;
+    r->line = 1;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        perror(path);
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        perror(path);
+        close(fd);
+        return -1;
+    }
+
+    if (st.st_size > 0) {
+        r->map_len = (size_t)st.st_size;
+        r->map = mmap(NULL, r->map_len, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (r->map == MAP_FAILED) {
+            perror(path);
+            close(fd);
+            return -1;
+        }
+        madvise(r->map, r->map_len, MADV_SEQUENTIAL);
+    }
+    close(fd);
+
+    r->p   = (const unsigned char *)r->map;
+    r->end = r->p + r->map_len;
+
+    const char *tool = detect_compression(r->p, r->map_len);
+    if (tool) {
+        munmap(r->map, r->map_len);
+        r->map = NULL;
+        r->map_len = 0;
+        return spawn_decompressor(r, tool, path);
+    }
+    return 0;
+}
+
+/* Release the input.  Returns -1 if a decompressor that was read to the end
+ * reported failure (a corrupt or truncated archive). */
+static int reader_close(Reader *r, const char *path) {
+    int rc = 0;
+    if (r->map) munmap(r->map, r->map_len);
+    if (r->fd >= 0) {
+        close(r->fd);
+        int status;
+        while (waitpid(r->child, &status, 0) < 0 && errno == EINTR)
+            ;
+        /* Stopping early (e.g. at "%") makes the child die of SIGPIPE,
+         * which is expected; only a stream read to the end must be clean. */
+        if (r->eof && !(WIFEXITED(status) && WEXITSTATUS(status) == 0)) {
+            fprintf(stderr, "%s: decompression failed\n", path);
+            rc = -1;
+        }
+        free(r->buf);
+    }
+    return rc;
+}
+
+/* ========================================================================= */
+/*  Parser                                                                   */
+/* ========================================================================= */
+
+/* Parse "p cnf <vars> <clauses>"; the 'p' is at the current position. */
+static bool parse_header(Reader *r, int *num_vars, int *num_clauses) {
+    r->p++;  /* 'p' */
+    skip_space(r);
+    for (const char *k = "cnf"; *k; k++) {
+        if (peek(r) != *k) return false;
+        r->p++;
+    }
+    skip_space(r);
+    if (!scan_int(r, num_vars) || *num_vars < 0) return false;
+    skip_space(r);
+    if (!scan_int(r, num_clauses) || *num_clauses < 0) return false;
+    return true;
+}
+
+/*
+ * Literals to reserve for the clauses after the p-line.  In a mapped file
+ * the rest of it holds them: each clause ends in "0" and a separator, and
+ * a literal takes about the digits of `num_vars`, a separator and half the
+ * time a minus sign (fewer digits for small variables).  Counting only the
+ * digits errs on the high side, so that the arena does not grow during the
+ * load.  The size of a decompressed stream is not known; it gets
+ * STREAM_WIDTH literals per clause.
+ */
+static int64_t estimate_literals(const Reader *r, int num_vars, int num_clauses) {
+    if (!r->map) return (int64_t)num_clauses * STREAM_WIDTH;
+    int digits = 1;
+    for (int v = num_vars; v >= 10; v /= 10) digits++;
+    int64_t bytes = (int64_t)(r->end - r->p) - 2 * (int64_t)num_clauses;
+    return bytes > 0 ? bytes / digits : 0;
+}
+
+/* Load `path` into `reuse` (cdcl_reset() at the p-line), or into a new
+ * solver if it is NULL. */
+static CDCLSolver *load(const char *path, DimacsInfo *info, CDCLSolver *reuse) {
+    Reader r;
+    if (reader_open(&r, path) < 0) return NULL;
+
+    CDCLSolver *s = NULL;
+    int num_vars = 0, num_clauses = 0;
+    int clauses_read = 0, max_len = 0;
+    /* Clauses are collected 0-terminated in `batch` and added in bulk. */
+    int64_t batch_cap = CLAUSE_BATCH + 64, batch_len = 0;
+    int64_t clause_start = 0;   /* batch index where the current clause begins */
+    int *batch = (int *)malloc(batch_cap * sizeof(int));
+    bool ok = true;
+
+    for (;;) {
+        int c = skip_space(&r);
+        if (c == EOF || c == '%') break;
+
+        if (c == 'c') {
+            skip_line(&r);
+        } else if (c == 'p') {
+            if (s) {
+                fprintf(stderr, "%s:%d: duplicate p-line\n", path, r.line);
+                ok = false;
+                break;
+            }
+            if (!parse_header(&r, &num_vars, &num_clauses)) {
+                fprintf(stderr, "%s:%d: malformed p-line\n", path, r.line);
+                ok = false;
+                break;
+            }
+            if (reuse) cdcl_reset(s = reuse, num_vars);
+            else s = cdcl_create(num_vars);
+            cdcl_reserve(s, num_clauses, estimate_literals(&r, num_vars, num_clauses));
+        } else if (c == '-' || (c >= '0' && c <= '9')) {
+            int lit;
+            if (!s) {
+                fprintf(stderr, "%s:%d: clause before 'p cnf ...' header\n",
+                        path, r.line);
+                ok = false;
+                break;
+            }
+            if (!scan_int(&r, &lit)) {
+                fprintf(stderr, "%s:%d: malformed literal\n", path, r.line);
+                ok = false;
+                break;
+            }
+            if (batch_len == batch_cap) {
+                batch_cap *= 2;
+                batch = (int *)realloc(batch, batch_cap * sizeof(int));
+            }
+            batch[batch_len++] = lit;
+            if (lit == 0) {
+                /* End of clause */
+                int len = (int)(batch_len - 1 - clause_start);
+                if (len > max_len) max_len = len;
+                clauses_read++;
+                if (batch_len >= CLAUSE_BATCH) {
+                    cdcl_add_clauses(s, batch, batch_len);
+                    batch_len = 0;
+                }
+                clause_start = batch_len;
+            } else {
+                if (lit > num_vars || -lit > num_vars) {
+                    fprintf(stderr, "%s:%d: literal %d exceeds declared %d variables\n",
+                            path, r.line, lit, num_vars);
+                    ok = false;
+                    break;
+                }
+            }
+        } else {
+            fprintf(stderr, "%s:%d: unexpected character '%c'\n", path, r.line, c);
+            ok = false;
+            break;
+        }
+    }
+
+    if (ok && !s) {
+        fprintf(stderr, "%s: no 'p cnf ...' header found\n", path);
+        ok = false;
+    }
+
+    /* Handle trailing clause without final 0 */
+    if (ok && batch_len > clause_start) {
+        int len = (int)(batch_len - clause_start);
+        if (len > max_len) max_len = len;
+        clauses_read++;
+        if (batch_len == batch_cap)
+            batch = (int *)realloc(batch, ++batch_cap * sizeof(int));
+        batch[batch_len++] = 0;
+    }
+    if (ok && batch_len > 0) cdcl_add_clauses(s, batch, batch_len);
+
+    free(batch);
+    if (reader_close(&r, path) < 0) ok = false;
+
+    if (!ok) {
+        if (s && !reuse) cdcl_destroy(s);
+        return NULL;
+    }
+
+    if (info) {
+        info->num_vars       = num_vars;
+        info->num_clauses    = num_clauses;
+        info->clauses_read   = clauses_read;
+        info->max_clause_len = max_len;
+    }
+    return s;
+}
+
+CDCLSolver *cdcl_load_dimacs(const char *path, DimacsInfo *info) {
+    return load(path, info, NULL);
+}
+
+int cdcl_load_dimacs_into(CDCLSolver *s, const char *path, DimacsInfo *info) {
+    return load(path, info, s) ? 0 : -1;
+}
@@ -0,0 +1,44 @@
+/*
+ * dimacs.h — DIMACS CNF loader for the CDCL SAT Solver
+ *
+ * Usage:
+ *   DimacsInfo info;
+ *   CDCLSolver *s = cdcl_load_dimacs("formula.cnf", &info);
+ *   if (!s) ... error already reported on stderr ...
+ *
+ * Plain files are memory-mapped and scanned in place.  Files compressed
+ * with gzip or xz (detected from their magic bytes, not the file name) are
+ * streamed through the system `gzip -dc` / `xz -dc` decompressor in large
+ * blocks, so the whole formula never has to be held in memory at once.
+ */
+
+#ifndef DIMACS_H
+#define DIMACS_H
+
+#include "CDCL.h"
+
+/* Facts about the loaded formula, for callers that need more than the solver. */
+typedef struct {
+    int num_vars;           /* variables declared in the p-line            */
+    int num_clauses;        /* clauses declared in the p-line              */
+    int clauses_read;       /* clauses actually present in the file        */
+    int max_clause_len;     /* longest clause read                         */
+} DimacsInfo;
+
+/*
+ * Parse the DIMACS file at `path`, create a solver sized from its p-line and
+ * add every clause to it.  Comment lines ("c ...") may appear anywhere,
+ * including between the literals of a clause; a SATLIB-style "%" line ends
+ * the formula.  `info` may be NULL.
+ * Returns the new solver, or NULL (with a message on stderr) on error.
+ */
+CDCLSolver *cdcl_load_dimacs(const char *path, DimacsInfo *info);
+
+/*
+ * The same into an existing solver, which is cdcl_reset() to the p-line's
+ * variable count first, so that its memory is reused.  Returns 0, or -1
+ * (with a message on stderr) on error, leaving `s` to be reset again.
+ */
+int cdcl_load_dimacs_into(CDCLSolver *s, const char *path, DimacsInfo *info);
+
+#endif /* DIMACS_H */
@@ -0,0 +1,279 @@
+/*
+ * hw_clausedb.c — Clause residency on the BCP accelerator
+ *
+ * See hw_clausedb.h.  Shared by the accelerator backends; the raw memory
+ * writes go through the backend's write_clause, write_wl_entry and
+ * write_wl_len hooks, which the drivers queue without waiting.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "CDCL.h"
+#include "bcp_backend.h"
+#include "hw_clausedb.h"
+#include "hw_trace.h"
+
+/* ── Mirror of the accelerator memories ─────────────────────────────────── */
+
+static const BCPBackend *be = NULL;    /* backend that owns the memories    */
+static CDCLSolver       *db_solver = NULL;
+
+typedef struct {
+    int  nwatch;            /* literals watched (all of the clause's) */
+    int  wlit[HW_MAX_K];    /* watched literals                       */
+    int  wpos[HW_MAX_K];    /* index of the clause in each watch list */
+} HWSlot;
+
+static CRef     slot_cref[HW_MAX_CLAUSES];  /* CREF_UNDEF for a free id */
+static HWSlot   slots[HW_MAX_CLAUSES];
+static int      slot_top = 0;          /* ids [0, slot_top) have been used  */
+static int      free_ids[HW_MAX_CLAUSES];
+static int      free_count = 0;
+static int      resident_learnts = 0;
+static int      max_clauses = HW_MAX_CLAUSES;  /* ids in use at most */
+
+static int      num_lits = 0;          /* literal codes with a watch list   */
+static uint16_t *wl = NULL;            /* wl[lit * HW_MAX_WATCH + i] = id   */
+static uint8_t  *wlen = NULL;          /* entries in each watch list        */
+
+/* Watch lists whose length changed since the last flush. */
+static int      *dirty = NULL;
+static int       dirty_count = 0;
+static bool     *is_dirty = NULL;
+
+static void mark_dirty(int lit) {
+    if (is_dirty[lit]) return;
+    is_dirty[lit] = true;
+    dirty[dirty_count++] = lit;
+}
+
+/* Send the new length of every watch list that changed. */
+static void flush_lengths(void) {
+    for (int i = 0; i < dirty_count; i++) {
+        int lit = dirty[i];
+        be->write_wl_len(lit, wlen[lit]);
+        is_dirty[lit] = false;
+    }
+    dirty_count = 0;
+}
+
+static int alloc_id(void) {
+    if (free_count > 0) return free_ids[--free_count];
+    if (slot_top < max_clauses) return slot_top++;
+    return -1;
+}
+
+/* Write clause `cr` to id `id` and watch all of its literals.  The caller
+ * has checked fits(). */
+static void attach(CDCLSolver *s, int id, CRef cr) {
+    Clause *c = cdcl_clause(s, cr);
+    int size = (int)c->size;
+
+    slot_cref[id] = cr;
+    cdcl_set_resident(s, cr, true);
+    be->write_clause(id, c->lits, size);
+    slots[id].nwatch = size;
+    for (int w = 0; w < size; w++) {
+        int lit = c->lits[w];
+        int pos = wlen[lit]++;
+        wl[lit * HW_MAX_WATCH + pos] = (uint16_t)id;
+        slots[id].wlit[w] = lit;
+        slots[id].wpos[w] = pos;
+        be->write_wl_entry(lit, pos, id);
+        mark_dirty(lit);
+    }
+}
+
+/* Unlink id `id` from its watch lists and free it. */
+static void detach(CDCLSolver *s, int id) {
+    for (int w = 0; w < slots[id].nwatch; w++) {
+        int lit  = slots[id].wlit[w];
+        int pos  = slots[id].wpos[w];
+        int last = --wlen[lit];
+        if (pos != last) {
+            /* Move the last entry into the hole. */
+            int moved = wl[lit * HW_MAX_WATCH + last];
+            wl[lit * HW_MAX_WATCH + pos] = (uint16_t)moved;
+            for (int k = 0; k < slots[moved].nwatch; k++) {
+                if (slots[moved].wlit[k] == lit && slots[moved].wpos[k] == last)
+                    slots[moved].wpos[k] = pos;
+            }
+            be->write_wl_entry(lit, pos, moved);
+        }
+        mark_dirty(lit);
+    }
+    cdcl_set_resident(s, slot_cref[id], false);
+    slot_cref[id] = CREF_UNDEF;
+    free_ids[free_count++] = id;
+}
+
+/* Whether clause `c` can be made resident: it has 2..HW_MAX_K distinct
+ * literals, all within the accelerator's variable range, and each of their
+ * watch lists has room.  Anything else stays in software. */
+static bool fits(Clause *c) {
+    if (c->size < 2 || c->size > HW_MAX_K) return false;
+    for (int k = 0; k < (int)c->size; k++) {
+        int lit = c->lits[k];
+        if (lit >= num_lits || wlen[lit] >= HW_MAX_WATCH) return false;
+        for (int m = 0; m < k; m++) {
+            if (c->lits[m] == lit) return false;
+        }
+    }
+    return true;
+}
+
+/* ── Eviction ───────────────────────────────────────────────────────────── */
+
+typedef struct {
+    int      id;
+    uint32_t lbd;
+    float    activity;
+} EvictRank;
+
+/* Worst first: higher LBD, then lower activity (as in reduce_db()). */
+static int evict_rank_cmp(const void *a, const void *b) {
+    const EvictRank *x = (const EvictRank *)a;
+    const EvictRank *y = (const EvictRank *)b;
+    if (x->lbd != y->lbd) return (x->lbd > y->lbd) ? -1 : 1;
+    if (x->activity != y->activity) return (x->activity < y->activity) ? -1 : 1;
+    return 0;
+}
+
+/* Evict the worst half of the resident learnt clauses.  Only clauses with
+ * two literals that are not false can go back to software (cdcl_rewatch());
+ * the others are passed over. */
+static void evict_learnts(CDCLSolver *s) {
+    EvictRank *cand = (EvictRank *)malloc((resident_learnts + 1) * sizeof(EvictRank));
+    int n = 0;
+    for (int id = 0; id < slot_top; id++) {
+        if (slot_cref[id] == CREF_UNDEF) continue;
+        Clause *c = cdcl_clause(s, slot_cref[id]);
+        if (!c->learnt) continue;
+        cand[n].id       = id;
+        cand[n].lbd      = c->lbd;
+        cand[n].activity = c->activity;
+        n++;
+    }
+    qsort(cand, n, sizeof(EvictRank), evict_rank_cmp);
+
+    int target = (n + 1) / 2;
+    int evicted = 0;
+    for (int i = 0; i < n && evicted < target; i++) {
+        if (!cdcl_rewatch(s, slot_cref[cand[i].id])) continue;
+        detach(s, cand[i].id);
+        evicted++;
+    }
+    resident_learnts -= evicted;
+    free(cand);
+
+    HW_TRACE(HW_TRACE_EVENT, "[HW_DB] evicted %d learnt clauses, %d resident\n",
+             evicted, resident_learnts);
+}
+
+/* ── Public API ─────────────────────────────────────────────────────────── */
+
+void hw_db_init(CDCLSolver *s, const BCPBackend *backend) {
+    hw_db_free();
+    be        = backend;
+    db_solver = s;
+    /* Literal codes of variables the accelerator cannot hold get no watch
+     * list; fits() keeps their clauses in software. */
+    num_lits = 2 * s->num_vars + 2;
+    if (num_lits > 2 * HW_MAX_VARS) num_lits = 2 * HW_MAX_VARS;
+    wl       = (uint16_t *)malloc((size_t)num_lits * HW_MAX_WATCH * sizeof(uint16_t));
+    wlen     = (uint8_t *)calloc(num_lits, sizeof(uint8_t));
+    dirty    = (int *)malloc(num_lits * sizeof(int));
+    is_dirty = (bool *)calloc(num_lits, sizeof(bool));
+    slot_top = free_count = resident_learnts = dirty_count = 0;
+
+    /* Clear residency left over from an earlier solve. */
+    for (int ci = 0; ci < s->clause_count; ci++) {
+        if (cdcl_clause(s, s->clauses[ci])->hw)
+            cdcl_set_resident(s, s->clauses[ci], false);
+    }
+
+    for (int ci = 0; ci < s->clause_count; ci++) {
+        Clause *c = cdcl_clause(s, s->clauses[ci]);
+        if (!fits(c)) continue;
+        int id = alloc_id();
+        if (id < 0) break;
+        attach(s, id, s->clauses[ci]);
+        if (c->learnt) resident_learnts++;
+    }
+    flush_lengths();
+
+    HW_TRACE(HW_TRACE_EVENT, "[HW_DB] %d of %d clauses resident\n",
+             slot_top, s->clause_count);
+}
+
+void hw_db_free(void) {
+    /* Hand every resident clause back to software. */
+    if (db_solver) {
+        for (int id = 0; id < slot_top; id++) {
+            if (slot_cref[id] != CREF_UNDEF)
+                cdcl_set_resident(db_solver, slot_cref[id], false);
+        }
+        db_solver = NULL;
+    }
+    slot_top = 0;
+    free(wl);
+    free(wlen);
+    free(dirty);
+    free(is_dirty);
+    wl = NULL;
+    wlen = NULL;
+    dirty = NULL;
+    is_dirty = NULL;
+}
+
+void hw_db_add_learnt(CDCLSolver *s, CRef cr) {
+    Clause *c = cdcl_clause(s, cr);
+    if (!fits(c)) return;
+
+    int id = alloc_id();
+    if (id < 0) {
+        evict_learnts(s);
+        id = alloc_id();
+        if (id < 0) return;  /* no learnt clause was resident */
+    }
+    attach(s, id, cr);
+    resident_learnts++;
+    flush_lengths();
+}
+
+void hw_db_drop_deleted(CDCLSolver *s) {
+    int dropped = 0;
+    for (int id = 0; id < slot_top; id++) {
+        if (slot_cref[id] == CREF_UNDEF) continue;
+        Clause *c = cdcl_clause(s, slot_cref[id]);
+        if (!c->deleted) continue;
+        if (c->learnt) resident_learnts--;
+        detach(s, id);
+        dropped++;
+    }
+    flush_lengths();
+
+    HW_TRACE(HW_TRACE_EVENT, "[HW_DB] dropped %d deleted clauses, %d learnt resident\n",
+             dropped, resident_learnts);
+}
+
+void hw_db_set_capacity(int n) {
+    max_clauses = (n > 0 && n < HW_MAX_CLAUSES) ? n : HW_MAX_CLAUSES;
+}
+
+bool hw_db_watched(int lit) {
+    return lit < num_lits && wlen[lit] > 0;
+}
+
+CRef hw_db_cref(int id) {
+    if (id < 0 || id >= slot_top) return CREF_UNDEF;
+    return slot_cref[id];
+}
+
+CRef *hw_db_refs(int *count) {
+    *count = slot_top;
+    return slot_cref;
+}
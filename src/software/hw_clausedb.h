@@ -0,0 +1,81 @@
+/*
+ * hw_clausedb.h — Clause residency on the BCP accelerator
+ *
+ * The accelerator's clause memory and watch lists are mirrored on the host
+ * so that changes can be sent as deltas: a learnt clause is written to a
+ * free hardware clause id and appended to the watch lists of all of its
+ * literals; a deleted clause is unlinked from its watch lists by moving the
+ * last entry of each list into its place.  Only the watch-list lengths that
+ * changed are rewritten, once per update.
+ *
+ * Hardware clause ids no longer equal positions in s->clauses, so reasons
+ * and conflicts reported by the accelerator are translated with
+ * hw_db_cref().
+ *
+ * The accelerator's watch lists are static: it never moves a watch to
+ * another literal.  Watching every literal instead of two makes its BCP
+ * complete for the clauses it holds, since each clause is evaluated
+ * whenever one of its literals becomes false.
+ *
+ * Residency policy: a clause is resident only if it fits as it is, with
+ * 2..HW_MAX_K literals over variables below HW_MAX_VARS and room left in
+ * each of their watch lists.  Clauses are never truncated; those that do
+ * not fit stay with the software propagate(), which skips resident
+ * clauses (the `hw` header bit, and BIN_RESIDENT in the implication list
+ * entries of binary clauses; see cdcl_set_resident()).  Original clauses
+ * are uploaded first and stay resident.  Learnt clauses are uploaded as
+ * they are learnt.  When all HW_MAX_CLAUSES ids are taken, the worst half of the resident learnt
+ * clauses (highest LBD, then lowest activity, the order reduce_db() uses)
+ * is evicted in one batch and goes back to software.  Software left the
+ * watches of a resident clause alone, so an evicted clause first gets two
+ * literals that are not false to watch (cdcl_rewatch()); one that has
+ * fewer is unit or conflicting below the current level and stays resident.
+ * On close every clause goes back, and the solver propagates the level-0
+ * facts again at the next solve for the same reason.
+ */
+
+#ifndef HW_CLAUSEDB_H
+#define HW_CLAUSEDB_H
+
+#include "CDCL.h"
+
+/* Accelerator capacities (see src/hardware/memory/). */
+#define HW_MAX_VARS    512   /* AssignmentMemory depth (ids 1..511)    */
+#define HW_MAX_LEVELS  512   /* decision levels on the hardware trail  */
+#define HW_MAX_CLAUSES 8192  /* ClauseMemory depth                     */
+#define HW_MAX_K       5     /* literals per hardware clause           */
+#define HW_MAX_WATCH   100   /* WatchListMemory entries per literal    */
+
+/* Reset the mirror and upload the solver's clauses through `backend`'s
+ * memory write hooks.  Called by the backend's init hook. */
+void hw_db_init(CDCLSolver *s, const BCPBackend *backend);
+
+/* Release the mirror and mark every resident clause non-resident.
+ * Called by the backend's close hook. */
+void hw_db_free(void);
+
+/* Make a newly learnt clause resident, if the policy allows it. */
+void hw_db_add_learnt(CDCLSolver *s, CRef cr);
+
+/* Unlink every resident clause that has been marked deleted.  Must run
+ * after reduce_db() and before the garbage collector. */
+void hw_db_drop_deleted(CDCLSolver *s);
+
+/* Use at most `n` clause ids (0 or more than HW_MAX_CLAUSES: all), for a
+ * ClauseMemory built smaller and for tests.  Takes effect at the next
+ * hw_db_init(). */
+void hw_db_set_capacity(int n);
+
+/* Whether any resident clause contains literal `lit`.  A literal that
+ * becomes false needs no accelerator round otherwise. */
+bool hw_db_watched(int lit);
+
+/* Clause reference of hardware clause `id`. */
+CRef hw_db_cref(int id);
+
+/* References of the resident clauses, indexed by hardware clause id
+ * (CREF_UNDEF for free ids).  The garbage collector rewrites them in
+ * place.  `*count` is set to the number of entries. */
+CRef *hw_db_refs(int *count);
+
+#endif /* HW_CLAUSEDB_H */
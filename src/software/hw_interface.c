@@ -11,15 +11,35 @@
  *   0x03 WRITE_WL_LEN   [lit:2][len:1]                             3 bytes
  *   0x04 WRITE_ASSIGN   [var:2][val:1]                             3 bytes
  *   0x05 BCP_START      [false_lit:2]                              2 bytes
+ *   0x06 RESET_STATE    (none; restarts the frame count)           0 bytes
+ *   0x09 FRAME          [seq:1][len:1][records:len][crc:2]     len+4 bytes
  *
  * Protocol (FPGA → Host):
- *   0xB0 [var:2][val:1][reason:2]  — implication  (6 bytes)
+ *   0xB0 [var:2][val:1][reason:2]  — implication  (6 bytes, val 1=TRUE)
  *   0xC0 [clause_id:2][0x00]       — done, no conflict (4 bytes)
  *   0xC1 [clause_id:2][0x00]       — done, conflict    (4 bytes)
+ *   0xA0 [seq:1]                   — frame accepted
+ *   0xA1 [seq:1]                   — resend frames from seq
+ *
+ * The accelerator writes every implied value into its own assignment
+ * memory, so implications are not echoed back with WRITE_ASSIGN.
+ *
+ * Writes are not sent one command at a time.  Clause, watch list and
+ * assignment writes are packed as records into FRAMEs of up to FRAME_MAX
+ * bytes with a CRC-16; up to FRAME_WINDOW frames may be unacknowledged,
+ * and closed frames go out with one writev() when the window fills or when
+ * a plain command (BCP_START) needs an answer.  A NAK or a timeout resends
+ * every unacknowledged frame (go-back-N), together with the BCP_START the
+ * FPGA dropped while it was out of sync.  BCP results themselves are not
+ * CRC-protected.
+ *
+ * The port argument is the serial device, optionally followed by @baud
+ * (default 1000000, at most 12000000, the FTDI high-speed limit); the
+ * bitstream must be built for the same rate (top.py).
+ *
+ * Exported as the "uart" BCP backend (bcp_backend.h).
  */
 
-#ifdef USE_HW_BCP
-
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -28,12 +48,15 @@
 #include <errno.h>
 #include <termios.h>
 #include <sys/ioctl.h>
+#include <sys/uio.h>
 #ifdef __APPLE__
 #include <IOKit/serial/ioss.h>
 #endif
 
 #include "CDCL.h"
-#include "hw_interface.h"
+#include "bcp_backend.h"
+#include "hw_clausedb.h"
+#include "hw_trace.h"
 
 /* ── Command bytes ──────────────────────────────────────────────────────── */
 #define CMD_WRITE_CLAUSE   0x01
@@ -41,11 +64,15 @@
 #define CMD_WRITE_WL_LEN   0x03
 #define CMD_WRITE_ASSIGN   0x04
 #define CMD_BCP_START      0x05
+#define CMD_RESET_STATE    0x06
+#define CMD_FRAME          0x09
 
 /* ── Response bytes ─────────────────────────────────────────────────────── */
 #define RSP_IMPLICATION    0xB0
 #define RSP_DONE_OK        0xC0
 #define RSP_DONE_CONFLICT  0xC1
+#define RSP_FRAME_ACK      0xA0
+#define RSP_FRAME_NAK      0xA1
 
 /* ── Hardware assignment encoding ───────────────────────────────────────── */
 /* Software: -1=UNASSIGNED, 0=FALSE, 1=TRUE                                */
@@ -54,11 +81,15 @@
 #define HW_FALSE      1
 #define HW_TRUE       2
 
-/* Default serial port */
+/* Default serial port and baud rate */
 #define DEFAULT_PORT "/dev/cu.usbserial-000000"
+#define DEFAULT_BAUD 1000000
+#define MAX_BAUD     12000000
 
-/* ── Global port path (set by main before cdcl_solve) ──────────────────── */
-const char *hw_port = NULL;
+/* Framing */
+#define FRAME_MAX     255  /* record bytes per frame                      */
+#define FRAME_WINDOW  8    /* frames in flight without an ACK             */
+#define RX_TIMEOUT_DS 10   /* silence (deciseconds) before resending      */
 
 /* ── Static state ───────────────────────────────────────────────────────── */
 static int serial_fd = -1;
@@ -79,23 +110,33 @@ static inline int hw_to_sw_assign(unsigned char val) {
 
 /* ── Serial I/O helpers ─────────────────────────────────────────────────── */
 
-static int send_bytes(const unsigned char *buf, int len) {
-    int total = 0;
-    while (total < len) {
-        int n = (int)write(serial_fd, buf + total, len - total);
+/* Write every iovec in full, advancing through partial writes. */
+static int send_iov(struct iovec *iov, int count) {
+    bcp_hw_scans++;
+    while (count > 0) {
+        ssize_t n = writev(serial_fd, iov, count);
         if (n < 0) {
             if (errno == EINTR) continue;
-            perror("hw_interface: write");
+            perror("hw_interface: writev");
             return -1;
         }
-        total += n;
+        while (count > 0 && (size_t)n >= iov->iov_len) {
+            n -= (ssize_t)iov->iov_len;
+            iov++;
+            count--;
+        }
+        if (count > 0) {
+            iov->iov_base = (char *)iov->iov_base + n;
+            iov->iov_len -= (size_t)n;
+        }
     }
-    tcdrain(serial_fd);
     return 0;
 }
 
+/* Read exactly `len` bytes.  Returns 0, -1 on error, or 1 if the line was
+ * silent for RX_TIMEOUT_DS deciseconds (each read() waits VTIME). */
 static int recv_bytes(unsigned char *buf, int len) {
-    int total = 0;
+    int total = 0, idle = 0;
     while (total < len) {
         int n = (int)read(serial_fd, buf + total, len - total);
         if (n < 0) {
@@ -104,26 +145,211 @@ static int recv_bytes(unsigned char *buf, int len) {
             return -1;
         }
         if (n == 0) {
-            /* Timeout with no data — retry */
+            /* Timeout with no data */
+            if (++idle == RX_TIMEOUT_DS) return 1;
             continue;
         }
+        idle = 0;
         total += n;
     }
     return 0;
 }
 
+/* ── Frames ─────────────────────────────────────────────────────────────── */
+
+typedef struct {
+    int           len;                   /* bytes in buf                     */
+    unsigned char buf[5 + FRAME_MAX];    /* CMD_FRAME seq len records crc:2  */
+} Frame;
+
+/* Ring of frames by seq: [acked_seq, sent_seq) are sent and unacknowledged,
+ * [sent_seq, next_seq) closed and queued, next_seq is being filled. */
+static Frame         window[FRAME_WINDOW];
+static unsigned char acked_seq, sent_seq, next_seq;
+static int           cur_len = -1;       /* records in the open frame, or -1 */
+
+static inline Frame *frame_slot(unsigned char seq) {
+    return &window[seq % FRAME_WINDOW];
+}
+
+static inline int frames_between(unsigned char from, unsigned char to) {
+    return (unsigned char)(to - from);
+}
+
+static unsigned short crc16(const unsigned char *p, int len) {
+    /* CRC-16/CCITT-FALSE, as host_interface.py */
+    unsigned short crc = 0xFFFF;
+    while (len--) {
+        crc ^= (unsigned short)(*p++ << 8);
+        for (int i = 0; i < 8; i++)
+            crc = (crc & 0x8000) ? (unsigned short)((crc << 1) ^ 0x1021)
+                                 : (unsigned short)(crc << 1);
+    }
+    return crc;
+}
+
+/* Seal the open frame (possibly empty) so it can be sent. */
+static void frame_close(void) {
+    if (cur_len < 0) cur_len = 0;
+    Frame *f = frame_slot(next_seq);
+    f->buf[0] = CMD_FRAME;
+    f->buf[1] = next_seq;
+    f->buf[2] = (unsigned char)cur_len;
+    unsigned short crc = crc16(f->buf + 1, 2 + cur_len);
+    f->buf[3 + cur_len] = (unsigned char)(crc >> 8);
+    f->buf[4 + cur_len] = (unsigned char)crc;
+    f->len = 5 + cur_len;
+    next_seq++;
+    cur_len = -1;
+}
+
+/* Send the closed frames from `from` to next_seq, then `cmd` if non-NULL,
+ * in one writev(). */
+static int send_frames(unsigned char from, const unsigned char *cmd, int cmd_len) {
+    struct iovec iov[FRAME_WINDOW + 1];
+    int count = 0;
+    for (unsigned char seq = from; seq != next_seq; seq++) {
+        Frame *f = frame_slot(seq);
+        HW_TRACE(HW_TRACE_SCAN, "[UART TX] FRAME seq=%u len=%d\n", seq, f->len - 5);
+        HW_TRACE_RECORD(HW_TRACE_TX, f->buf, f->len < 16 ? f->len : 16);
+        iov[count].iov_base = f->buf;
+        iov[count].iov_len  = (size_t)f->len;
+        count++;
+    }
+    if (cmd) {
+        HW_TRACE_RECORD(HW_TRACE_TX, cmd, cmd_len);
+        iov[count].iov_base = (void *)cmd;
+        iov[count].iov_len  = (size_t)cmd_len;
+        count++;
+    }
+    sent_seq = next_seq;
+    return send_iov(iov, count);
+}
+
+/* Handle an ACK or NAK.  Returns 1 if frames had to be resent. */
+static int frame_reply(unsigned char code, unsigned char seq) {
+    if (code == RSP_FRAME_ACK) {
+        HW_TRACE(HW_TRACE_SCAN, "[UART RX] ACK seq=%u\n", seq);
+        /* Frames are accepted in order, so an ACK also covers every frame
+         * before it whose ACK was lost. */
+        if (frames_between(acked_seq, seq) < frames_between(acked_seq, sent_seq))
+            acked_seq = (unsigned char)(seq + 1);
+        return 0;
+    }
+    HW_TRACE(HW_TRACE_EVENT, "[UART RX] NAK seq=%u (acked %u, sent %u)\n",
+             seq, acked_seq, sent_seq);
+    if (frames_between(acked_seq, seq) <= frames_between(acked_seq, sent_seq))
+        acked_seq = seq;  /* the FPGA has everything before seq */
+    return 1;
+}
+
+/* Resend every unacknowledged frame (an empty one to resynchronise if there
+ * is none), then `cmd`. */
+static int resend(const unsigned char *cmd, int cmd_len) {
+    if (acked_seq == next_seq) frame_close();
+    return send_frames(acked_seq, cmd, cmd_len);
+}
+
+/* Wait until at most `max_in_flight` frames are unacknowledged. */
+static int wait_acks(int max_in_flight) {
+    unsigned char resp[2];
+    while (frames_between(acked_seq, sent_seq) > max_in_flight) {
+        int rc = recv_bytes(resp, 1);
+        if (rc == 0) {
+            if (resp[0] != RSP_FRAME_ACK && resp[0] != RSP_FRAME_NAK) {
+                fprintf(stderr, "hw_interface: unexpected response byte 0x%02X "
+                        "while waiting for a frame ACK\n", resp[0]);
+                hw_trace_dump(stderr);
+                return -1;
+            }
+            rc = recv_bytes(resp + 1, 1);
+        }
+        if (rc < 0) return -1;
+        if (rc == 1 || frame_reply(resp[0], resp[1])) {
+            if (rc == 1) HW_TRACE(HW_TRACE_EVENT, "[UART] ACK timeout, resending\n");
+            if (resend(NULL, 0) < 0) return -1;
+        }
+    }
+    return 0;
+}
+
+/* Append one write command to the open frame. */
+static void frame_put(unsigned char cmd, const unsigned char *payload, int len) {
+    if (cur_len >= 0 && cur_len + 1 + len > FRAME_MAX) frame_close();
+    if (cur_len < 0) {
+        /* The slot for next_seq must not hold an unacknowledged frame. */
+        if (frames_between(acked_seq, next_seq) >= FRAME_WINDOW) {
+            if (send_frames(sent_seq, NULL, 0) < 0) return;
+            if (wait_acks(FRAME_WINDOW - 1) < 0) return;
+        }
+        cur_len = 0;
+    }
+    Frame *f = frame_slot(next_seq);
+    f->buf[3 + cur_len] = cmd;
+    memcpy(f->buf + 4 + cur_len, payload, len);
+    cur_len += 1 + len;
+}
+
+/* Send a plain command after everything queued before it. */
 static int send_cmd(unsigned char cmd, const unsigned char *payload, int payload_len) {
-    if (send_bytes(&cmd, 1) < 0) return -1;
-    if (payload_len > 0 && send_bytes(payload, payload_len) < 0) return -1;
+    unsigned char msg[16];
+    msg[0] = cmd;
+    memcpy(msg + 1, payload, payload_len);
+    if (cur_len > 0) frame_close();
+    return send_frames(sent_seq, msg, 1 + payload_len);
+}
+
+/* Set the line rate.  FTDI parts take any rate their divider can make;
+ * termios only has a few of them outside macOS. */
+static int set_baud(struct termios *tty, long baud) {
+#ifdef __APPLE__
+    /* Placeholder for tcsetattr; macOS sets the real rate with IOSSIOSPEED
+     * below (FTDI doesn't support non-standard rates through cfsetspeed) */
+    (void)baud;
+    cfsetispeed(tty, B115200);
+    cfsetospeed(tty, B115200);
     return 0;
+#else
+    static const struct { long baud; speed_t code; } rates[] = {
+        { 115200, B115200 }, { 230400, B230400 },
+#ifdef B1000000
+        { 1000000, B1000000 }, { 1500000, B1500000 }, { 2000000, B2000000 },
+        { 2500000, B2500000 }, { 3000000, B3000000 }, { 3500000, B3500000 },
+        { 4000000, B4000000 },
+#endif
+    };
+    for (size_t i = 0; i < sizeof(rates) / sizeof(rates[0]); i++) {
+        if (rates[i].baud == baud) {
+            cfsetispeed(tty, rates[i].code);
+            cfsetospeed(tty, rates[i].code);
+            return 0;
+        }
+    }
+    fprintf(stderr, "hw_interface: %ld baud is not supported on this system\n", baud);
+    return -1;
+#endif
 }
 
-/* ── Public API ─────────────────────────────────────────────────────────── */
+/* ── Backend hooks ──────────────────────────────────────────────────────── */
 
-int hw_open(const char *port) {
+static int uart_open(const char *port) {
+    char path[256];
+    long baud = DEFAULT_BAUD;
     if (port == NULL) port = DEFAULT_PORT;
 
-    serial_fd = open(port, O_RDWR | O_NOCTTY | O_NONBLOCK);
+    /* device[@baud] */
+    snprintf(path, sizeof(path), "%s", port);
+    char *at = strrchr(path, '@');
+    if (at) {
+        *at = '\0';
+        baud = strtol(at + 1, NULL, 10);
+        if (baud <= 0 || baud > MAX_BAUD) {
+            fprintf(stderr, "hw_interface: baud rate must be 1..%d\n", MAX_BAUD);
+            return -1;
+        }
+    }
+
+    serial_fd = open(path, O_RDWR | O_NOCTTY | O_NONBLOCK);
     if (serial_fd < 0) {
         perror("hw_interface: open");
         return -1;
@@ -148,9 +374,11 @@ int hw_open(const char *port) {
     tty.c_cflag &= ~(CSTOPB | CRTSCTS);
     tty.c_cflag |= CS8 | CLOCAL | CREAD;
 
-    /* Set a placeholder baud rate for tcsetattr (will override below on macOS) */
-    cfsetispeed(&tty, B115200);
-    cfsetospeed(&tty, B115200);
+    if (set_baud(&tty, baud) < 0) {
+        close(serial_fd);
+        serial_fd = -1;
+        return -1;
+    }
 
     /* Non-blocking reads with 100ms timeout */
     tty.c_cc[VMIN]  = 0;
@@ -164,9 +392,9 @@ int hw_open(const char *port) {
     }
 
 #ifdef __APPLE__
-    /* macOS: set 1 Mbaud via IOSSIOSPEED ioctl (FTDI doesn't support
+    /* macOS: set the rate via IOSSIOSPEED ioctl (FTDI doesn't support
      * non-standard rates through cfsetspeed/tcsetattr) */
-    speed_t speed = 1000000;
+    speed_t speed = (speed_t)baud;
     if (ioctl(serial_fd, IOSSIOSPEED, &speed) < 0) {
         perror("hw_interface: IOSSIOSPEED");
         close(serial_fd);
@@ -178,106 +406,125 @@ int hw_open(const char *port) {
     /* Flush any stale data */
     tcflush(serial_fd, TCIOFLUSH);
 
+    /* Restart the frame count on both sides */
+    acked_seq = sent_seq = next_seq = 0;
+    cur_len = -1;
+    if (send_cmd(CMD_RESET_STATE, NULL, 0) < 0) {
+        close(serial_fd);
+        serial_fd = -1;
+        return -1;
+    }
     return 0;
 }
 
-void hw_close(void) {
+static void uart_close(void) {
     if (serial_fd >= 0) {
+        /* Let the last frames land before the port goes away. */
+        if (cur_len > 0) frame_close();
+        if (send_frames(sent_seq, NULL, 0) == 0) wait_acks(0);
         close(serial_fd);
         serial_fd = -1;
     }
+    hw_db_free();
 }
 
-void hw_init(CDCLSolver *s) {
-    unsigned char payload[14];
-
-    /* 1. Upload clauses */
-    for (int ci = 0; ci < s->clause_count; ci++) {
-        Clause *c = s->clauses[ci];
-        int size = c->size;
-        if (size > 5) size = 5;  /* hardware supports max 5 literals */
-
-        /* clause_id big-endian */
-        payload[0] = (ci >> 8) & 0xFF;
-        payload[1] = ci & 0xFF;
-        /* size */
-        payload[2] = (unsigned char)size;
-        /* sat bit (0 at init) */
-        payload[3] = 0;
-        /* literals 0..4, big-endian 2 bytes each */
-        for (int k = 0; k < 5; k++) {
-            int lit = (k < size) ? c->lits[k] : 0;
-            payload[4 + k * 2]     = (lit >> 8) & 0xFF;
-            payload[4 + k * 2 + 1] = lit & 0xFF;
-        }
-        send_cmd(CMD_WRITE_CLAUSE, payload, 14);
-    }
+static void uart_init(CDCLSolver *s) {
+    unsigned char payload[3];
 
-    /* 2. Upload watch lists */
-    int num_lits = 2 * s->num_vars + 2;
-    for (int lit = 0; lit < num_lits; lit++) {
-        int wlen = s->watch_size[lit];
-        if (wlen == 0) continue;
-
-        /* Send watch list length */
-        payload[0] = (lit >> 8) & 0xFF;
-        payload[1] = lit & 0xFF;
-        payload[2] = (unsigned char)wlen;
-        send_cmd(CMD_WRITE_WL_LEN, payload, 3);
-
-        /* Send each watch entry */
-        for (int j = 0; j < wlen; j++) {
-            int clause_id = s->watches[lit][j];
-            payload[0] = (lit >> 8) & 0xFF;
-            payload[1] = lit & 0xFF;
-            payload[2] = (unsigned char)j;
-            payload[3] = (clause_id >> 8) & 0xFF;
-            payload[4] = clause_id & 0xFF;
-            send_cmd(CMD_WRITE_WL_ENTRY, payload, 5);
-        }
-    }
+    /* 1. Upload clauses and watch lists */
+    hw_db_init(s, &bcp_backend_uart);
 
-    /* 3. Upload variable assignments */
-    for (int var = 1; var <= s->num_vars; var++) {
+    /* 2. Upload variable assignments */
+    for (int var = 1; var <= s->num_vars && var < HW_MAX_VARS; var++) {
         payload[0] = (var >> 8) & 0xFF;
         payload[1] = var & 0xFF;
-        payload[2] = sw_to_hw_assign(s->assigns[var]);
-        send_cmd(CMD_WRITE_ASSIGN, payload, 3);
+        payload[2] = sw_to_hw_assign(cdcl_var_value(s, var));
+        frame_put(CMD_WRITE_ASSIGN, payload, 3);
+    }
+}
+
+static void uart_write_clause(int id, const int *lits, int size) {
+    unsigned char payload[14];
+    /* clause_id big-endian */
+    payload[0] = (id >> 8) & 0xFF;
+    payload[1] = id & 0xFF;
+    /* size */
+    payload[2] = (unsigned char)size;
+    /* sat bit (0 at init) */
+    payload[3] = 0;
+    /* literals 0..4, big-endian 2 bytes each */
+    for (int k = 0; k < 5; k++) {
+        int lit = (k < size) ? lits[k] : 0;
+        payload[4 + k * 2]     = (lit >> 8) & 0xFF;
+        payload[4 + k * 2 + 1] = lit & 0xFF;
     }
+    frame_put(CMD_WRITE_CLAUSE, payload, 14);
 }
 
-void hw_write_assign(int var, int val) {
+static void uart_write_wl_entry(int lit, int idx, int id) {
+    unsigned char payload[5];
+    payload[0] = (lit >> 8) & 0xFF;
+    payload[1] = lit & 0xFF;
+    payload[2] = (unsigned char)idx;
+    payload[3] = (id >> 8) & 0xFF;
+    payload[4] = id & 0xFF;
+    frame_put(CMD_WRITE_WL_ENTRY, payload, 5);
+}
+
+static void uart_write_wl_len(int lit, int len) {
     unsigned char payload[3];
+    payload[0] = (lit >> 8) & 0xFF;
+    payload[1] = lit & 0xFF;
+    payload[2] = (unsigned char)len;
+    frame_put(CMD_WRITE_WL_LEN, payload, 3);
+}
+
+static void uart_assign(int var, int val, bool decision) {
+    /* The UART protocol has no decision levels. */
+    unsigned char payload[3];
+    (void)decision;
+    if (var >= HW_MAX_VARS) return;  /* beyond the accelerator's range */
     payload[0] = (var >> 8) & 0xFF;
     payload[1] = var & 0xFF;
     payload[2] = sw_to_hw_assign(val);
-    send_cmd(CMD_WRITE_ASSIGN, payload, 3);
+    frame_put(CMD_WRITE_ASSIGN, payload, 3);
 }
 
-void hw_sync_assigns(CDCLSolver *s, int from_level) {
-    /* After backtracking, any variable no longer on the trail should be
-     * marked UNASSIGNED on the FPGA.  We just re-send the current state
-     * for all variables — the solver has already unassigned them. */
-    for (int var = 1; var <= s->num_vars; var++) {
-        if (s->assigns[var] == UNASSIGNED) {
-            hw_write_assign(var, UNASSIGNED);
-        }
-    }
+static void uart_sync(CDCLSolver *s, int from_level) {
+    /* Unassign exactly the variables the backtrack popped; everything
+     * else on the FPGA already matches the solver. */
+    (void)from_level;
+    for (int t = s->trail_size; t < s->trail_popped; t++)
+        uart_assign(s->trail[t] >> 1, UNASSIGNED, false);
 }
 
-int hw_propagate(CDCLSolver *s) {
+/* Variables whose hardware value an implication overwrote with the opposite
+ * of the solver's value; rewritten once the BCP round is over. */
+static int *restore_vars = NULL;
+static int  restore_count = 0, restore_cap = 0;
+
+static CRef uart_propagate(CDCLSolver *s) {
     unsigned char payload[2];
     unsigned char resp[6];
 
-    while (s->prop_head < s->trail_size) {
+    while (s->hw_head < s->trail_size) {
         /* The literal that just became true — watch list of its negation */
-        int true_lit = s->trail[s->prop_head];
+        int true_lit = s->trail[s->hw_head];
         int false_lit = true_lit ^ 1;
 
+        /* No resident clause contains false_lit: nothing to evaluate. */
+        if (!hw_db_watched(false_lit)) {
+            s->hw_head++;
+            continue;
+        }
+
         /* Send BCP_START with false_lit (big-endian) */
         payload[0] = (false_lit >> 8) & 0xFF;
         payload[1] = false_lit & 0xFF;
+        HW_TRACE(HW_TRACE_EVENT, "[HW_PROP] BCP_START false_lit=%d (true_lit=%d, var=%d)\n",
+                 false_lit, true_lit, true_lit / 2);
         send_cmd(CMD_BCP_START, payload, 2);
+        const unsigned char bcp_cmd[3] = { CMD_BCP_START, payload[0], payload[1] };
 
         /* Read response packets */
         int conflict_ci = -1;
@@ -285,68 +532,117 @@ int hw_propagate(CDCLSolver *s) {
 
         while (!done) {
             /* Read response type byte */
-            if (recv_bytes(resp, 1) < 0) return -1;
+            int rc = recv_bytes(resp, 1);
+            if (rc < 0) return CREF_ERROR;
+            if (rc == 1) {
+                /* BCP_START or a frame before it was lost */
+                HW_TRACE(HW_TRACE_EVENT, "[HW_PROP] timeout, resending BCP_START\n");
+                if (resend(bcp_cmd, 3) < 0) return CREF_ERROR;
+                continue;
+            }
 
             switch (resp[0]) {
+            case RSP_FRAME_ACK:
+            case RSP_FRAME_NAK: {
+                if (recv_bytes(resp + 1, 1) != 0) return CREF_ERROR;
+                /* A NAK for a frame sent before BCP_START means the FPGA
+                 * dropped the BCP_START too.  Any other NAK is left to the
+                 * timeout: the round may be running. */
+                bool behind = acked_seq != sent_seq;
+                if (frame_reply(resp[0], resp[1]) && behind &&
+                    resend(bcp_cmd, 3) < 0)
+                    return CREF_ERROR;
+                break;
+            }
             case RSP_IMPLICATION: {
                 /* Read 5 more bytes: var(2) + val(1) + reason(2) */
-                if (recv_bytes(resp + 1, 5) < 0) return -1;
+                if (recv_bytes(resp + 1, 5) != 0) return CREF_ERROR;
+                HW_TRACE_RECORD(HW_TRACE_RX, resp, 6);
 
                 int var    = (resp[1] << 8) | resp[2];
-                int hw_val = resp[3];
+                int val    = resp[3] ? 1 : 0;   /* the implied value bit, not HW_TRUE */
                 int reason = (resp[4] << 8) | resp[5];
 
-                /* Convert hardware value to literal code:
-                 * HW_TRUE (2) → positive lit = 2*var (even)
-                 * HW_FALSE (1) → negative lit = 2*var+1 (odd) */
-                int code;
-                if (hw_val == HW_TRUE)
-                    code = 2 * var;       /* assign TRUE → even code */
-                else
-                    code = 2 * var + 1;   /* assign FALSE → odd code */
-
-                /* Enqueue into the solver */
-                s->assigns[var] = (code & 1) ? 0 : 1;
-                s->levels[var]  = s->num_decisions;
-                s->reasons[var] = reason;
-                s->trail[s->trail_size++] = code;
-
-                /* Also sync this new assignment to the FPGA so subsequent
-                 * BCP rounds see it */
-                hw_write_assign(var, s->assigns[var]);
+                HW_TRACE(HW_TRACE_EVENT, "[HW_PROP] IMPL: var=%d val=%d reason=%d\n",
+                         var, val, reason);
+
+                if (cdcl_var_value(s, var) == UNASSIGNED) {
+                    /* Enqueue into the solver: TRUE → even code, FALSE → odd */
+                    cdcl_imply(s, var, val, hw_db_cref(reason));
+                } else if (cdcl_var_value(s, var) != val) {
+                    /* The reason clause is falsified.  Keep reading: the
+                     * rest of the stream must be consumed either way. */
+                    if (conflict_ci < 0) conflict_ci = reason;
+                    if (restore_count == restore_cap) {
+                        restore_cap = restore_cap ? 2 * restore_cap : 16;
+                        restore_vars = (int *)realloc(restore_vars,
+                                                      restore_cap * sizeof(int));
+                    }
+                    restore_vars[restore_count++] = var;
+                }
+                /* else: implied twice in one round */
                 break;
             }
             case RSP_DONE_OK:
                 /* Read 3 more bytes: clause_id(2) + padding(1) */
-                if (recv_bytes(resp + 1, 3) < 0) return -1;
+                if (recv_bytes(resp + 1, 3) != 0) return CREF_ERROR;
+                HW_TRACE_RECORD(HW_TRACE_RX, resp, 4);
+                HW_TRACE(HW_TRACE_EVENT, "[HW_PROP] DONE_OK\n");
                 done = 1;
                 break;
 
             case RSP_DONE_CONFLICT:
                 /* Read 3 more bytes: clause_id(2) + padding(1) */
-                if (recv_bytes(resp + 1, 3) < 0) return -1;
-                conflict_ci = (resp[1] << 8) | resp[2];
+                if (recv_bytes(resp + 1, 3) != 0) return CREF_ERROR;
+                HW_TRACE_RECORD(HW_TRACE_RX, resp, 4);
+                HW_TRACE(HW_TRACE_EVENT, "[HW_PROP] DONE_CONFLICT clause_id=%d\n",
+                         (resp[1] << 8) | resp[2]);
+                if (conflict_ci < 0) conflict_ci = (resp[1] << 8) | resp[2];
                 done = 1;
                 break;
 
             default:
                 fprintf(stderr, "hw_interface: unexpected response byte 0x%02X\n",
                         resp[0]);
-                return -1;
+                hw_trace_dump(stderr);
+                return CREF_ERROR;
             }
         }
 
+        /* The accelerator stored an implied value that contradicts the
+         * solver's; put the solver's value back. */
+        for (int i = 0; i < restore_count; i++) {
+            int var = restore_vars[i];
+            uart_assign(var, cdcl_var_value(s, var), false);
+        }
+        restore_count = 0;
+
         if (conflict_ci >= 0) {
-            /* Advance prop_head past the literal we just processed */
-            s->prop_head++;
-            return conflict_ci;
+            /* Advance hw_head past the literal we just processed */
+            s->hw_head++;
+            return hw_db_cref(conflict_ci);
         }
 
         /* Advance to next trail entry (new implications may have extended it) */
-        s->prop_head++;
+        s->hw_head++;
     }
 
-    return -1;  /* no conflict */
+    return CREF_UNDEF;  /* no conflict */
 }
 
-#endif /* USE_HW_BCP */
+const BCPBackend bcp_backend_uart = {
+    .name           = "uart",
+    .desc           = "FPGA accelerator over UART (legacy)",
+    .open           = uart_open,
+    .init           = uart_init,
+    .assign         = uart_assign,
+    .sync           = uart_sync,
+    .propagate      = uart_propagate,
+    .close          = uart_close,
+    .learnt         = hw_db_add_learnt,
+    .reduced        = hw_db_drop_deleted,
+    .refs           = hw_db_refs,
+    .write_clause   = uart_write_clause,
+    .write_wl_entry = uart_write_wl_entry,
+    .write_wl_len   = uart_write_wl_len,
+};
@@ -2,40 +2,72 @@
  * hw_interface_jtag.c — Hardware BCP Accelerator JTAG Driver
  *
  * Communicates with the BCP accelerator FPGA via JTAG using the ECP5
- * JTAGG primitive and OpenOCD's TCL server.  Provides the same API
- * as hw_interface.c so the solver code is unchanged.
+ * JTAGG primitive and OpenOCD's TCL server.  Exported as the "jtag"
+ * BCP backend (bcp_backend.h).
  *
  * Protocol: 128-bit drscan commands via OpenOCD TCL socket.
  *
  * Command (host → FPGA):
- *   [127:120] cmd_byte    (0x01-0x07)
+ *   [127:120] cmd_byte    (0x01-0x09)
  *   [119:8]   payload     (14 bytes, same encoding as UART protocol)
  *   [7:0]     seq_num     (incremented per command)
  *
  * Response (FPGA → host, shifted out during drscan):
  *   [127:120] status      (0x00=IDLE, 0x01=BUSY, 0xB0=IMPL, 0xC0/C1=DONE)
- *   [119:104] var         (16 bits)
- *   [103:96]  val         (8 bits)
- *   [95:80]   reason/clause_id (16 bits)
- *   [79:8]    reserved
+ *   [119:117] count       (implication tuples in this response, 0-4)
+ *   [116:104] clause_id   (conflicting clause, DONE_CONFLICT only)
+ *   [103:100] reserved
+ *   [99:8]    4 × 23-bit implication tuples, tuple i at [8+23i +: 23]:
+ *             var [8:0] | value [9] (1=TRUE) | reason [22:10]
  *   [7:0]     ack_seq
+ *
+ * Implications are drained in bursts of up to JTAG_BURST_MAX.  An IMPL
+ * response carries a full burst with more to come; ACK_IMPL asks for the
+ * next one.  The last burst rides on the DONE response.  The accelerator
+ * writes every implied value into its own assignment memory, so the host
+ * never echoes implications back with WRITE_ASSIGN.
+ *
+ * The FPGA keeps its own trail of assigned variables with a checkpoint per
+ * decision level (a decision is a WRITE_ASSIGN with payload byte 3 bit 0
+ * set), so undoing a backjump is a single BACKTRACK [level:2] command.
+ *
+ * READ_PERF [index:1] reads the accelerator's performance counters: the
+ * response becomes a PERF word (status 0xD0) with the index at [119:112],
+ * the number of counters at [111:108], the number of PEs at [107:104] and
+ * three 32-bit counters from the index on at [103:8], until the next
+ * command.  Index 0 also snapshots them all.  The perf hook sweeps them
+ * between rounds and widens the differences to 64 bits, so it must be
+ * called at least once per 2^32 cycles (six minutes at 12 MHz).
+ *
+ * Session: the OpenOCD connection outlives a solve.  The first open()
+ * either forks OpenOCD or, given a port of the form [host:]port, attaches
+ * to a TCL server that is already running; later opens in the same process
+ * reuse the connection.  Instead of fixed sleeps, the driver polls until
+ * the server accepts a connection and answers a scan with a response word
+ * (the readiness handshake).  Every open() then soft-resets the FPGA with
+ * RESET_STATE, and close() only drops the clause database.  The session
+ * ends at process exit: a forked OpenOCD is shut down, an attached server
+ * is left running.
  */
 
-#ifdef USE_HW_BCP
-
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 #include <signal.h>
 #include <errno.h>
+#include <time.h>
 #include <sys/socket.h>
 #include <sys/wait.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <arpa/inet.h>
+#include <netdb.h>
 
 #include "CDCL.h"
-#include "hw_interface.h"
+#include "bcp_backend.h"
+#include "hw_clausedb.h"
+#include "hw_trace.h"
 
 /* ── Command bytes ──────────────────────────────────────────────────────── */
 #define CMD_WRITE_CLAUSE   0x01
@@ -45,6 +77,8 @@
 #define CMD_BCP_START      0x05
 #define CMD_RESET_STATE    0x06
 #define CMD_ACK_IMPL       0x07
+#define CMD_BACKTRACK      0x08
+#define CMD_READ_PERF      0x09
 
 /* ── Response status bytes ─────────────────────────────────────────────── */
 #define RSP_IDLE           0x00
@@ -52,6 +86,7 @@
 #define RSP_IMPLICATION    0xB0
 #define RSP_DONE_OK        0xC0
 #define RSP_DONE_CONFLICT  0xC1
+#define RSP_PERF           0xD0
 
 /* ── Hardware assignment encoding ──────────────────────────────────────── */
 #define HW_UNASSIGNED 0
@@ -63,13 +98,17 @@
 #define OPENOCD_HOST     "127.0.0.1"
 #define TCL_TERMINATOR   '\x1a'  /* OpenOCD TCL protocol terminator */
 
-/* ── Global port path (unused for JTAG, kept for API compat) ──────────── */
-const char *hw_port = NULL;
-
 /* ── Static state ───────────────────────────────────────────────────────── */
 static int tcl_sock = -1;
-static pid_t openocd_pid = -1;
-static unsigned char seq_num = 0;
+static pid_t openocd_pid = -1;      /* OpenOCD forked by us, or -1 if attached */
+static unsigned char seq_num = 0;   /* sequence number of the last command */
+static double link_seconds = 0;     /* spent in tcl_send() and tcl_recv()  */
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
 
 /* ── Helper: map software assign value → hardware encoding ──────────────── */
 static inline unsigned char sw_to_hw_assign(int val) {
@@ -88,37 +127,56 @@ static inline int hw_to_sw_assign(unsigned char val) {
 /* ── TCL socket I/O helpers ─────────────────────────────────────────────── */
 
 static int tcl_send(const char *cmd) {
-    /* OpenOCD TCL protocol: send command + \x1a terminator */
+    /* OpenOCD TCL protocol: send command + \x1a terminator.  Both go out in
+     * one send() so the terminator is never held back by Nagle's algorithm
+     * waiting for the ACK of the command bytes. */
+    double start = now_seconds();
     int len = (int)strlen(cmd);
-    if (send(tcl_sock, cmd, len, 0) != len) {
-        perror("hw_interface_jtag: tcl send cmd");
-        return -1;
-    }
-    char term = TCL_TERMINATOR;
-    if (send(tcl_sock, &term, 1, 0) != 1) {
-        perror("hw_interface_jtag: tcl send terminator");
-        return -1;
+    char *msg = (char *)malloc(len + 1);
+    memcpy(msg, cmd, len);
+    msg[len] = TCL_TERMINATOR;
+    int sent = 0;
+    while (sent < len + 1) {
+        int n = (int)send(tcl_sock, msg + sent, len + 1 - sent, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            perror("hw_interface_jtag: tcl send");
+            free(msg);
+            return -1;
+        }
+        sent += n;
     }
+    free(msg);
+    link_seconds += now_seconds() - start;
     return 0;
 }
 
+/* Receive buffer: replies are read in chunks, not one byte per recv(). */
+static char tcl_rx[4096];
+static int  tcl_rx_head = 0, tcl_rx_tail = 0;
+
 static int tcl_recv(char *buf, int bufsize) {
-    /* Read until \x1a terminator */
+    /* Read until \x1a terminator.  A reply longer than `buf` is truncated,
+     * but always consumed up to its terminator so the stream stays framed. */
+    double start = now_seconds();
     int total = 0;
-    while (total < bufsize - 1) {
-        int n = (int)recv(tcl_sock, buf + total, 1, 0);
-        if (n <= 0) {
-            if (n < 0 && errno == EINTR) continue;
-            perror("hw_interface_jtag: tcl recv");
-            return -1;
-        }
-        if (buf[total] == TCL_TERMINATOR) {
-            buf[total] = '\0';
-            return total;
+    for (;;) {
+        if (tcl_rx_head == tcl_rx_tail) {
+            int n = (int)recv(tcl_sock, tcl_rx, sizeof(tcl_rx), 0);
+            if (n <= 0) {
+                if (n < 0 && errno == EINTR) continue;
+                perror("hw_interface_jtag: tcl recv");
+                return -1;
+            }
+            tcl_rx_head = 0;
+            tcl_rx_tail = n;
         }
-        total += n;
+        char ch = tcl_rx[tcl_rx_head++];
+        if (ch == TCL_TERMINATOR) break;
+        if (total < bufsize - 1) buf[total++] = ch;
     }
     buf[total] = '\0';
+    link_seconds += now_seconds() - start;
     return total;
 }
 
@@ -133,6 +191,8 @@ static const char *cmd_name(unsigned char cmd) {
     case CMD_BCP_START:      return "BCP_START";
     case CMD_RESET_STATE:    return "RESET_STATE";
     case CMD_ACK_IMPL:       return "ACK_IMPL";
+    case CMD_BACKTRACK:      return "BACKTRACK";
+    case CMD_READ_PERF:      return "READ_PERF";
     case 0x00:               return "NOP";
     default:                 return "UNKNOWN";
     }
@@ -145,6 +205,7 @@ static const char *rsp_name(unsigned char status) {
     case RSP_IMPLICATION:   return "IMPLICATION";
     case RSP_DONE_OK:       return "DONE_OK";
     case RSP_DONE_CONFLICT: return "DONE_CONFLICT";
+    case RSP_PERF:          return "PERF";
     default:                return "UNKNOWN";
     }
 }
@@ -163,9 +224,13 @@ static void build_cmd_hex(char *hex_out, unsigned char cmd_byte,
         reg[1 + i] = payload[i];
     }
 
-    /* reg[15] = bits [7:0] = seq_num */
-    seq_num++;
-    reg[15] = seq_num;
+    /* reg[15] = bits [7:0] = seq_num.  Only real commands are numbered
+     * (NOPs carry 0, which the FPGA never echoes), so the ack_seq of a
+     * stale response can never match the command being waited for. */
+    if (cmd_byte != 0x00) {
+        if (++seq_num == 0) seq_num = 1;
+        reg[15] = seq_num;
+    }
 
     /* Convert to hex string (MSB first) */
     for (int i = 0; i < 16; i++) {
@@ -173,49 +238,94 @@ static void build_cmd_hex(char *hex_out, unsigned char cmd_byte,
     }
     hex_out[32] = '\0';
 
-    /* Debug: print command being sent */
-    fprintf(stderr, "[JTAG TX] cmd=0x%02X (%s) seq=%u payload(%d)=[",
-            cmd_byte, cmd_name(cmd_byte), seq_num, payload_len);
-    for (int i = 0; i < payload_len; i++) {
-        fprintf(stderr, "%s0x%02X", i ? " " : "", payload[i]);
+    HW_TRACE_RECORD(HW_TRACE_TX, reg, 16);
+    if (HW_TRACE_ON(HW_TRACE_SCAN)) {
+        fprintf(stderr, "[JTAG TX] cmd=0x%02X (%s) seq=%u payload(%d)=[",
+                cmd_byte, cmd_name(cmd_byte), reg[15], payload_len);
+        for (int i = 0; i < payload_len; i++) {
+            fprintf(stderr, "%s0x%02X", i ? " " : "", payload[i]);
+        }
+        fprintf(stderr, "] hex=%s\n", hex_out);
     }
-    fprintf(stderr, "] hex=%s\n", hex_out);
 }
 
-/* ── Perform a 128-bit drscan and parse response ────────────────────── */
+/* ── Batched scan transport ──────────────────────────────────────────
+ *
+ * Scans are not sent one TCL request at a time.  jtag_drscan() appends a
+ * "drscan" to a batch; the batch goes out as a single TCL script
+ * ("irscan ...; drscan ...; drscan ...") either when it fills up or when
+ * the caller needs a response.  A TCL script evaluates to the result of
+ * its last command, so the reply carries the data shifted out by the
+ * final scan — the only response that matters under the 1-scan-delay
+ * protocol, since the responses to write commands are stale by design.
+ *
+ * Write-only batches are pipelined: up to TCL_PIPELINE_MAX requests may be
+ * in flight before the driver stops to collect a reply.  All replies must
+ * be collected before a response is read so the stream stays in order.
+ */
+
+#define JTAG_BATCH_MAX   128  /* drscans per TCL request                   */
+#define TCL_PIPELINE_MAX 4    /* write-only requests in flight              */
+#define SCAN_TCL_LEN     56   /* strlen("; drscan ecp5.tap 128 0x") + 32 hex */
+
+#define JTAG_BURST_MAX   4    /* implication tuples per response          */
+#define JTAG_PERF_MAX    3    /* counters per PERF response               */
 
 typedef struct {
-    unsigned char status;
     unsigned int  var;
-    unsigned char val;
-    unsigned int  reason_id;
+    unsigned char val;        /* 1 = TRUE, 0 = FALSE */
+    unsigned int  reason_id;  /* hardware clause id  */
+} JTAGImpl;
+
+typedef struct {
+    unsigned char status;
+    unsigned char count;      /* valid entries in impls */
+    JTAGImpl      impls[JTAG_BURST_MAX];
+    unsigned int  clause_id;
     unsigned char ack_seq;
+    /* PERF responses only */
+    unsigned char perf_index, perf_count, perf_pes;
+    uint32_t      perf[JTAG_PERF_MAX];
 } JTAGResponse;
 
-static int jtag_drscan(unsigned char cmd_byte,
-                       const unsigned char *payload, int payload_len,
-                       JTAGResponse *rsp) {
-    char hex_cmd[33];
-    build_cmd_hex(hex_cmd, cmd_byte, payload, payload_len);
+static char batch_buf[32 + JTAG_BATCH_MAX * SCAN_TCL_LEN];
+static int  batch_len      = 0;  /* bytes of TCL in batch_buf     */
+static int  batch_scans    = 0;  /* drscans queued in batch_buf   */
+static int  tcl_in_flight  = 0;  /* requests whose reply is unread */
 
-    /* Build OpenOCD TCL command:
-     * "drscan ecp5.tap 128 0x<hex>" selects ER1 via IR=0x32 and scans
-     * Actually, we need to first select the ER1 register, then scan:
-     *   irscan ecp5.tap 0x32
-     *   drscan ecp5.tap 128 0x<hex>
-     * But for efficiency, we batch them. */
-    char tcl_cmd[256];
-    snprintf(tcl_cmd, sizeof(tcl_cmd),
-             "irscan ecp5.tap 0x32; drscan ecp5.tap 128 0x%s", hex_cmd);
+/* Discard the reply of the oldest in-flight request. */
+static int tcl_collect_one(void) {
+    char discard[256];
+    if (tcl_recv(discard, sizeof(discard)) < 0) return -1;
+    tcl_in_flight--;
+    return 0;
+}
 
-    if (tcl_send(tcl_cmd) < 0) return -1;
+/* Send the queued batch without waiting for its reply. */
+static int batch_send(void) {
+    if (batch_scans == 0) return 0;
+    if (tcl_send(batch_buf) < 0) return -1;
+    batch_len = 0;
+    batch_scans = 0;
+    tcl_in_flight++;
+    while (tcl_in_flight > TCL_PIPELINE_MAX)
+        if (tcl_collect_one() < 0) return -1;
+    return 0;
+}
 
-    char resp_buf[256];
-    if (tcl_recv(resp_buf, sizeof(resp_buf)) < 0) return -1;
+/* Extract bits [lo +: width] of a response; rsp_bytes[0] holds [127:120]. */
+static unsigned int rsp_field(const unsigned char *rsp_bytes, int lo, int width) {
+    unsigned int v = 0;
+    for (int bit = lo + width - 1; bit >= lo; bit--)
+        v = (v << 1) | ((rsp_bytes[15 - bit / 8] >> (bit % 8)) & 1);
+    return v;
+}
 
+/* Parse the hex data returned by a drscan into a response record. */
+static void parse_response(const char *resp_buf, JTAGResponse *rsp) {
     /* Parse hex response (OpenOCD returns hex string).
      * Skip any leading whitespace or status prefix. */
-    char *hex_start = resp_buf;
+    const char *hex_start = resp_buf;
     /* OpenOCD TCL responses may have a leading \x00 status byte */
     if (hex_start[0] == '\0' || hex_start[0] == ' ') hex_start++;
 
@@ -224,7 +334,7 @@ static int jtag_drscan(unsigned char cmd_byte,
     memset(rsp_bytes, 0, sizeof(rsp_bytes));
 
     /* Find the hex data in the response */
-    char *p = hex_start;
+    const char *p = hex_start;
     while (*p && (*p == ' ' || *p == '\n' || *p == '\r')) p++;
 
     for (int i = 0; i < 16 && p[0] && p[1]; i++) {
@@ -235,24 +345,74 @@ static int jtag_drscan(unsigned char cmd_byte,
         while (*p == ' ') p++;  /* skip spaces between hex bytes */
     }
 
-    /* Debug: print raw response */
-    fprintf(stderr, "[JTAG RX] raw_hex=");
-    for (int i = 0; i < 16; i++) fprintf(stderr, "%02x", rsp_bytes[i]);
-    fprintf(stderr, " raw_tcl=\"%s\"\n", hex_start);
-
-    if (rsp) {
-        rsp->status    = rsp_bytes[0];
-        rsp->var       = (rsp_bytes[1] << 8) | rsp_bytes[2];
-        rsp->val       = rsp_bytes[3];
-        rsp->reason_id = (rsp_bytes[4] << 8) | rsp_bytes[5];
-        rsp->ack_seq   = rsp_bytes[15];
+    HW_TRACE_RECORD(HW_TRACE_RX, rsp_bytes, 16);
+    if (HW_TRACE_ON(HW_TRACE_SCAN)) {
+        fprintf(stderr, "[JTAG RX] raw_hex=");
+        for (int i = 0; i < 16; i++) fprintf(stderr, "%02x", rsp_bytes[i]);
+        fprintf(stderr, " raw_tcl=\"%s\"\n", hex_start);
+    }
 
-        fprintf(stderr, "[JTAG RX] status=0x%02X (%s) var=%u val=%u "
-                "reason_id=%u ack_seq=%u\n",
-                rsp->status, rsp_name(rsp->status),
-                rsp->var, rsp->val, rsp->reason_id, rsp->ack_seq);
+    rsp->status    = rsp_bytes[0];
+    rsp->count     = (unsigned char)rsp_field(rsp_bytes, 117, 3);
+    rsp->clause_id = rsp_field(rsp_bytes, 104, 13);
+    rsp->ack_seq   = rsp_bytes[15];
+    if (rsp->status == RSP_PERF) {
+        rsp->count      = 0;
+        rsp->perf_index = rsp_bytes[1];
+        rsp->perf_count = (unsigned char)rsp_field(rsp_bytes, 108, 4);
+        rsp->perf_pes   = (unsigned char)rsp_field(rsp_bytes, 104, 4);
+        for (int i = 0; i < JTAG_PERF_MAX; i++)
+            rsp->perf[i] = (uint32_t)rsp_field(rsp_bytes, 8 + 32 * i, 32);
+    }
+    if (rsp->count > JTAG_BURST_MAX) rsp->count = JTAG_BURST_MAX;
+    for (int i = 0; i < rsp->count; i++) {
+        unsigned int t = rsp_field(rsp_bytes, 8 + 23 * i, 23);
+        rsp->impls[i].var       = t & 0x1FF;
+        rsp->impls[i].val       = (t >> 9) & 1;
+        rsp->impls[i].reason_id = t >> 10;
     }
 
+    HW_TRACE(HW_TRACE_SCAN, "[JTAG RX] status=0x%02X (%s) count=%u "
+             "clause_id=%u ack_seq=%u\n",
+             rsp->status, rsp_name(rsp->status),
+             rsp->count, rsp->clause_id, rsp->ack_seq);
+}
+
+/* Send the queued batch, wait for every outstanding reply and decode the
+ * data shifted out by the last scan of the batch into `rsp`. */
+static int batch_exec(JTAGResponse *rsp) {
+    if (batch_send() < 0) return -1;
+    while (tcl_in_flight > 1)
+        if (tcl_collect_one() < 0) return -1;
+
+    char resp_buf[256];
+    if (tcl_recv(resp_buf, sizeof(resp_buf)) < 0) return -1;
+    tcl_in_flight--;
+    parse_response(resp_buf, rsp);
+    return 0;
+}
+
+/*
+ * Queue a 128-bit drscan.  With `rsp` == NULL the scan is only queued (it
+ * goes out with the batch); otherwise the batch is executed now and `rsp`
+ * receives the data shifted out by this scan.
+ */
+static int jtag_drscan(unsigned char cmd_byte,
+                       const unsigned char *payload, int payload_len,
+                       JTAGResponse *rsp) {
+    char hex_cmd[33];
+    build_cmd_hex(hex_cmd, cmd_byte, payload, payload_len);
+
+    /* Each batch first selects the ER1 register (IR=0x32), then scans. */
+    if (batch_scans == 0)
+        batch_len = snprintf(batch_buf, sizeof(batch_buf), "irscan ecp5.tap 0x32");
+    batch_len += snprintf(batch_buf + batch_len, sizeof(batch_buf) - batch_len,
+                          "; drscan ecp5.tap 128 0x%s", hex_cmd);
+    batch_scans++;
+    bcp_hw_scans++;
+
+    if (rsp) return batch_exec(rsp);
+    if (batch_scans == JTAG_BATCH_MAX) return batch_send();
     return 0;
 }
 
@@ -262,282 +422,562 @@ static int jtag_nop_scan(JTAGResponse *rsp) {
     return jtag_drscan(0x00, NULL, 0, rsp);
 }
 
-/* ── Read current response (flush + read) ──────────────────────────── */
+/* ── Read current response ──────────────────────────────────────────── */
 
-static int jtag_read_response(JTAGResponse *rsp) {
-    /* Flush scan: loads current rsp_reg into shift_reg */
-    if (jtag_nop_scan(NULL) < 0) return -1;
-    /* Read scan: shifts out the loaded response */
+/*
+ * The response word is captured when a scan starts shifting, i.e. before
+ * that scan's own command is latched, so a command's result can only be
+ * seen by a later scan.  OpenOCD runs the scans of one TCL script back to
+ * back and the FPGA consumes a command within a few clock cycles of
+ * update-DR, so a single scan queued behind the command (in the same
+ * request) already sees its effect.  `scans` > 1 queues extra NOPs in
+ * front of the read to give a busy accelerator more time without another
+ * round trip; only the last one's data is returned.
+ */
+static int jtag_read_response(JTAGResponse *rsp, int scans) {
+    for (int i = 1; i < scans; i++)
+        if (jtag_nop_scan(NULL) < 0) return -1;
     return jtag_nop_scan(rsp);
 }
 
-/* ── Send command and wait for completion ──────────────────────────── */
+/* ── Queue a write command (fire-and-forget, pipelined) ────────────── */
 
 static int jtag_send_cmd(unsigned char cmd_byte,
                          const unsigned char *payload, int payload_len) {
-    JTAGResponse rsp;
-    if (jtag_drscan(cmd_byte, payload, payload_len, &rsp) < 0) return -1;
-    /* For write commands (not BCP_START), just return.
-     * The 1-scan delay means the response we just read is stale,
-     * but write commands are fire-and-forget. */
+    /* The 1-scan delay means the response to a write is stale anyway,
+     * so writes are never waited on individually. */
+    return jtag_drscan(cmd_byte, payload, payload_len, NULL);
+}
+
+/* Push out all queued writes and wait until OpenOCD has executed them. */
+static int jtag_sync(void) {
+    if (batch_send() < 0) return -1;
+    while (tcl_in_flight > 0)
+        if (tcl_collect_one() < 0) return -1;
     return 0;
 }
 
-/* ── Poll until BCP is done ─────────────────────────────────────────── */
+/* ── Wait for the last command to complete ─────────────────────────── */
 
-static int jtag_poll_status(JTAGResponse *rsp) {
-    /* After BCP_START, poll with NOP scans until status != BUSY.
-     * Due to the 1-scan delay, we do flush+read pairs. */
-    int max_polls = 10000;
-    for (int i = 0; i < max_polls; i++) {
-        if (jtag_read_response(rsp) < 0) return -1;
-        fprintf(stderr, "[JTAG POLL] iter=%d status=0x%02X (%s) var=%u "
-                "val=%u reason=%u ack_seq=%u\n",
-                i, rsp->status, rsp_name(rsp->status),
-                rsp->var, rsp->val, rsp->reason_id, rsp->ack_seq);
-        if (rsp->status != RSP_BUSY && rsp->status != RSP_IDLE) {
+#define POLL_SPIN_SCANS_MAX  32      /* NOP scans per request before sleeping */
+#define POLL_SLEEP_MAX_US    1000    /* longest sleep between polls           */
+#define POLL_TIMEOUT_US      5000000 /* give up after this much sleeping      */
+
+/*
+ * Read responses until the FPGA reports a result (IMPLICATION or DONE) for
+ * the most recently sent command, or with `idle` set, until it is back in
+ * IDLE after it.  ack_seq tells a fresh response from one left over by an
+ * earlier BCP round.
+ *
+ * The first read travels in the same TCL request as the command itself, so
+ * a short BCP costs no extra round trip.  While the accelerator is busy the
+ * driver backs off adaptively: each further request first doubles the
+ * number of NOP scans it carries (busy-spinning on the JTAG clock), then
+ * sleeps between requests for exponentially growing intervals.
+ */
+static int jtag_poll_status(JTAGResponse *rsp, bool idle) {
+    int scans = 1;
+    useconds_t sleep_us = 0;
+    long slept_us = 0;
+
+    for (int i = 0; ; i++) {
+        if (jtag_read_response(rsp, scans) < 0) return -1;
+        HW_TRACE(HW_TRACE_SCAN, "[JTAG POLL] iter=%d scans=%d status=0x%02X (%s) "
+                 "count=%u ack_seq=%u\n",
+                 i, scans, rsp->status, rsp_name(rsp->status),
+                 rsp->count, rsp->ack_seq);
+        if (rsp->ack_seq == seq_num &&
+            (idle ? rsp->status == RSP_IDLE
+                  : rsp->status != RSP_BUSY && rsp->status != RSP_IDLE)) {
             return 0;
         }
-        /* Small delay between polls */
-        usleep(100);
+
+        if (scans < POLL_SPIN_SCANS_MAX) {
+            scans *= 2;
+            continue;
+        }
+        if (slept_us >= POLL_TIMEOUT_US) break;
+        sleep_us = sleep_us ? sleep_us * 2 : 1;
+        if (sleep_us > POLL_SLEEP_MAX_US) sleep_us = POLL_SLEEP_MAX_US;
+        usleep(sleep_us);
+        slept_us += sleep_us;
     }
-    fprintf(stderr, "hw_interface_jtag: poll timeout (last status=0x%02X)\n",
-            rsp->status);
+    fprintf(stderr, "hw_interface_jtag: poll timeout (last status=0x%02X "
+            "ack_seq=%u, expected %u)\n", rsp->status, rsp->ack_seq, seq_num);
+    hw_trace_dump(stderr);
     return -1;
 }
 
-/* ── Public API ─────────────────────────────────────────────────────── */
+/* ── Session ────────────────────────────────────────────────────────── */
 
-int hw_open(const char *port) {
-    (void)port;  /* unused for JTAG */
+#define READY_TIMEOUT_US  10000000  /* connect + handshake deadline        */
+#define READY_SLEEP_MAX_US 100000   /* longest sleep between attempts      */
+#define EXIT_TIMEOUT_US    1000000  /* wait for OpenOCD to exit on shutdown */
 
-    /* Fork OpenOCD as background daemon with TCL server */
-    openocd_pid = fork();
-    if (openocd_pid < 0) {
-        perror("hw_interface_jtag: fork");
-        return -1;
-    }
-
-    if (openocd_pid == 0) {
-        /* Child: exec OpenOCD with the project config */
-        freopen("/dev/null", "w", stdout);
-        freopen("/dev/null", "w", stderr);
-        execlp("openocd", "openocd",
-               "-f", "openocd-ecp5.cfg",
-               "-c", "init",
-               NULL);
-        perror("hw_interface_jtag: exec openocd");
-        _exit(1);
-    }
+/* Sleep before the next readiness attempt; the interval doubles from 1 ms.
+ * Returns -1 once `*slept_us` has reached the deadline. */
+static int ready_backoff(useconds_t *sleep_us, long *slept_us) {
+    if (*slept_us >= READY_TIMEOUT_US) return -1;
+    *sleep_us = *sleep_us ? *sleep_us * 2 : 1000;
+    if (*sleep_us > READY_SLEEP_MAX_US) *sleep_us = READY_SLEEP_MAX_US;
+    usleep(*sleep_us);
+    *slept_us += *sleep_us;
+    return 0;
+}
 
-    /* Parent: wait for OpenOCD to start, then connect */
-    usleep(500000);  /* 500ms */
+/* True if the OpenOCD we forked has already exited. */
+static bool openocd_exited(void) {
+    int status;
+    if (openocd_pid <= 0) return false;
+    if (waitpid(openocd_pid, &status, WNOHANG) != openocd_pid) return false;
+    openocd_pid = -1;
+    return true;
+}
 
-    /* Connect to OpenOCD TCL server */
-    tcl_sock = socket(AF_INET, SOCK_STREAM, 0);
-    if (tcl_sock < 0) {
-        perror("hw_interface_jtag: socket");
+/* Connect to the TCL server at host:port, retrying until it listens. */
+static int tcl_connect(const char *host, const char *port) {
+    struct addrinfo hints, *ai;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    int rc = getaddrinfo(host, port, &hints, &ai);
+    if (rc != 0) {
+        fprintf(stderr, "hw_interface_jtag: %s:%s: %s\n", host, port,
+                gai_strerror(rc));
         return -1;
     }
 
-    struct sockaddr_in addr;
-    memset(&addr, 0, sizeof(addr));
-    addr.sin_family = AF_INET;
-    addr.sin_port = htons(OPENOCD_TCL_PORT);
-    inet_pton(AF_INET, OPENOCD_HOST, &addr.sin_addr);
-
-    /* Retry connection a few times (OpenOCD may still be starting) */
-    int connected = 0;
-    for (int i = 0; i < 10; i++) {
-        if (connect(tcl_sock, (struct sockaddr *)&addr, sizeof(addr)) == 0) {
-            connected = 1;
+    useconds_t sleep_us = 0;
+    long slept_us = 0;
+    for (;;) {
+        tcl_sock = socket(AF_INET, SOCK_STREAM, 0);
+        if (tcl_sock < 0) {
+            perror("hw_interface_jtag: socket");
             break;
         }
-        usleep(500000);  /* 500ms between retries */
-    }
-
-    if (!connected) {
-        fprintf(stderr, "hw_interface_jtag: failed to connect to OpenOCD "
-                "TCL server on port %d\n", OPENOCD_TCL_PORT);
+        if (connect(tcl_sock, ai->ai_addr, ai->ai_addrlen) == 0) {
+            /* Requests are small and latency-bound: disable Nagle. */
+            int one = 1;
+            setsockopt(tcl_sock, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            freeaddrinfo(ai);
+            return 0;
+        }
         close(tcl_sock);
         tcl_sock = -1;
-        return -1;
+        if (openocd_exited() || ready_backoff(&sleep_us, &slept_us) < 0) break;
     }
+    freeaddrinfo(ai);
+    fprintf(stderr, "hw_interface_jtag: failed to connect to OpenOCD "
+            "TCL server on %s:%s\n", host, port);
+    return -1;
+}
 
-    seq_num = 0;
-    return 0;
+/*
+ * Readiness handshake: a NOP scan that comes back as a response word.
+ * Until OpenOCD has examined the chain, the scan fails and the reply is an
+ * error message instead.  The FPGA's ack_seq seeds seq_num, so the first
+ * command of this session can never be mistaken for one already acked.
+ */
+static int jtag_handshake(void) {
+    static const char nop[] =
+        "irscan ecp5.tap 0x32; "
+        "drscan ecp5.tap 128 0x00000000000000000000000000000000";
+    char reply[256];
+    useconds_t sleep_us = 0;
+    long slept_us = 0;
+
+    for (;;) {
+        if (tcl_send(nop) < 0 || tcl_recv(reply, sizeof(reply)) < 0) return -1;
+        const char *p = reply;
+        while (*p == ' ' || *p == '\n' || *p == '\r') p++;
+        if (strspn(p, "0123456789abcdefABCDEF") == 32) {
+            JTAGResponse rsp;
+            parse_response(reply, &rsp);
+            seq_num = rsp.ack_seq;
+            HW_TRACE(HW_TRACE_EVENT, "[HW_OPEN] ready after %ld us, "
+                     "ack_seq=%u\n", slept_us, seq_num);
+            return 0;
+        }
+        HW_TRACE(HW_TRACE_EVENT, "[HW_OPEN] not ready: \"%s\"\n", reply);
+        if (openocd_exited() || ready_backoff(&sleep_us, &slept_us) < 0) break;
+    }
+    fprintf(stderr, "hw_interface_jtag: OpenOCD did not answer a scan\n");
+    return -1;
 }
 
-void hw_close(void) {
+/* End the session: shut down the OpenOCD we forked, or just disconnect
+ * from one we attached to. */
+static void jtag_shutdown(void) {
     if (tcl_sock >= 0) {
-        /* Send shutdown command to OpenOCD */
-        tcl_send("shutdown");
+        if (openocd_pid > 0) {
+            jtag_sync();
+            tcl_send("shutdown");
+        }
         close(tcl_sock);
         tcl_sock = -1;
     }
 
     if (openocd_pid > 0) {
-        /* Give OpenOCD a moment to shut down gracefully */
-        usleep(200000);
-        int status;
-        if (waitpid(openocd_pid, &status, WNOHANG) == 0) {
-            /* Still running — send SIGTERM */
+        /* Wait for a graceful exit, then send SIGTERM. */
+        useconds_t sleep_us = 1000;
+        long slept_us = 0;
+        while (!openocd_exited() && slept_us < EXIT_TIMEOUT_US) {
+            usleep(sleep_us);
+            slept_us += sleep_us;
+            if (sleep_us < READY_SLEEP_MAX_US) sleep_us *= 2;
+        }
+        if (openocd_pid > 0) {
+            int status;
             kill(openocd_pid, SIGTERM);
             waitpid(openocd_pid, &status, 0);
+            openocd_pid = -1;
         }
-        openocd_pid = -1;
     }
 }
 
-void hw_init(CDCLSolver *s) {
-    unsigned char payload[14];
+/* Fork OpenOCD or attach to `port`, then wait until it is ready. */
+static int session_start(const char *port) {
+    char host[256] = OPENOCD_HOST;
+    char service[16];
+    snprintf(service, sizeof(service), "%d", OPENOCD_TCL_PORT);
+
+    if (port) {
+        /* [host:]port of a TCL server that is already running */
+        const char *colon = strrchr(port, ':');
+        if (colon) {
+            if (colon > port) {
+                int n = (int)(colon - port);
+                if (n >= (int)sizeof(host)) n = (int)sizeof(host) - 1;
+                memcpy(host, port, n);
+                host[n] = '\0';
+            }
+            port = colon + 1;
+        }
+        snprintf(service, sizeof(service), "%s", port);
+    } else {
+        /* Fork OpenOCD as background daemon with TCL server */
+        openocd_pid = fork();
+        if (openocd_pid < 0) {
+            perror("hw_interface_jtag: fork");
+            return -1;
+        }
 
-    /* 1. Upload clauses */
-    for (int ci = 0; ci < s->clause_count; ci++) {
-        Clause *c = s->clauses[ci];
-        int size = c->size;
-        if (size > 5) size = 5;
-
-        payload[0] = (ci >> 8) & 0xFF;
-        payload[1] = ci & 0xFF;
-        payload[2] = (unsigned char)size;
-        payload[3] = 0;  /* sat bit = 0 at init */
-        for (int k = 0; k < 5; k++) {
-            int lit = (k < size) ? c->lits[k] : 0;
-            payload[4 + k * 2]     = (lit >> 8) & 0xFF;
-            payload[4 + k * 2 + 1] = lit & 0xFF;
+        if (openocd_pid == 0) {
+            /* Child: exec OpenOCD with the project config */
+            freopen("/dev/null", "w", stdout);
+            freopen("/dev/null", "w", stderr);
+            execlp("openocd", "openocd",
+                   "-f", "openocd-ecp5.cfg",
+                   "-c", "init",
+                   NULL);
+            perror("hw_interface_jtag: exec openocd");
+            _exit(1);
         }
-        jtag_send_cmd(CMD_WRITE_CLAUSE, payload, 14);
-    }
-
-    /* 2. Upload watch lists */
-    int num_lits = 2 * s->num_vars + 2;
-    for (int lit = 0; lit < num_lits; lit++) {
-        int wlen = s->watch_size[lit];
-        if (wlen == 0) continue;
-
-        payload[0] = (lit >> 8) & 0xFF;
-        payload[1] = lit & 0xFF;
-        payload[2] = (unsigned char)wlen;
-        jtag_send_cmd(CMD_WRITE_WL_LEN, payload, 3);
-
-        for (int j = 0; j < wlen; j++) {
-            int clause_id = s->watches[lit][j];
-            payload[0] = (lit >> 8) & 0xFF;
-            payload[1] = lit & 0xFF;
-            payload[2] = (unsigned char)j;
-            payload[3] = (clause_id >> 8) & 0xFF;
-            payload[4] = clause_id & 0xFF;
-            jtag_send_cmd(CMD_WRITE_WL_ENTRY, payload, 5);
+    }
+
+    batch_len = 0;
+    batch_scans = 0;
+    tcl_in_flight = 0;
+    tcl_rx_head = tcl_rx_tail = 0;
+
+    if (tcl_connect(host, service) < 0 || jtag_handshake() < 0) {
+        jtag_shutdown();
+        return -1;
+    }
+
+    static bool registered = false;
+    if (!registered) {
+        atexit(jtag_shutdown);
+        registered = true;
+    }
+    return 0;
+}
+
+/* ── Performance counters ───────────────────────────────────────────── */
+
+static uint32_t perf_last[BCP_PERF_COUNTERS];   /* raw values of the last sweep */
+static uint64_t perf_total[BCP_PERF_COUNTERS];  /* widened, since the first     */
+static bool     perf_fresh = true;              /* no sweep since open()        */
+
+static int jtag_perf(BCPPerf *out) {
+    uint32_t raw[BCP_PERF_COUNTERS];
+    JTAGResponse rsp;
+    int count = BCP_PERF_COUNTERS, pes = 0;
+
+    memset(raw, 0, sizeof(raw));
+    for (int index = 0; index < count; index += JTAG_PERF_MAX) {
+        unsigned char payload[1] = { (unsigned char)index };
+        jtag_drscan(CMD_READ_PERF, payload, 1, NULL);
+        if (jtag_poll_status(&rsp, false) < 0) return -1;
+        if (rsp.status != RSP_PERF || rsp.perf_index != index) {
+            fprintf(stderr, "hw_interface_jtag: no performance counters "
+                    "(status 0x%02X)\n", rsp.status);
+            return -1;
         }
+        /* An older bitstream may have fewer counters; the rest stay 0. */
+        if (rsp.perf_count < count) count = rsp.perf_count;
+        pes = rsp.perf_pes;
+        for (int i = 0; i < JTAG_PERF_MAX && index + i < count; i++)
+            raw[index + i] = rsp.perf[i];
+    }
+
+    for (int i = 0; i < BCP_PERF_COUNTERS; i++) {
+        if (perf_fresh) perf_total[i] = 0;
+        else perf_total[i] += (uint32_t)(raw[i] - perf_last[i]);
+        perf_last[i] = raw[i];
+    }
+    perf_fresh = false;
+
+    memcpy(out->count, perf_total, sizeof(out->count));
+    out->num_pes      = pes;
+    out->link_seconds = link_seconds;
+    return 0;
+}
+
+/* ── Backend hooks ──────────────────────────────────────────────────── */
+
+static int jtag_open(const char *port) {
+    /* A session left open by an earlier solve is reused as it is. */
+    if (tcl_sock < 0 && session_start(port) < 0) return -1;
+
+    /* Soft reset: forget the previous problem's trail and any round the
+     * previous owner of the FPGA left unfinished. */
+    JTAGResponse rsp;
+    HW_TRACE(HW_TRACE_EVENT, "[HW_OPEN] RESET_STATE\n");
+    if (jtag_drscan(CMD_RESET_STATE, NULL, 0, NULL) < 0 ||
+        jtag_poll_status(&rsp, true) < 0) {
+        jtag_shutdown();
+        return -1;
     }
+    link_seconds = 0;
+    perf_fresh = true;
+    return 0;
+}
+
+static void jtag_close(void) {
+    /* The session stays up for the next solve; see jtag_shutdown(). */
+    if (tcl_sock >= 0) jtag_sync();
+    hw_db_free();
+}
+
+static void jtag_init(CDCLSolver *s) {
+    unsigned char payload[3];
 
-    /* 3. Upload variable assignments */
-    for (int var = 1; var <= s->num_vars; var++) {
+    /* 1. Upload clauses and watch lists */
+    hw_db_init(s, &bcp_backend_jtag);
+
+    /* 2. Upload variable assignments */
+    for (int var = 1; var <= s->num_vars && var < HW_MAX_VARS; var++) {
         payload[0] = (var >> 8) & 0xFF;
         payload[1] = var & 0xFF;
-        payload[2] = sw_to_hw_assign(s->assigns[var]);
+        payload[2] = sw_to_hw_assign(cdcl_var_value(s, var));
         jtag_send_cmd(CMD_WRITE_ASSIGN, payload, 3);
     }
+
+    /* The upload is write-only; make sure it has all reached the FPGA. */
+    jtag_sync();
+}
+
+static void jtag_write_clause(int id, const int *lits, int size) {
+    unsigned char payload[14];
+    payload[0] = (id >> 8) & 0xFF;
+    payload[1] = id & 0xFF;
+    payload[2] = (unsigned char)size;
+    payload[3] = 0;  /* sat bit */
+    for (int k = 0; k < 5; k++) {
+        int lit = (k < size) ? lits[k] : 0;
+        payload[4 + k * 2]     = (lit >> 8) & 0xFF;
+        payload[4 + k * 2 + 1] = lit & 0xFF;
+    }
+    jtag_send_cmd(CMD_WRITE_CLAUSE, payload, 14);
 }
 
-void hw_write_assign(int var, int val) {
+static void jtag_write_wl_entry(int lit, int idx, int id) {
+    unsigned char payload[5];
+    payload[0] = (lit >> 8) & 0xFF;
+    payload[1] = lit & 0xFF;
+    payload[2] = (unsigned char)idx;
+    payload[3] = (id >> 8) & 0xFF;
+    payload[4] = id & 0xFF;
+    jtag_send_cmd(CMD_WRITE_WL_ENTRY, payload, 5);
+}
+
+static void jtag_write_wl_len(int lit, int len) {
     unsigned char payload[3];
+    payload[0] = (lit >> 8) & 0xFF;
+    payload[1] = lit & 0xFF;
+    payload[2] = (unsigned char)len;
+    jtag_send_cmd(CMD_WRITE_WL_LEN, payload, 3);
+}
+
+static void jtag_assign(int var, int val, bool decision) {
+    unsigned char payload[4];
+    if (var >= HW_MAX_VARS) {
+        /* Beyond the accelerator's range.  A decision must still open its
+         * level, so it is sent as a no-op write to the unused variable 0. */
+        if (!decision) return;
+        var = 0;
+        val = UNASSIGNED;
+    }
     payload[0] = (var >> 8) & 0xFF;
     payload[1] = var & 0xFF;
     payload[2] = sw_to_hw_assign(val);
-    jtag_send_cmd(CMD_WRITE_ASSIGN, payload, 3);
+    payload[3] = decision ? 0x01 : 0x00;
+    jtag_send_cmd(CMD_WRITE_ASSIGN, payload, 4);
 }
 
-void hw_sync_assigns(CDCLSolver *s, int from_level) {
-    (void)from_level;
-    for (int var = 1; var <= s->num_vars; var++) {
-        if (s->assigns[var] == UNASSIGNED) {
-            hw_write_assign(var, UNASSIGNED);
-        }
+static void send_backtrack(int level) {
+    unsigned char payload[2];
+    HW_TRACE(HW_TRACE_EVENT, "[HW_SYNC] BACKTRACK level=%d\n", level);
+    payload[0] = (level >> 8) & 0xFF;
+    payload[1] = level & 0xFF;
+    jtag_send_cmd(CMD_BACKTRACK, payload, 2);
+}
+
+static void jtag_sync_assigns(CDCLSolver *s, int from_level) {
+    /* The FPGA unassigns everything above from_level from its own trail. */
+    if (from_level < HW_MAX_LEVELS) {
+        send_backtrack(from_level);
+        return;
+    }
+    /* Decisions past HW_MAX_LEVELS all share the FPGA's last level.  Empty
+     * it, reopen it and write back what the solver kept of it. */
+    send_backtrack(HW_MAX_LEVELS - 1);
+    jtag_assign(0, UNASSIGNED, true);
+    for (int t = s->trail_delimiters[HW_MAX_LEVELS - 1]; t < s->trail_size; t++) {
+        int var = s->trail[t] >> 1;
+        jtag_assign(var, cdcl_var_value(s, var), false);
+    }
+}
+
+/* Variables whose hardware value an implication overwrote with the opposite
+ * of the solver's value; rewritten once the BCP round is over. */
+static int *restore_vars = NULL;
+static int  restore_count = 0, restore_cap = 0;
+
+/* Take one implication from the accelerator.  Returns the hardware clause id
+ * of the clause it falsifies, or -1. */
+static int take_implication(CDCLSolver *s, const JTAGImpl *im) {
+    int var = (int)im->var;
+    int val = im->val ? 1 : 0;
+
+    HW_TRACE(HW_TRACE_EVENT, "[HW_PROP] IMPL: var=%d val=%d reason=%u\n",
+             var, val, im->reason_id);
+
+    if (cdcl_var_value(s, var) == UNASSIGNED) {
+        cdcl_imply(s, var, val, hw_db_cref((int)im->reason_id));
+        return -1;
+    }
+    if (cdcl_var_value(s, var) == val) return -1;  /* implied twice in one round */
+
+    /* The reason clause wants the opposite of the solver's value, so it is
+     * falsified.  The accelerator has already stored the wrong value. */
+    if (restore_count == restore_cap) {
+        restore_cap = restore_cap ? 2 * restore_cap : 16;
+        restore_vars = (int *)realloc(restore_vars, restore_cap * sizeof(int));
     }
+    restore_vars[restore_count++] = var;
+    return (int)im->reason_id;
 }
 
-int hw_propagate(CDCLSolver *s) {
+static CRef jtag_propagate(CDCLSolver *s) {
     unsigned char payload[2];
     JTAGResponse rsp;
 
-    while (s->prop_head < s->trail_size) {
-        int true_lit = s->trail[s->prop_head];
+    while (s->hw_head < s->trail_size) {
+        int true_lit = s->trail[s->hw_head];
         int false_lit = true_lit ^ 1;
 
+        /* No resident clause contains false_lit: nothing to evaluate. */
+        if (!hw_db_watched(false_lit)) {
+            s->hw_head++;
+            continue;
+        }
+
         /* Send BCP_START */
-        fprintf(stderr, "[HW_PROP] BCP_START false_lit=%d (true_lit=%d, var=%d)\n",
-                false_lit, true_lit, true_lit / 2);
+        HW_TRACE(HW_TRACE_EVENT, "[HW_PROP] BCP_START false_lit=%d (true_lit=%d, var=%d)\n",
+                 false_lit, true_lit, true_lit / 2);
         payload[0] = (false_lit >> 8) & 0xFF;
         payload[1] = false_lit & 0xFF;
         jtag_drscan(CMD_BCP_START, payload, 2, NULL);
 
-        /* Poll until not BUSY */
-        if (jtag_poll_status(&rsp) < 0) return -1;
+        /* Wait for the result (the first read carries BCP_START with it) */
+        if (jtag_poll_status(&rsp, false) < 0) return CREF_ERROR;
 
         int conflict_ci = -1;
         int done = 0;
 
         while (!done) {
-            switch (rsp.status) {
-            case RSP_IMPLICATION: {
-                int var    = rsp.var;
-                int hw_val = rsp.val;
-                int reason = rsp.reason_id;
-
-                fprintf(stderr, "[HW_PROP] IMPL: var=%d val=%d (hw=%d) reason=%d\n",
-                        var, (hw_val == HW_TRUE) ? 1 : 0, hw_val, reason);
-
-                int code;
-                if (hw_val == HW_TRUE)
-                    code = 2 * var;
-                else
-                    code = 2 * var + 1;
-
-                s->assigns[var] = (code & 1) ? 0 : 1;
-                s->levels[var]  = s->num_decisions;
-                s->reasons[var] = reason;
-                s->trail[s->trail_size++] = code;
+            if (rsp.status != RSP_IMPLICATION && rsp.status != RSP_DONE_OK &&
+                rsp.status != RSP_DONE_CONFLICT) {
+                fprintf(stderr, "hw_interface_jtag: unexpected status 0x%02X\n",
+                        rsp.status);
+                hw_trace_dump(stderr);
+                return CREF_ERROR;
+            }
 
-                hw_write_assign(var, s->assigns[var]);
+            /* A conflict does not cut the round short: the rest is still
+             * drained so the implication FIFO is empty for the next one. */
+            for (int i = 0; i < rsp.count; i++) {
+                int ci = take_implication(s, &rsp.impls[i]);
+                if (conflict_ci < 0) conflict_ci = ci;
+            }
 
-                /* Send ACK_IMPL and read next response */
-                fprintf(stderr, "[HW_PROP] Sending ACK_IMPL\n");
+            switch (rsp.status) {
+            case RSP_IMPLICATION:
+                /* Ask for the next burst and read it in the same request. */
+                HW_TRACE(HW_TRACE_EVENT, "[HW_PROP] Sending ACK_IMPL\n");
                 jtag_drscan(CMD_ACK_IMPL, NULL, 0, NULL);
-                /* Wait a bit for FSM to process */
-                usleep(100);
-                if (jtag_poll_status(&rsp) < 0) return -1;
+                if (jtag_poll_status(&rsp, false) < 0) return CREF_ERROR;
                 break;
-            }
+
             case RSP_DONE_OK:
-                fprintf(stderr, "[HW_PROP] DONE_OK\n");
+                HW_TRACE(HW_TRACE_EVENT, "[HW_PROP] DONE_OK\n");
                 done = 1;
                 break;
 
             case RSP_DONE_CONFLICT:
-                conflict_ci = rsp.reason_id;
-                fprintf(stderr, "[HW_PROP] DONE_CONFLICT clause_id=%d\n",
-                        conflict_ci);
+                HW_TRACE(HW_TRACE_EVENT, "[HW_PROP] DONE_CONFLICT clause_id=%u\n",
+                         rsp.clause_id);
+                if (conflict_ci < 0) conflict_ci = (int)rsp.clause_id;
                 done = 1;
                 break;
-
-            default:
-                fprintf(stderr, "hw_interface_jtag: unexpected status 0x%02X\n",
-                        rsp.status);
-                return -1;
             }
         }
 
+        /* Put back the solver's value where an implication contradicted it.
+         * The writes ride along with the next request. */
+        for (int i = 0; i < restore_count; i++) {
+            int var = restore_vars[i];
+            jtag_assign(var, cdcl_var_value(s, var), false);
+        }
+        restore_count = 0;
+
         if (conflict_ci >= 0) {
-            s->prop_head++;
-            return conflict_ci;
+            s->hw_head++;
+            return hw_db_cref(conflict_ci);
         }
 
-        s->prop_head++;
+        s->hw_head++;
     }
 
-    return -1;  /* no conflict */
+    return CREF_UNDEF;  /* no conflict */
 }
 
-#endif /* USE_HW_BCP */
+const BCPBackend bcp_backend_jtag = {
+    .name           = "jtag",
+    .desc           = "FPGA accelerator over JTAG (OpenOCD)",
+    .open           = jtag_open,
+    .init           = jtag_init,
+    .assign         = jtag_assign,
+    .sync           = jtag_sync_assigns,
+    .propagate      = jtag_propagate,
+    .close          = jtag_close,
+    .perf           = jtag_perf,
+    .learnt         = hw_db_add_learnt,
+    .reduced        = hw_db_drop_deleted,
+    .refs           = hw_db_refs,
+    .write_clause   = jtag_write_clause,
+    .write_wl_entry = jtag_write_wl_entry,
+    .write_wl_len   = jtag_write_wl_len,
+};
@@ -0,0 +1,214 @@
+/*
+ * hw_profile.c — Accelerator profiler: pipeline utilization against link time
+ *
+ * Usage:
+ *   ./hw_profile [-b jtag|sim] [-p port] [-i seconds] [-f MHz] [-e] <file.cnf>
+ *
+ * Solves the formula on an accelerator backend (default jtag) and samples
+ * the accelerator's performance counters (the backend's perf hook, see
+ * bcp_backend.h) every -i seconds (default 1) and once more at the end.
+ * Each sample prints one line for the interval since the previous one:
+ *
+ *   c prof [   2.0 s] host 0.912 s  link 0.850 s  fabric 0.012 s  drain 0.000 s
+ *                     | wlm 38.2%  stall 4.1%  pe 21.0% | 12034 rounds, ...
+ *
+ *   host    time in the backend's propagate hook: driver, link and FPGA
+ *   link    of that, time the driver spent in transport I/O
+ *   fabric  cycles the accelerator spent on BCP rounds
+ *   drain   cycles a full implication burst waited for the host
+ *   wlm     share of the busy cycles the watch list was still being fetched
+ *   stall   share of the busy cycles a queued clause waited for a PE
+ *   pe      share of the PEs' busy cycles spent holding a clause
+ *
+ * then the rounds, clauses evaluated per round, implications lost to a full
+ * FIFO and clauses skipped on their sat bit.  A last line sums up the whole
+ * solve.  When fabric is a small part of host, the time goes into the link
+ * and the driver, not the pipeline.
+ *
+ * Cycles become seconds at the clock measured by the FPGA's cycle counter
+ * against the wall clock; the sim backend has no cycle counter and uses -f
+ * (default 12 MHz, the ECP5 evaluation board's clock).
+ *
+ * The counters can only be read between BCP rounds, so the tool runs the
+ * solver on a copy of the backend whose propagate hook is timed and samples
+ * once the interval has passed, and its close hook takes the last sample.
+ * The link time includes the reads of the counters.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "CDCL.h"
+#include "dimacs.h"
+#include "bcp_backend.h"
+
+typedef struct {
+    double  t;              /* seconds since the start                  */
+    double  host;           /* seconds in the propagate hook so far     */
+    BCPPerf perf;
+} Sample;
+
+static const BCPBackend *inner;     /* the backend being profiled */
+static BCPBackend profiled;         /* its copy, with the hooks below */
+
+static double interval = 1.0;
+static double clock_hz = 12e6;      /* without a cycle counter (-f) */
+static double start_time, next_sample;
+static double host_seconds;
+static bool   sampling;             /* counters read at least once */
+static bool   disabled;             /* the backend has none */
+static Sample first, prev;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* 100 * a / b, or 0. */
+static inline double pct(uint64_t a, uint64_t b) {
+    return b ? 100.0 * (double)a / (double)b : 0.0;
+}
+
+/* Accelerator clock over the interval from `a` to `b`. */
+static double interval_hz(const Sample *a, const Sample *b) {
+    uint64_t cycles = b->perf.count[BCP_PERF_CYCLES] - a->perf.count[BCP_PERF_CYCLES];
+    double dt = b->t - a->t;
+    return cycles && dt > 0 ? (double)cycles / dt : clock_hz;
+}
+
+/* Print the interval from `a` to `b`. */
+static void print_interval(const char *label, const Sample *a, const Sample *b) {
+    uint64_t d[BCP_PERF_COUNTERS];
+    for (int i = 0; i < BCP_PERF_COUNTERS; i++) d[i] = b->perf.count[i] - a->perf.count[i];
+    double hz = interval_hz(a, b);
+    uint64_t active = d[BCP_PERF_ACTIVE];
+    int pes = b->perf.num_pes > 0 ? b->perf.num_pes : 1;
+
+    printf("c prof [%s] host %.3f s  link %.3f s  fabric %.3f s  drain %.3f s"
+           " | wlm %.1f%%  stall %.1f%%  pe %.1f%%"
+           " | %llu rounds, %.1f clauses/round, %llu fifo-full, %llu sat-skips\n",
+           label, b->host - a->host, b->perf.link_seconds - a->perf.link_seconds,
+           (double)active / hz, (double)d[BCP_PERF_DRAIN_WAIT] / hz,
+           pct(d[BCP_PERF_WLM_BUSY], active), pct(d[BCP_PERF_FETCH_STALL], active),
+           pct(d[BCP_PERF_PE_BUSY], active * (uint64_t)pes),
+           (unsigned long long)d[BCP_PERF_ROUNDS],
+           d[BCP_PERF_ROUNDS] ? (double)d[BCP_PERF_EVALUATED] / d[BCP_PERF_ROUNDS] : 0.0,
+           (unsigned long long)d[BCP_PERF_FIFO_FULL],
+           (unsigned long long)d[BCP_PERF_SAT_SKIPS]);
+    fflush(stdout);
+}
+
+/* Read the counters at time `t`; every sample after the first prints the
+ * interval since the previous one. */
+static void take_sample(double t) {
+    Sample cur;
+    cur.t    = t - start_time;
+    cur.host = host_seconds;
+    if (disabled) return;
+    if (inner->perf(&cur.perf) < 0) {
+        fprintf(stderr, "hw_profile: %s: cannot read the performance counters\n",
+                inner->name);
+        disabled = true;
+        return;
+    }
+    if (sampling) {
+        char label[32];
+        snprintf(label, sizeof(label), "%8.1f s", cur.t);
+        print_interval(label, &prev, &cur);
+    } else {
+        first = cur;
+        sampling = true;
+    }
+    prev = cur;
+    next_sample = t + interval;
+}
+
+static CRef profiled_propagate(CDCLSolver *s) {
+    double t0 = now_seconds();
+    if (!sampling) take_sample(t0);     /* the baseline, once open */
+    CRef conflict = inner->propagate(s);
+    double t1 = now_seconds();
+    host_seconds += t1 - t0;
+    if (t1 >= next_sample) take_sample(t1);
+    return conflict;
+}
+
+static void profiled_close(void) {
+    if (sampling) {
+        take_sample(now_seconds());
+        if (!disabled) {
+            double fabric = (double)(prev.perf.count[BCP_PERF_ACTIVE]
+                                     - first.perf.count[BCP_PERF_ACTIVE])
+                            / interval_hz(&first, &prev);
+            double host = prev.host - first.host;
+            print_interval("   total  ", &first, &prev);
+            printf("c prof: fabric time %.1f%% of the host time\n",
+                   host > 0 ? 100.0 * fabric / host : 0.0);
+        }
+    }
+    if (inner->close) inner->close();
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s [-b backend] [-p port] [-i sec] [-f MHz] [-e] <file.cnf>\n", prog);
+    fprintf(stderr, "  -b name   Accelerator backend with performance counters (default jtag)\n");
+    fprintf(stderr, "  -p port   The backend's port (see sat_solver -p)\n");
+    fprintf(stderr, "  -i sec    Seconds between samples (default 1)\n");
+    fprintf(stderr, "  -f MHz    Accelerator clock without a cycle counter (default 12)\n");
+    fprintf(stderr, "  -e        Preprocess first (see sat_solver -e)\n");
+    exit(1);
+}
+
+int main(int argc, char *argv[]) {
+    const char *backend = "jtag";
+    const char *port = NULL;
+    const char *filename = NULL;
+    int preprocess = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-b") == 0 && i + 1 < argc) {
+            backend = argv[++i];
+        } else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc) {
+            port = argv[++i];
+        } else if (strcmp(argv[i], "-i") == 0 && i + 1 < argc) {
+            interval = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+            clock_hz = atof(argv[++i]) * 1e6;
+        } else if (strcmp(argv[i], "-e") == 0) {
+            preprocess = 1;
+        } else if (argv[i][0] == '-' || filename) {
+            usage(argv[0]);
+        } else {
+            filename = argv[i];
+        }
+    }
+    if (!filename || interval <= 0 || clock_hz <= 0) usage(argv[0]);
+
+    inner = bcp_backend_find(backend);
+    if (!inner) {
+        fprintf(stderr, "Unknown backend '%s'\n", backend);
+        return 1;
+    }
+    if (!inner->propagate || !inner->perf) {
+        fprintf(stderr, "Backend '%s' has no performance counters\n", backend);
+        return 1;
+    }
+    profiled = *inner;
+    profiled.propagate = profiled_propagate;
+    profiled.close     = profiled_close;
+
+    CDCLSolver *s = cdcl_load_dimacs(filename, NULL);
+    if (!s) return 1;
+    cdcl_set_backend(s, &profiled, port);
+    if (preprocess) cdcl_preprocess(s);
+
+    start_time = now_seconds();
+    int result = cdcl_solve(s);
+    printf("s %s\n", result == SAT ? "SATISFIABLE" :
+                     result == UNSAT ? "UNSATISFIABLE" : "UNKNOWN");
+    cdcl_destroy(s);
+    return result == SAT ? 0 : 1;
+}
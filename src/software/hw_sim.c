@@ -0,0 +1,364 @@
+/*
+ * hw_sim.c — Cycle model of the BCP accelerator
+ *
+ * The "sim" BCP backend runs the accelerator in process.  Clause memory,
+ * watch lists and assignment memory (with the hardware trail) are arrays
+ * written by the same hooks the drivers implement, and a BCP round follows
+ * the RTL in src/hardware/modules/ clause by clause while counting the
+ * clock cycles the pipeline spends on it:
+ *
+ *   start      1   BCPAccelerator IDLE → ACTIVE, WatchListManager IDLE
+ *   FETCH_LEN  1   first watch list read in flight
+ *   STREAM     1   clause id i enters the ClauseDispatcher queue at 2 + i
+ *   dispatch       clause i leaves the queue at 3 + i at the earliest, one
+ *                  per cycle, once PE i mod SIM_NUM_PES is idle
+ *   prefetch   2   ClausePrefetcher, then the PE latches the clause
+ *   EVAL       1   all literals at once
+ *   OUTPUT     1+  until the result is taken: one UNIT per cycle
+ *   drain      1   in-flight counter back to zero (not after a conflict)
+ *   DONE       1
+ *
+ * An empty watch list takes 5 cycles.  A PE evaluates against the
+ * assignment memory as it was before its EVAL cycle, so it misses the
+ * implications other PEs report in that cycle or later; the host sorts out
+ * the repeats and contradictions that result, as it does with the FPGA.
+ * UNIT results are taken in evaluation order (the RTL grants the lowest
+ * PE first; with strict round robin the two rarely differ).  As in the
+ * RTL, a UNIT result is applied to the assignment memory only if the
+ * 16-entry ImplicationFIFO has room, and the round ends the cycle after the
+ * first CONFLICT, dropping results still waiting for the FIFO.  The FIFO
+ * is drained by the host after the round, so implications beyond 16 are
+ * dropped and left for a later round.
+ *
+ * Host transport is not modelled; the counters printed on close are
+ * accelerator cycles only.  The perf hook reports the FPGA's performance
+ * counters as the RTL would count them over the same rounds, except that
+ * there is no clock between rounds (BCP_PERF_CYCLES stays 0) and the host
+ * drains the FIFO at once (no drain wait).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "CDCL.h"
+#include "bcp_backend.h"
+#include "hw_clausedb.h"
+#include "hw_trace.h"
+
+#define SIM_FIFO_DEPTH 16   /* ImplicationFIFO depth */
+#define SIM_NUM_PES     4   /* evaluator PEs (BCPAccelerator num_pes) */
+
+/* ── Hardware assignment encoding ───────────────────────────────────────── */
+#define HW_UNASSIGNED 0
+#define HW_FALSE      1
+#define HW_TRUE       2
+
+/* ── Accelerator memories ───────────────────────────────────────────────── */
+
+typedef struct {
+    uint8_t  size;
+    uint16_t lits[HW_MAX_K];
+} SimClause;
+
+static SimClause clause_mem[HW_MAX_CLAUSES];
+static uint16_t  wl_mem[2 * HW_MAX_VARS][HW_MAX_WATCH];
+static uint8_t   wl_len[2 * HW_MAX_VARS];
+static uint8_t   assign_mem[HW_MAX_VARS];
+
+/* AssignmentMemory trail: variables assigned since reset, one checkpoint
+ * per decision level. */
+static uint16_t  hw_trail[HW_MAX_VARS];
+static int       hw_trail_len;
+static int       level_lim[HW_MAX_LEVELS];
+static int       cur_level;
+
+/* ImplicationFIFO contents after a round. */
+typedef struct {
+    int var;
+    int val;        /* 1 = TRUE */
+    int reason_id;
+} SimImpl;
+
+static SimImpl fifo[SIM_FIFO_DEPTH];
+static int     fifo_count;
+
+/* ── Counters ───────────────────────────────────────────────────────────── */
+
+static struct {
+    int64_t rounds;
+    int64_t cycles;
+    int64_t evaluated;      /* clauses through the evaluator      */
+    int64_t implications;   /* accepted by the FIFO               */
+    int64_t dropped;        /* UNIT results lost to a full FIFO   */
+    int64_t conflicts;
+    int64_t wlm_busy;       /* as the FPGA's performance counters */
+    int64_t fetch_stall;
+    int64_t pe_busy;
+} stats;
+
+/* ── Memory writes ──────────────────────────────────────────────────────── */
+
+static void mem_assign(int var, unsigned char hw_val) {
+    if (assign_mem[var] == HW_UNASSIGNED && hw_val != HW_UNASSIGNED)
+        hw_trail[hw_trail_len++] = (uint16_t)var;
+    assign_mem[var] = hw_val;
+}
+
+static inline unsigned char sw_to_hw_assign(int val) {
+    if (val == 1)  return HW_TRUE;
+    if (val == 0)  return HW_FALSE;
+    return HW_UNASSIGNED;
+}
+
+/* Value of literal `lit` in assignment memory: 1 true, 0 false, -1 unassigned. */
+static inline int lit_hw_value(int lit) {
+    unsigned char a = assign_mem[lit >> 1];
+    if (a == HW_UNASSIGNED) return -1;
+    return (a == HW_TRUE) == !(lit & 1);
+}
+
+/* ── One BCP round ──────────────────────────────────────────────────────── */
+
+/* A UNIT result waiting to be taken in cycle `at`. */
+typedef struct {
+    int     var, val, reason_id;
+    int64_t at;
+} SimUnit;
+
+/* Take the UNIT results in units[*head..count) granted before cycle
+ * `before`: into the FIFO and the assignment memory, if the FIFO has room. */
+static void take_units(const SimUnit *units, int *head, int count, int64_t before) {
+    for (; *head < count && units[*head].at < before; (*head)++) {
+        const SimUnit *u = &units[*head];
+        if (fifo_count == SIM_FIFO_DEPTH) {
+            stats.dropped++;
+            continue;
+        }
+        fifo[fifo_count].var       = u->var;
+        fifo[fifo_count].val       = u->val;
+        fifo[fifo_count].reason_id = u->reason_id;
+        fifo_count++;
+        mem_assign(u->var, u->val ? HW_TRUE : HW_FALSE);
+    }
+}
+
+/* Run the pipeline over the watch list of `false_lit`.  Fills fifo[] and
+ * returns the conflicting clause id, or -1. */
+static int sim_round(int false_lit) {
+    static SimUnit units[HW_MAX_WATCH];
+    int64_t pe_free[SIM_NUM_PES] = { 0 };   /* first cycle each PE is idle */
+    int64_t dispatch = 2;   /* cycle of the last dispatch                  */
+    int64_t granted = 0;    /* cycle of the last UNIT taken                */
+    int64_t last = 2;       /* cycle of the last result taken              */
+    int64_t cycles;
+    int conflict = -1;
+    int nunits = 0, taken = 0;
+
+    fifo_count = 0;
+    int n = wl_len[false_lit];
+    for (int i = 0; i < n; i++) {
+        int pe = i % SIM_NUM_PES;
+        int64_t d = dispatch + 1;
+        if (d < 3 + i) d = 3 + i;
+        if (d < pe_free[pe]) {
+            stats.fetch_stall += pe_free[pe] - d;   /* at the head, PE busy */
+            d = pe_free[pe];
+        }
+        dispatch = d;
+
+        int64_t eval = d + 3;
+        take_units(units, &taken, nunits, eval);
+
+        int id = wl_mem[false_lit][i];
+        const SimClause *c = &clause_mem[id];
+        stats.evaluated++;
+
+        bool sat = false;
+        int unassigned = 0, lastlit = 0;
+        for (int k = 0; k < c->size; k++) {
+            int v = lit_hw_value(c->lits[k]);
+            if (v == 1) sat = true;
+            if (v < 0) { unassigned++; lastlit = c->lits[k]; }
+        }
+
+        int64_t out = eval + 1;
+        if (!sat && unassigned == 0) {
+            conflict = id;
+            last = out;
+            stats.pe_busy += 2;
+            break;
+        }
+        if (!sat && unassigned == 1) {
+            if (out <= granted) out = granted + 1;
+            granted = out;
+            units[nunits].var       = lastlit >> 1;
+            units[nunits].val       = !(lastlit & 1);
+            units[nunits].reason_id = id;
+            units[nunits].at        = out;
+            nunits++;
+        }
+        pe_free[pe] = out + 1;
+        stats.pe_busy += out - eval + 1;   /* EVAL, then OUTPUT until taken */
+        if (out > last) last = out;
+    }
+
+    if (conflict >= 0) {
+        take_units(units, &taken, nunits, last + 1);
+        cycles = last + 2;      /* DONE */
+    } else {
+        take_units(units, &taken, nunits, INT64_MAX);
+        cycles = last + 3;      /* drain, DONE */
+    }
+
+    /* FETCH_LEN, STREAM (one cycle for an empty list) and DONE, within
+     * ACTIVE, which excludes the start and DONE cycles of the round. */
+    int64_t wlm = (n > 0 ? n : 1) + 2;
+    stats.wlm_busy += wlm < cycles - 2 ? wlm : cycles - 2;
+
+    stats.rounds++;
+    bcp_hw_scans++;
+    stats.cycles += cycles;
+    stats.implications += fifo_count;
+    if (conflict >= 0) stats.conflicts++;
+    return conflict;
+}
+
+/* ── Backend hooks ──────────────────────────────────────────────────────── */
+
+static int sim_open(const char *port) {
+    (void)port;
+    memset(clause_mem, 0, sizeof(clause_mem));
+    memset(wl_len, 0, sizeof(wl_len));
+    memset(assign_mem, 0, sizeof(assign_mem));
+    hw_trail_len = 0;
+    cur_level = 0;
+    memset(&stats, 0, sizeof(stats));
+    return 0;
+}
+
+static void sim_write_clause(int id, const int *lits, int size) {
+    clause_mem[id].size = (uint8_t)size;
+    for (int k = 0; k < size; k++) clause_mem[id].lits[k] = (uint16_t)lits[k];
+}
+
+static void sim_write_wl_entry(int lit, int idx, int id) {
+    wl_mem[lit][idx] = (uint16_t)id;
+}
+
+static void sim_write_wl_len(int lit, int len) {
+    wl_len[lit] = (uint8_t)len;
+}
+
+static void sim_assign(int var, int val, bool decision) {
+    if (decision && cur_level < HW_MAX_LEVELS) level_lim[cur_level++] = hw_trail_len;
+    if (var >= HW_MAX_VARS) return;
+    mem_assign(var, sw_to_hw_assign(val));
+}
+
+static void sim_init(CDCLSolver *s) {
+    hw_db_init(s, &bcp_backend_sim);
+    for (int var = 1; var <= s->num_vars && var < HW_MAX_VARS; var++)
+        sim_assign(var, cdcl_var_value(s, var), false);
+}
+
+/* AssignmentMemory BACKTRACK: pop the trail down to the checkpoint of
+ * `level`. */
+static void mem_backtrack(int level) {
+    if (level >= cur_level) return;
+    int lim = level_lim[level];
+    while (hw_trail_len > lim) assign_mem[hw_trail[--hw_trail_len]] = HW_UNASSIGNED;
+    cur_level = level;
+}
+
+static void sim_sync(CDCLSolver *s, int from_level) {
+    if (from_level < HW_MAX_LEVELS) {
+        mem_backtrack(from_level);
+        return;
+    }
+    /* As the JTAG driver: refill the shared last level. */
+    mem_backtrack(HW_MAX_LEVELS - 1);
+    sim_assign(0, UNASSIGNED, true);
+    for (int t = s->trail_delimiters[HW_MAX_LEVELS - 1]; t < s->trail_size; t++) {
+        int var = s->trail[t] >> 1;
+        sim_assign(var, cdcl_var_value(s, var), false);
+    }
+}
+
+static CRef sim_propagate(CDCLSolver *s) {
+    while (s->hw_head < s->trail_size) {
+        int false_lit = s->trail[s->hw_head++] ^ 1;
+        if (!hw_db_watched(false_lit)) continue;
+
+        HW_TRACE(HW_TRACE_EVENT, "[HW_SIM] BCP_START false_lit=%d\n", false_lit);
+        int round_conflict = sim_round(false_lit);
+        int conflict_id = -1;
+
+        /* Take the FIFO as the drivers take a burst: every entry is read,
+         * and the first one that contradicts the solver is the conflict.
+         * It comes before the round's CONFLICT: the contradicting write
+         * hid the solver's value from the PEs evaluating after it, so the
+         * round's clause need not be false under the solver's assignment. */
+        for (int i = 0; i < fifo_count; i++) {
+            const SimImpl *im = &fifo[i];
+            if (cdcl_var_value(s, im->var) == UNASSIGNED) {
+                cdcl_imply(s, im->var, im->val, hw_db_cref(im->reason_id));
+            } else if (cdcl_var_value(s, im->var) != im->val) {
+                /* Put the solver's value back, as the drivers do. */
+                mem_assign(im->var, sw_to_hw_assign(cdcl_var_value(s, im->var)));
+                if (conflict_id < 0) conflict_id = im->reason_id;
+            }
+        }
+        if (conflict_id < 0) conflict_id = round_conflict;
+
+        if (conflict_id >= 0) {
+            HW_TRACE(HW_TRACE_EVENT, "[HW_SIM] conflict clause_id=%d\n", conflict_id);
+            return hw_db_cref(conflict_id);
+        }
+    }
+    return CREF_UNDEF;
+}
+
+static void sim_close(void) {
+    hw_db_free();
+    printf("c sim: %lld BCP rounds, %lld cycles (%.1f per round), "
+           "%lld clauses evaluated\n",
+           (long long)stats.rounds, (long long)stats.cycles,
+           stats.rounds ? (double)stats.cycles / stats.rounds : 0.0,
+           (long long)stats.evaluated);
+    printf("c sim: %lld implications, %lld dropped (FIFO full), %lld conflicts\n",
+           (long long)stats.implications, (long long)stats.dropped,
+           (long long)stats.conflicts);
+}
+
+static int sim_perf(BCPPerf *out) {
+    memset(out, 0, sizeof(*out));
+    out->count[BCP_PERF_ROUNDS]      = (uint64_t)stats.rounds;
+    out->count[BCP_PERF_ACTIVE]      = (uint64_t)(stats.cycles - 2 * stats.rounds);
+    out->count[BCP_PERF_WLM_BUSY]    = (uint64_t)stats.wlm_busy;
+    out->count[BCP_PERF_FETCH_STALL] = (uint64_t)stats.fetch_stall;
+    out->count[BCP_PERF_PE_BUSY]     = (uint64_t)stats.pe_busy;
+    out->count[BCP_PERF_EVALUATED]   = (uint64_t)stats.evaluated;
+    out->count[BCP_PERF_FIFO_FULL]   = (uint64_t)stats.dropped;
+    out->num_pes = SIM_NUM_PES;
+    return 0;
+}
+
+const BCPBackend bcp_backend_sim = {
+    .name           = "sim",
+    .desc           = "in-process cycle model of the accelerator",
+    .open           = sim_open,
+    .init           = sim_init,
+    .assign         = sim_assign,
+    .sync           = sim_sync,
+    .propagate      = sim_propagate,
+    .close          = sim_close,
+    .perf           = sim_perf,
+    .learnt         = hw_db_add_learnt,
+    .reduced        = hw_db_drop_deleted,
+    .refs           = hw_db_refs,
+    .write_clause   = sim_write_clause,
+    .write_wl_entry = sim_write_wl_entry,
+    .write_wl_len   = sim_write_wl_len,
+};
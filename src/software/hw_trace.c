@@ -0,0 +1,47 @@
+/*
+ * hw_trace.c — Trace level and transaction ring for the hardware drivers
+ *
+ * See hw_trace.h.  Shared by the UART and JTAG drivers.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "hw_trace.h"
+
+int hw_trace_level = HW_TRACE_OFF;
+
+#if HW_TRACE_RING > 0
+
+static HWTraceRecord ring[HW_TRACE_RING];
+static uint32_t      ring_count = 0;    /* frames recorded so far */
+
+void hw_trace_record(int dir, const unsigned char *data, int len) {
+    HWTraceRecord *r = &ring[ring_count & (HW_TRACE_RING - 1)];
+    if (len > (int)sizeof(r->data)) len = (int)sizeof(r->data);
+    r->index = ring_count++;
+    r->dir   = (unsigned char)dir;
+    r->len   = (unsigned char)len;
+    memcpy(r->data, data, (size_t)len);
+}
+
+void hw_trace_dump(FILE *f) {
+    uint32_t first = ring_count > HW_TRACE_RING ? ring_count - HW_TRACE_RING : 0;
+    fprintf(f, "hw_trace: last %u of %u frames\n",
+            (unsigned)(ring_count - first), (unsigned)ring_count);
+    for (uint32_t i = first; i < ring_count; i++) {
+        const HWTraceRecord *r = &ring[i & (HW_TRACE_RING - 1)];
+        fprintf(f, "  #%-8u %s ", (unsigned)r->index,
+                r->dir == HW_TRACE_TX ? "TX" : "RX");
+        for (int k = 0; k < r->len; k++) fprintf(f, "%02x", r->data[k]);
+        fputc('\n', f);
+    }
+}
+
+#else
+
+void hw_trace_dump(FILE *f) {
+    (void)f;
+}
+
+#endif /* HW_TRACE_RING > 0 */
@@ -0,0 +1,77 @@
+/*
+ * hw_trace.h — Trace logging for the hardware BCP drivers
+ *
+ * Two independent facilities, both compiled out by default:
+ *
+ *   Leveled text trace.  HW_TRACE(level, fmt, ...) prints to stderr when
+ *   `level` is at most both the compile-time ceiling HW_TRACE_MAX and the
+ *   runtime level hw_trace_level (CLI flag -t).  With HW_TRACE_MAX 0 the
+ *   condition is a constant and the call, its arguments and any formatting
+ *   vanish from the binary.
+ *
+ *   Transaction ring.  With HW_TRACE_RING set to N (a power of two), every
+ *   raw frame exchanged with the FPGA is copied into a ring of the last N
+ *   records.  This costs a 16-byte copy per frame and no I/O; the ring is
+ *   only formatted by hw_trace_dump(), which the drivers call when they
+ *   give up on the hardware.
+ *
+ * Build with e.g. `make hw HW_TRACE=2 HW_TRACE_RING=256`.
+ */
+
+#ifndef HW_TRACE_H
+#define HW_TRACE_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+/* ── Trace levels ───────────────────────────────────────────────────────── */
+#define HW_TRACE_OFF    0
+#define HW_TRACE_EVENT  1   /* BCP start, implications, done/conflict    */
+#define HW_TRACE_SCAN   2   /* every frame sent/received, every poll      */
+
+#ifndef HW_TRACE_MAX
+#define HW_TRACE_MAX    HW_TRACE_OFF
+#endif
+
+#ifndef HW_TRACE_RING
+#define HW_TRACE_RING   0
+#endif
+
+#if HW_TRACE_RING & (HW_TRACE_RING - 1)
+#error "HW_TRACE_RING must be a power of two"
+#endif
+
+/* Runtime trace level (default HW_TRACE_OFF); levels above HW_TRACE_MAX
+ * have no effect. */
+extern int hw_trace_level;
+
+#define HW_TRACE_ON(level) \
+    ((level) <= HW_TRACE_MAX && (level) <= hw_trace_level)
+
+#define HW_TRACE(level, ...)                                        \
+    do {                                                            \
+        if (HW_TRACE_ON(level)) fprintf(stderr, __VA_ARGS__);       \
+    } while (0)
+
+/* ── Transaction ring ───────────────────────────────────────────────────── */
+#define HW_TRACE_TX     0   /* host → FPGA */
+#define HW_TRACE_RX     1   /* FPGA → host */
+
+typedef struct {
+    uint32_t      index;    /* running frame number                        */
+    unsigned char dir;      /* HW_TRACE_TX or HW_TRACE_RX                  */
+    unsigned char len;      /* valid bytes in data                         */
+    unsigned char data[16];
+} HWTraceRecord;
+
+#if HW_TRACE_RING > 0
+void hw_trace_record(int dir, const unsigned char *data, int len);
+#define HW_TRACE_RECORD(dir, data, len) hw_trace_record((dir), (data), (len))
+#else
+#define HW_TRACE_RECORD(dir, data, len) ((void)0)
+#endif
+
+/* Print the ring, oldest record first.  Does nothing without a ring. */
+void hw_trace_dump(FILE *f);
+
+#endif /* HW_TRACE_H */
@@ -1,46 +1,196 @@
 /*
  * main.c — DIMACS CNF Reader and SAT Solver Runner
  *
- * Reads a CNF formula in DIMACS format from a file, creates a CDCL solver,
- * adds all clauses, runs the solver, and prints the result.
+ * Reads a CNF formula in DIMACS format from a file (optionally gzip- or
+ * xz-compressed) with cdcl_load_dimacs(), runs the solver, and prints the
+ * result.
  *
  * Usage:
- *   ./sat_solver [-p /dev/cu.usbserial-XXX] <file.cnf>
+ *   ./sat_solver [-b sw|jtag|uart|sim[,...]] [-p /dev/cu.usbserial-XXX[@baud]]
+ *                [-r luby|glucose|none] [-P saved|true|false|random|target]
+ *                [-s seed] [-t level] [-j threads] [-e] [-S seconds]
+ *                [-d proof | -D proof] <file.cnf>
+ *   ./sat_solver -B jobs-dir|-|unix:socket [-j workers] [other flags] 
  *
- * The -p flag is only relevant when compiled with -DUSE_HW_BCP.
+ * The -b flag selects the BCP backend (see bcp_backend.h; default: sw, or
+ * jtag / uart for the sat_solver_hw / sat_solver_hw_uart builds).  Given a
+ * comma-separated list, the formula is solved once with each backend in
+ * turn; the answers are checked against each other and each run's time is
+ * reported on a `c` line, while the `s`/`v` output comes from the first.
+ * The load time and the first run's search time, conflicts and
+ * propagations are printed on `c` lines as well (test/bench/bench.py reads
+ * them).
+ * The -p flag is the UART backend's serial port (optionally @baud, which
+ * must match the bitstream; default 1000000), or for the JTAG backend
+ * the [host:]port of an OpenOCD TCL server that is already running (without
+ * it the driver starts its own OpenOCD); -t sets the driver trace level
+ * (see hw_trace.h).
+ * The -r flag selects the restart strategy (default: glucose), -P the
+ * decision polarity (default: saved) and -s the random seed.  With -j, a
+ * portfolio of that many solvers runs on as many threads (see portfolio.h);
+ * the first uses the flags above and the selected backend.  -e simplifies
+ * the formula first with cdcl_preprocess() (subsumption and variable
+ * elimination) and reports the clauses left on a `c` line.  The first
+ * run's search statistics (cdcl_print_stats()) are printed at exit, and
+ * with -S a progress line every that many seconds as well.
+ * -d writes a binary DRAT proof of an UNSAT answer to the given file ("-"
+ * for standard output), -D the same in the text format (see proof.h); the
+ * proof comes from the first backend's run, and cannot be combined with -j.
+ * -B runs many jobs in one process instead of one file (see batch.h): the
+ * CNF files of a directory, the paths read from standard input ("-"), or
+ * those sent to a Unix socket ("unix:PATH", a server).  There -j sets the
+ * number of solver threads, each taking jobs of its own, and the first
+ * uses the selected backend.
+ *
+ * The answer is an `s` line: SATISFIABLE, UNSATISFIABLE, or UNKNOWN when
+ * there is none (a backend that cannot be opened or stops answering).  The
+ * exit status is 0 for SAT, 1 for UNSAT or an input error, 2 if the
+ * backends disagree and 3 for UNKNOWN.
  *
  * DIMACS format:
  *   c comment lines (ignored)
  *   p cnf <num_vars> <num_clauses>
  *   1 -2 3 0        <- clause (x1 v ~x2 v x3), terminated by 0
  *   -1 2 0          <- clause (~x1 v x2)
+ *   % (optional SATLIB end marker)
  */
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 #include "CDCL.h"
+#include "dimacs.h"
+#include "bcp_backend.h"
+#include "hw_clausedb.h"
+#include "hw_trace.h"
+#include "portfolio.h"
+#include "proof.h"
+#include "batch.h"
 
-#ifdef USE_HW_BCP
-#include "hw_interface.h"
+/* Backend used when -b is not given. */
+#ifndef BCP_DEFAULT_BACKEND
+#define BCP_DEFAULT_BACKEND "sw"
 #endif
 
+#define MAX_BACKENDS 8  /* entries in a -b list */
+
 static void usage(const char *prog) {
-    fprintf(stderr, "Usage: %s [-p port] <file.cnf>\n", prog);
-    fprintf(stderr, "  -p port   Serial port for FPGA hardware BCP (requires USE_HW_BCP build)\n");
+    fprintf(stderr, "Usage: %s [-b backend[,backend...]] [-p port] <file.cnf>\n", prog);
+    fprintf(stderr, "       %s -B dir|-|unix:path [-j workers] ...\n", prog);
+    fprintf(stderr, "  -b list   BCP backends (default %s):", BCP_DEFAULT_BACKEND);
+    for (int i = 0; bcp_backends[i]; i++) fprintf(stderr, " %s", bcp_backends[i]->name);
+    fprintf(stderr, "\n");
+    fprintf(stderr, "  -p port   Serial port[@baud] for the uart backend, or [host:]port of a\n"
+                    "            running OpenOCD TCL server for the jtag backend\n");
+    fprintf(stderr, "  -r mode   Restart strategy: luby, glucose (default) or none\n");
+    fprintf(stderr, "  -P mode   Decision polarity: saved (default), true, false, random or target\n");
+    fprintf(stderr, "  -s seed   Random seed (used by -P random)\n");
+    fprintf(stderr, "  -t level  Hardware driver trace: 0 off, 1 events, 2 every scan\n");
+    fprintf(stderr, "  -j n      Portfolio of n solver threads sharing learnt clauses\n");
+    fprintf(stderr, "  -e        Preprocess: subsumption and bounded variable elimination\n");
+    fprintf(stderr, "  -S sec    Print search statistics every sec seconds\n");
+    fprintf(stderr, "  -d file   Write a binary DRAT proof of UNSAT to file (- for stdout)\n");
+    fprintf(stderr, "  -D file   The same as -d in the text DRAT format\n");
+    fprintf(stderr, "  -B jobs   Batch mode: the CNF files of a directory, paths on stdin (-)\n"
+                    "            or a server on a Unix socket (unix:path); -j sets the workers\n");
     exit(1);
 }
 
+/* Split the comma-separated backend list `list` (modified) into `out`.
+ * Returns the number of backends, or -1 on an unknown name. */
+static int parse_backends(char *list, const BCPBackend **out) {
+    int n = 0;
+    for (char *name = strtok(list, ","); name; name = strtok(NULL, ",")) {
+        const BCPBackend *b = bcp_backend_find(name);
+        if (!b) {
+            fprintf(stderr, "Unknown backend '%s'\n", name);
+            return -1;
+        }
+        if (n == MAX_BACKENDS) {
+            fprintf(stderr, "At most %d backends per run\n", MAX_BACKENDS);
+            return -1;
+        }
+        out[n++] = b;
+    }
+    return n;
+}
+
+/* Answer of a cdcl_solve() result, as on the `s` line. */
+static const char *result_name(int result) {
+    if (result == SAT)   return "SATISFIABLE";
+    if (result == UNSAT) return "UNSATISFIABLE";
+    return "UNKNOWN";
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
 int main(int argc, char *argv[]) {
     const char *port = NULL;
     const char *filename = NULL;
+    char backend_list[256] = BCP_DEFAULT_BACKEND;
+    RestartPolicy restart = RESTART_GLUCOSE;
+    PolarityMode polarity = POLARITY_SAVED;
+    unsigned long long seed = 0;
+    int trace = -1;
+    int threads = 1;
+    int preprocess = 0;
+    double stats_interval = 0;
+    const char *proof_path = NULL;
+    bool proof_binary = true;
+    const char *batch_source = NULL;
 
     /* Parse arguments */
     for (int i = 1; i < argc; i++) {
-        if (strcmp(argv[i], "-p") == 0) {
+        if (strcmp(argv[i], "-b") == 0) {
+            if (i + 1 >= argc) usage(argv[0]);
+            snprintf(backend_list, sizeof(backend_list), "%s", argv[++i]);
+        } else if (strcmp(argv[i], "-p") == 0) {
             if (i + 1 >= argc) usage(argv[0]);
             port = argv[++i];
+        } else if (strcmp(argv[i], "-r") == 0) {
+            if (i + 1 >= argc) usage(argv[0]);
+            const char *mode = argv[++i];
+            if (strcmp(mode, "luby") == 0)         restart = RESTART_LUBY;
+            else if (strcmp(mode, "glucose") == 0) restart = RESTART_GLUCOSE;
+            else if (strcmp(mode, "none") == 0)    restart = RESTART_NONE;
+            else usage(argv[0]);
+        } else if (strcmp(argv[i], "-P") == 0) {
+            if (i + 1 >= argc) usage(argv[0]);
+            const char *mode = argv[++i];
+            if (strcmp(mode, "saved") == 0)       polarity = POLARITY_SAVED;
+            else if (strcmp(mode, "true") == 0)   polarity = POLARITY_TRUE;
+            else if (strcmp(mode, "false") == 0)  polarity = POLARITY_FALSE;
+            else if (strcmp(mode, "random") == 0) polarity = POLARITY_RANDOM;
+            else if (strcmp(mode, "target") == 0) polarity = POLARITY_TARGET;
+            else usage(argv[0]);
+        } else if (strcmp(argv[i], "-s") == 0) {
+            if (i + 1 >= argc) usage(argv[0]);
+            seed = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "-t") == 0) {
+            if (i + 1 >= argc) usage(argv[0]);
+            trace = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-j") == 0) {
+            if (i + 1 >= argc) usage(argv[0]);
+            threads = atoi(argv[++i]);
+            if (threads < 1) usage(argv[0]);
+        } else if (strcmp(argv[i], "-e") == 0) {
+            preprocess = 1;
+        } else if (strcmp(argv[i], "-S") == 0) {
+            if (i + 1 >= argc) usage(argv[0]);
+            stats_interval = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-d") == 0 || strcmp(argv[i], "-D") == 0) {
+            if (i + 1 >= argc) usage(argv[0]);
+            proof_binary = argv[i][1] == 'd';
+            proof_path = argv[++i];
+        } else if (strcmp(argv[i], "-B") == 0) {
+            if (i + 1 >= argc) usage(argv[0]);
+            batch_source = argv[++i];
         } else if (argv[i][0] == '-') {
             usage(argv[0]);
         } else {
@@ -48,107 +198,127 @@ int main(int argc, char *argv[]) {
         }
     }
 
-    if (!filename) usage(argv[0]);
-
-#ifdef USE_HW_BCP
-    hw_port = port;
-#else
-    if (port) {
-        fprintf(stderr, "Warning: -p flag ignored (not compiled with USE_HW_BCP)\n");
+    if (!filename && !batch_source) usage(argv[0]);
+    if (proof_path && threads > 1) {
+        fprintf(stderr, "A proof cannot be written for a portfolio (-j) run\n");
+        return 1;
     }
-#endif
 
-    /* Open the CNF file */
-    FILE *fp = fopen(filename, "r");
-    if (!fp) {
-        perror(filename);
-        return 1;
+    const BCPBackend *backends[MAX_BACKENDS];
+    int num_backends = parse_backends(backend_list, backends);
+    if (num_backends <= 0) usage(argv[0]);
+
+    if (trace >= 0) {
+        if (trace > HW_TRACE_MAX)
+            fprintf(stderr, "Warning: trace level %d not compiled in (HW_TRACE=%d)\n",
+                    trace, HW_TRACE_MAX);
+        hw_trace_level = trace;
     }
 
-    int num_vars = 0, num_clauses = 0;
-    int header_found = 0;
-    char line[4096];
-
-    /* Parse header */
-    while (fgets(line, sizeof(line), fp)) {
-        if (line[0] == 'c' || line[0] == '\n' || line[0] == '\r')
-            continue;
-        if (line[0] == 'p') {
-            if (sscanf(line, "p cnf %d %d", &num_vars, &num_clauses) != 2) {
-                fprintf(stderr, "Error: malformed p-line: %s", line);
-                fclose(fp);
-                return 1;
-            }
-            header_found = 1;
-            break;
+    if (batch_source) {
+        if (num_backends > 1 || proof_path || filename) {
+            fprintf(stderr, "-B takes one backend, no proof and no CNF file\n");
+            return 1;
         }
+        BatchConfig cfg = {
+            .workers    = threads,
+            .backend    = backends[0],
+            .port       = port,
+            .restart    = restart,
+            .polarity   = polarity,
+            .seed       = seed,
+            .preprocess = preprocess,
+            .models     = true,
+        };
+        return batch_run(batch_source, &cfg) == 0 ? 0 : 1;
     }
 
-    if (!header_found) {
-        fprintf(stderr, "Error: no 'p cnf ...' header found\n");
-        fclose(fp);
-        return 1;
-    }
+    Proof *proof = NULL;
+    if (proof_path && !(proof = proof_open(proof_path, proof_binary))) return 1;
 
-#ifdef USE_HW_BCP
-    if (num_vars > 512)
-        fprintf(stderr, "Warning: %d variables exceeds hardware limit (512)\n", num_vars);
-    if (num_clauses > 8192)
-        fprintf(stderr, "Warning: %d clauses exceeds hardware limit (8192)\n", num_clauses);
-#endif
+    /* Solve with each backend in turn, each on a freshly loaded formula. */
+    CDCLSolver *first = NULL;
+    int first_result = UNSAT;
+    int num_vars = 0;
+    int disagree = 0;
+    int noted = 0;
 
-    /* Create solver */
-    CDCLSolver *s = cdcl_create(num_vars);
-
-    /* Parse clauses */
-    int *lits = (int *)malloc(num_vars * sizeof(int));
-    int lit_count = 0;
-    int clauses_read = 0;
-    int lit;
-
-    while (fscanf(fp, "%d", &lit) == 1) {
-        if (lit == 0) {
-            /* End of clause */
-#ifdef USE_HW_BCP
-            if (lit_count > 5)
-                fprintf(stderr, "Warning: clause %d has %d literals (hardware max is 5)\n",
-                        clauses_read, lit_count);
-#endif
-            cdcl_add_clause(s, lits, lit_count);
-            lit_count = 0;
-            clauses_read++;
-        } else {
-            if (lit_count >= num_vars) {
-                /* Grow buffer if needed */
-                lits = (int *)realloc(lits, (lit_count + 1) * sizeof(int));
-            }
-            lits[lit_count++] = lit;
+    for (int b = 0; b < num_backends; b++) {
+        /* Load the CNF file (plain, gzip or xz) */
+        DimacsInfo info;
+        double load_start = now_seconds();
+        CDCLSolver *s = cdcl_load_dimacs(filename, &info);
+        if (!s) return 1;
+        if (b == 0) printf("c load: %.3f s\n", now_seconds() - load_start);
+        cdcl_set_restart(s, restart);
+        cdcl_set_polarity(s, polarity);
+        if (seed) cdcl_set_seed(s, seed);
+        cdcl_set_backend(s, backends[b], port);
+        if (b == 0) cdcl_set_stats_interval(s, stats_interval);
+        if (b == 0) cdcl_set_proof(s, proof);
+
+        if (b == 0 && info.clauses_read != info.num_clauses) {
+            fprintf(stderr, "Warning: header declared %d clauses, read %d\n",
+                    info.num_clauses, info.clauses_read);
         }
-    }
 
-    /* Handle trailing clause without final 0 */
-    if (lit_count > 0) {
-        cdcl_add_clause(s, lits, lit_count);
-        clauses_read++;
-    }
+        /* Whatever does not fit the accelerator is propagated in software. */
+        if (backends[b]->propagate && !noted) {
+            noted = 1;
+            if (info.num_vars >= HW_MAX_VARS)
+                fprintf(stderr, "Note: %d variables; clauses over variables %d and up "
+                        "are propagated in software\n", info.num_vars, HW_MAX_VARS);
+            if (info.clauses_read > HW_MAX_CLAUSES)
+                fprintf(stderr, "Note: %d clauses; those beyond the hardware's %d "
+                        "are propagated in software\n", info.clauses_read, HW_MAX_CLAUSES);
+            if (info.max_clause_len > HW_MAX_K)
+                fprintf(stderr, "Note: clauses of more than %d literals (up to %d) "
+                        "are propagated in software\n", HW_MAX_K, info.max_clause_len);
+        }
+
+        /* Solve */
+        double start = now_seconds();
+        if (preprocess) {
+            int before = s->clause_count;
+            cdcl_preprocess(s);
+            if (b == 0)
+                printf("c preprocess: %d -> %d clauses, %d variables eliminated, %.3f s\n",
+                       before, s->clause_count, s->num_eliminated, now_seconds() - start);
+        }
+        int result = cdcl_solve_portfolio(s, threads);
+        double elapsed = now_seconds() - start;
 
-    free(lits);
-    fclose(fp);
+        if (num_backends > 1) {
+            printf("c %s: %s in %.3f s\n", backends[b]->name, result_name(result), elapsed);
+        }
 
-    if (clauses_read != num_clauses) {
-        fprintf(stderr, "Warning: header declared %d clauses, read %d\n",
-                num_clauses, clauses_read);
+        if (b == 0) {
+            CDCLStats st;
+            cdcl_get_stats(s, &st);
+            printf("c search: %.3f s, %lld conflicts, %lld propagations\n", elapsed,
+                   (long long)st.conflicts, (long long)st.propagations);
+            first = s;
+            first_result = result;
+            num_vars = info.num_vars;
+        } else {
+            if (result != first_result) {
+                fprintf(stderr, "Error: backends %s and %s disagree\n",
+                        backends[0]->name, backends[b]->name);
+                disagree = 1;
+            }
+            cdcl_destroy(s);
+        }
     }
 
-    /* Solve */
-    int result = cdcl_solve(s);
+    if (proof) proof_close(proof);
+    cdcl_print_stats(first, stdout);
 
     /* Output result in DIMACS format */
-    if (result == SAT) {
+    if (first_result == SAT) {
         printf("s SATISFIABLE\n");
         printf("v ");
         for (int v = 1; v <= num_vars; v++) {
-            int val = cdcl_get_value(s, v);
+            int val = cdcl_get_value(first, v);
             if (val == 1)
                 printf("%d ", v);
             else
@@ -156,9 +326,11 @@ int main(int argc, char *argv[]) {
         }
         printf("0\n");
     } else {
-        printf("s UNSATISFIABLE\n");
+        printf("s %s\n", result_name(first_result));
     }
 
-    cdcl_destroy(s);
-    return (result == SAT) ? 0 : 1;
+    cdcl_destroy(first);
+    if (disagree) return 2;
+    if (first_result == UNKNOWN) return 3;
+    return (first_result == SAT) ? 0 : 1;
 }
@@ -0,0 +1,262 @@
+/*
+ * portfolio.c — Multi-threaded portfolio solving with clause sharing
+ *
+ * See portfolio.h.
+ *
+ * Ring layout: each entry is [len][lbd][lits...] in consecutive words
+ * (wrapping around the end of the buffer).  The owner writes the words and
+ * then publishes them by advancing `head` with a release store.  A reader
+ * keeps its own position per ring and checks `head` again after copying an
+ * entry: if the writer may have reached the words it read, the copy is
+ * thrown away.  Entries never exceed SHARE_ENTRY_MAX words, so a reader at
+ * most SHARE_RING_WORDS - SHARE_ENTRY_MAX words behind `head` reads words
+ * that nobody is writing.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#include "CDCL.h"
+#include "portfolio.h"
+
+#define SHARE_ENTRY_MAX (2 + SHARE_CLAUSE_MAX)
+#define SHARE_RING_MASK ((uint64_t)SHARE_RING_WORDS - 1)
+
+/* Cache line size: data written by different workers never shares one. */
+#define SHARE_CACHE_LINE 64
+
+/* ========================================================================= */
+/*  Clause exchange                                                          */
+/* ========================================================================= */
+
+/* `head` is polled by the readers while the owner fills `buf`, so the two
+ * are on separate lines. */
+typedef struct {
+    _Alignas(SHARE_CACHE_LINE) _Atomic uint64_t head;   /* words written, ever */
+    _Alignas(SHARE_CACHE_LINE) _Atomic int buf[SHARE_RING_WORDS]; /* see above */
+} ShareRing;
+
+/* Read state of one worker, written on every share_pull().  Each worker's
+ * is padded to whole cache lines (`reader_size` bytes). */
+typedef struct {
+    int      next;          /* next ring to read from                       */
+    uint64_t tail[];        /* read position in the ring of each worker     */
+} ShareReader;
+
+struct ClauseShare {
+    int        workers;
+    ShareRing *rings;       /* one per worker, written by that worker       */
+    char      *readers;     /* one ShareReader per worker                   */
+    size_t     reader_size;
+};
+
+static inline ShareReader *share_reader(ClauseShare *sh, int to) {
+    return (ShareReader *)(sh->readers + (size_t)to * sh->reader_size);
+}
+
+/* Zeroed memory of `size` bytes, a multiple of SHARE_CACHE_LINE, starting
+ * on a cache line. */
+static void *alloc_lines(size_t size) {
+    void *p = aligned_alloc(SHARE_CACHE_LINE, size);
+    if (p) memset(p, 0, size);
+    return p;
+}
+
+ClauseShare *share_create(int workers) {
+    ClauseShare *sh = (ClauseShare *)calloc(1, sizeof(ClauseShare));
+    sh->workers     = workers;
+    sh->rings       = (ShareRing *)alloc_lines((size_t)workers * sizeof(ShareRing));
+    sh->reader_size = (sizeof(ShareReader) + (size_t)workers * sizeof(uint64_t)
+                       + SHARE_CACHE_LINE - 1) & ~(size_t)(SHARE_CACHE_LINE - 1);
+    sh->readers     = (char *)alloc_lines((size_t)workers * sh->reader_size);
+    return sh;
+}
+
+void share_destroy(ClauseShare *sh) {
+    if (!sh) return;
+    free(sh->rings);
+    free(sh->readers);
+    free(sh);
+}
+
+void share_push(ClauseShare *sh, int from, const int *lits, int len, int lbd) {
+    if (len > SHARE_CLAUSE_MAX) return;
+    if (len > SHARE_MAX_LEN && lbd > SHARE_MAX_LBD) return;
+
+    ShareRing *r = &sh->rings[from];
+    uint64_t pos = atomic_load_explicit(&r->head, memory_order_relaxed);
+    /* Seqlock writer: the words below may overwrite an entry a reader is
+     * copying; order them after the head it will recheck (see
+     * share_read()). */
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&r->buf[pos & SHARE_RING_MASK], len, memory_order_relaxed);
+    atomic_store_explicit(&r->buf[(pos + 1) & SHARE_RING_MASK], lbd, memory_order_relaxed);
+    for (int i = 0; i < len; i++)
+        atomic_store_explicit(&r->buf[(pos + 2 + i) & SHARE_RING_MASK], lits[i],
+                              memory_order_relaxed);
+    atomic_store_explicit(&r->head, pos + 2 + len, memory_order_release);
+}
+
+/* Copy the entry at the reader's position in ring `from`.  Returns its
+ * length, 0 if the ring has nothing new, or -1 if the copy was torn. */
+static int share_read(ClauseShare *sh, int to, int from, int *lits, int *lbd) {
+    ShareRing *r = &sh->rings[from];
+    uint64_t *tail = &share_reader(sh, to)->tail[from];
+    uint64_t head = atomic_load_explicit(&r->head, memory_order_acquire);
+    if (*tail == head) return 0;
+    if (head - *tail > SHARE_RING_WORDS - SHARE_ENTRY_MAX) {
+        *tail = head;   /* lapped: skip what was overwritten */
+        return 0;
+    }
+
+    uint64_t pos = *tail;
+    int len = atomic_load_explicit(&r->buf[pos & SHARE_RING_MASK], memory_order_relaxed);
+    *lbd    = atomic_load_explicit(&r->buf[(pos + 1) & SHARE_RING_MASK], memory_order_relaxed);
+    if (len < 1 || len > SHARE_CLAUSE_MAX) len = 0;
+    for (int i = 0; i < len; i++)
+        lits[i] = atomic_load_explicit(&r->buf[(pos + 2 + i) & SHARE_RING_MASK],
+                                       memory_order_relaxed);
+
+    /* Valid only if the writer cannot have started on these words. */
+    atomic_thread_fence(memory_order_acquire);
+    uint64_t now = atomic_load_explicit(&r->head, memory_order_relaxed);
+    if (len == 0 || now - pos > SHARE_RING_WORDS - SHARE_ENTRY_MAX) {
+        *tail = now;
+        return -1;
+    }
+    *tail = pos + 2 + len;
+    return len;
+}
+
+bool share_pending(ClauseShare *sh, int to) {
+    const ShareReader *rd = share_reader(sh, to);
+    for (int from = 0; from < sh->workers; from++) {
+        if (from != to &&
+            atomic_load_explicit(&sh->rings[from].head, memory_order_relaxed) != rd->tail[from])
+            return true;
+    }
+    return false;
+}
+
+int share_pull(ClauseShare *sh, int to, int *lits, int *lbd) {
+    /* Round robin over the other workers' rings. */
+    ShareReader *rd = share_reader(sh, to);
+    for (int k = 0; k < sh->workers; k++) {
+        int from = rd->next;
+        rd->next = (from + 1) % sh->workers;
+        if (from == to) continue;
+        int len;
+        while ((len = share_read(sh, to, from, lits, lbd)) < 0) { }
+        if (len > 0) return len;
+    }
+    return 0;
+}
+
+/* ========================================================================= */
+/*  Portfolio                                                                */
+/* ========================================================================= */
+
+/* Settings of workers 1, 2, ...; later workers decide at random, each with
+ * its own seed. */
+static const struct {
+    RestartPolicy restart;
+    PolarityMode  polarity;
+} worker_configs[] = {
+    { RESTART_GLUCOSE, POLARITY_TARGET },
+    { RESTART_LUBY,    POLARITY_SAVED  },
+    { RESTART_LUBY,    POLARITY_TARGET },
+    { RESTART_GLUCOSE, POLARITY_RANDOM },
+    { RESTART_LUBY,    POLARITY_RANDOM },
+};
+#define NUM_WORKER_CONFIGS ((int)(sizeof(worker_configs) / sizeof(worker_configs[0])))
+
+typedef struct Portfolio Portfolio;
+
+typedef struct {
+    CDCLSolver *solver;
+    Portfolio  *pf;
+    int         id;
+    int         result;
+} Worker;
+
+struct Portfolio {
+    Worker     *workers;
+    int         count;
+    atomic_int  winner;     /* first worker to finish, or -1 */
+};
+
+/* Solve; the first worker to return cancels the rest. */
+static void *worker_main(void *arg) {
+    Worker *w = (Worker *)arg;
+    Portfolio *pf = w->pf;
+    w->result = cdcl_solve(w->solver);
+
+    int none = -1;
+    if (atomic_compare_exchange_strong(&pf->winner, &none, w->id)) {
+        for (int i = 0; i < pf->count; i++)
+            if (i != w->id) cdcl_cancel(pf->workers[i].solver);
+    }
+    return NULL;
+}
+
+int cdcl_solve_portfolio(CDCLSolver *s, int threads) {
+    /* Imported clauses cannot be justified in a proof (proof.h). */
+    if (threads <= 1 || s->proof) return cdcl_solve(s);
+
+    Portfolio pf;
+    pf.workers = (Worker *)calloc(threads, sizeof(Worker));
+    pf.count   = threads;
+    atomic_init(&pf.winner, -1);
+    ClauseShare *sh = share_create(threads);
+    /* The other workers read the original clauses from one shared copy;
+     * `s` keeps its own, which its BCP reorders. */
+    ClauseBase *base = cdcl_base_create(s);
+
+    for (int i = 0; i < threads; i++) {
+        CDCLSolver *w = (i == 0) ? s : cdcl_clone(s, base);
+        if (i > 0) {
+            const int c = (i - 1) % NUM_WORKER_CONFIGS;
+            cdcl_set_restart(w, worker_configs[c].restart);
+            cdcl_set_polarity(w, i > NUM_WORKER_CONFIGS ? POLARITY_RANDOM
+                                                        : worker_configs[c].polarity);
+            cdcl_set_seed(w, s->rand_state ^ (0x9E3779B97F4A7C15ull * (uint64_t)i));
+        }
+        w->share    = sh;
+        w->share_id = i;
+        pf.workers[i].solver = w;
+        pf.workers[i].pf     = &pf;
+        pf.workers[i].id     = i;
+    }
+
+    /* Worker 0 runs on the calling thread.  A worker whose thread cannot be
+     * started just sits out. */
+    pthread_t *tids    = (pthread_t *)calloc(threads, sizeof(pthread_t));
+    bool      *started = (bool *)calloc(threads, sizeof(bool));
+    for (int i = 1; i < threads; i++) {
+        started[i] = pthread_create(&tids[i], NULL, worker_main, &pf.workers[i]) == 0;
+        if (!started[i]) perror("portfolio: pthread_create");
+    }
+    worker_main(&pf.workers[0]);
+    for (int i = 1; i < threads; i++)
+        if (started[i]) pthread_join(tids[i], NULL);
+    /* A cancel from the winner may have landed after worker 0 returned. */
+    atomic_store(&s->cancel, false);
+
+    int winner = atomic_load(&pf.winner);
+    int result = pf.workers[winner].result;
+    if (winner != 0 && result == SAT)
+        memcpy(s->model, pf.workers[winner].solver->model,
+               (s->num_vars + 1) * sizeof(int));
+
+    for (int i = 1; i < threads; i++) cdcl_destroy(pf.workers[i].solver);
+    cdcl_base_destroy(base);
+    s->share = NULL;
+    share_destroy(sh);
+    free(tids);
+    free(started);
+    free(pf.workers);
+    return result;
+}
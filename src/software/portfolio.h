@@ -0,0 +1,79 @@
+/*
+ * portfolio.h — Multi-threaded portfolio solving with clause sharing
+ *
+ * Usage:
+ *   CDCLSolver *s = cdcl_load_dimacs(...);
+ *   int result = cdcl_solve_portfolio(s, 8);
+ *
+ * cdcl_solve_portfolio() runs `threads` solvers on the same formula, each
+ * on its own thread with different restart, polarity and seed settings.
+ * The first one to answer wins and cancels the others (cdcl_cancel()); its
+ * model, if any, is left in `s` for cdcl_get_value().  Worker 0 is `s`
+ * itself, with its own settings and BCP backend; the other workers are
+ * cdcl_clone()s of it on the software backend.
+ *
+ * The original clauses are stored once more, in a ClauseBase that workers
+ * 1, 2, ... share read-only (see CREF_BASE): each of them adds only its
+ * learnt clauses and two watched literals per long original clause, so
+ * memory does not grow with a copy of the formula per worker.  Worker 0
+ * keeps its own arena, whose literals its BCP reorders in place.
+ *
+ * Workers exchange short and low-LBD learnt clauses through a ClauseShare:
+ * one ring per worker, written only by that worker and read by all the
+ * others.  The rings are lock-free and lossy: a writer never waits, and a
+ * reader that falls a whole ring behind skips what was overwritten.  Each
+ * ring's head and each worker's read positions sit on cache lines of their
+ * own, so that workers stepping through the rings do not invalidate each
+ * other's lines.
+ * cdcl_solve() exports clauses as it learns them and imports the others'
+ * at decision level 0: on every restart, and after SHARE_IMPORT_CONFLICTS
+ * conflicts without one it backtracks to level 0 if anything is waiting,
+ * so that sharing does not depend on the restart policy.
+ */
+
+#ifndef PORTFOLIO_H
+#define PORTFOLIO_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "CDCL.h"
+
+/* Learnt clauses shared with the other workers: units, clauses of at most
+ * SHARE_MAX_LEN literals and glue clauses (LBD <= SHARE_MAX_LBD) of at most
+ * SHARE_CLAUSE_MAX literals. */
+#define SHARE_MAX_LEN    8
+#define SHARE_MAX_LBD    2
+#define SHARE_CLAUSE_MAX 64
+
+/* Words per ring (a power of two). */
+#define SHARE_RING_WORDS (1 << 16)
+
+/* Conflicts after which a worker goes back to level 0 for waiting clauses. */
+#define SHARE_IMPORT_CONFLICTS 2000
+
+typedef struct ClauseShare ClauseShare;
+
+/* Clause exchange for `workers` workers numbered 0..workers-1. */
+ClauseShare *share_create(int workers);
+void         share_destroy(ClauseShare *sh);
+
+/* Publish a clause (internal literal codes) learnt by worker `from`. */
+void share_push(ClauseShare *sh, int from, const int *lits, int len, int lbd);
+
+/* Whether another worker published a clause worker `to` has not taken. */
+bool share_pending(ClauseShare *sh, int to);
+
+/* Take the next clause published by another worker for worker `to`.
+ * `lits` must hold SHARE_CLAUSE_MAX literals.  Returns the clause length,
+ * or 0 if there is nothing new. */
+int share_pull(ClauseShare *sh, int to, int *lits, int *lbd);
+
+/*
+ * Solve with `threads` workers (see above).  threads <= 1 is cdcl_solve(),
+ * and so is any solve with a proof attached (cdcl_set_proof()).
+ * Returns SAT, UNSAT, or UNKNOWN if `s` was cancelled.
+ */
+int cdcl_solve_portfolio(CDCLSolver *s, int threads);
+
+#endif /* PORTFOLIO_H */
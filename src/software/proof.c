@@ -0,0 +1,207 @@
+/*
+ * proof.c — DRAT proof output for UNSAT answers
+ *
+ * See proof.h.
+ *
+ * The solver thread writes records at `pos` and hands everything before it
+ * to the writer thread by advancing `head`, once per PROOF_CHUNK_BYTES and
+ * when the ring is full.  The writer copies [tail, head) to the file and
+ * advances `tail`.  Both run on their own side of the ring, so `head` and
+ * `tail` are the only shared state, and they are only touched under the
+ * lock: a few times per chunk, not per record.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <pthread.h>
+
+#include "proof.h"
+
+#define PROOF_RING_MASK ((uint64_t)PROOF_RING_BYTES - 1)
+
+struct Proof {
+    FILE          *out;
+    bool           binary;
+    bool           is_stdout;
+    unsigned char *buf;         /* PROOF_RING_BYTES                          */
+
+    /* Solver thread only. */
+    uint64_t       pos;         /* bytes written by the solver, ever         */
+    uint64_t       tail_seen;   /* `tail` when the solver last looked        */
+
+    /* Under `lock`. */
+    pthread_mutex_t lock;
+    pthread_cond_t  data;       /* head moved or done set                    */
+    pthread_cond_t  space;      /* tail moved                                */
+    uint64_t       head;        /* bytes handed to the writer                */
+    uint64_t       tail;        /* bytes written to the file                 */
+    bool           done;
+    int            error;       /* errno of the first failed write, or 0     */
+
+    pthread_t      writer;
+};
+
+/* ========================================================================= */
+/*  Writer thread                                                            */
+/* ========================================================================= */
+
+static void *proof_writer(void *arg) {
+    Proof *p = (Proof *)arg;
+    pthread_mutex_lock(&p->lock);
+    while (true) {
+        while (p->head == p->tail && !p->done) pthread_cond_wait(&p->data, &p->lock);
+        if (p->head == p->tail) break;
+        uint64_t from = p->tail, to = p->head;
+        bool failed = p->error != 0;
+        pthread_mutex_unlock(&p->lock);
+
+        /* [from, to) in at most two pieces; after an error it is dropped,
+         * so that the solver never waits for a dead file. */
+        int error = 0;
+        while (from < to && !failed) {
+            size_t off = (size_t)(from & PROOF_RING_MASK);
+            size_t len = (size_t)(to - from);
+            if (len > PROOF_RING_BYTES - off) len = PROOF_RING_BYTES - off;
+            if (fwrite(p->buf + off, 1, len, p->out) != len) {
+                error = errno ? errno : EIO;
+                break;
+            }
+            from += len;
+        }
+
+        pthread_mutex_lock(&p->lock);
+        if (error && !p->error) p->error = error;
+        p->tail = to;
+        pthread_cond_signal(&p->space);
+    }
+    pthread_mutex_unlock(&p->lock);
+    return NULL;
+}
+
+/* ========================================================================= */
+/*  Solver side                                                              */
+/* ========================================================================= */
+
+/* Hand the bytes written so far to the writer; with `wait`, also wait
+ * until the ring has room for at least one more byte. */
+static void proof_publish(Proof *p, bool wait) {
+    pthread_mutex_lock(&p->lock);
+    p->head = p->pos;
+    pthread_cond_signal(&p->data);
+    while (wait && p->pos - p->tail == PROOF_RING_BYTES)
+        pthread_cond_wait(&p->space, &p->lock);
+    p->tail_seen = p->tail;
+    pthread_mutex_unlock(&p->lock);
+}
+
+static inline void proof_byte(Proof *p, unsigned char b) {
+    if (p->pos - p->tail_seen == PROOF_RING_BYTES) proof_publish(p, true);
+    p->buf[p->pos & PROOF_RING_MASK] = b;
+    p->pos++;
+}
+
+Proof *proof_open(const char *path, bool binary) {
+    bool is_stdout = strcmp(path, "-") == 0;
+    FILE *out = is_stdout ? stdout : fopen(path, binary ? "wb" : "w");
+    if (!out) {
+        perror(path);
+        return NULL;
+    }
+
+    Proof *p = (Proof *)calloc(1, sizeof(Proof));
+    p->out       = out;
+    p->binary    = binary;
+    p->is_stdout = is_stdout;
+    p->buf       = (unsigned char *)malloc(PROOF_RING_BYTES);
+    pthread_mutex_init(&p->lock, NULL);
+    pthread_cond_init(&p->data, NULL);
+    pthread_cond_init(&p->space, NULL);
+    if (!p->buf || pthread_create(&p->writer, NULL, proof_writer, p) != 0) {
+        fprintf(stderr, "%s: cannot start the proof writer\n", path);
+        if (!is_stdout) fclose(out);
+        free(p->buf);
+        free(p);
+        return NULL;
+    }
+    return p;
+}
+
+int proof_close(Proof *p) {
+    if (!p) return 0;
+    proof_publish(p, false);
+    pthread_mutex_lock(&p->lock);
+    p->done = true;
+    pthread_cond_signal(&p->data);
+    pthread_mutex_unlock(&p->lock);
+    pthread_join(p->writer, NULL);
+
+    int error = p->error;
+    if (fflush(p->out) != 0 && !error) error = errno ? errno : EIO;
+    if (!p->is_stdout && fclose(p->out) != 0 && !error) error = errno ? errno : EIO;
+    if (error) fprintf(stderr, "proof: write failed: %s\n", strerror(error));
+
+    pthread_mutex_destroy(&p->lock);
+    pthread_cond_destroy(&p->data);
+    pthread_cond_destroy(&p->space);
+    free(p->buf);
+    free(p);
+    return error ? -1 : 0;
+}
+
+void proof_begin(Proof *p, bool deletion) {
+    if (p->binary) {
+        proof_byte(p, deletion ? 'd' : 'a');
+    } else if (deletion) {
+        proof_byte(p, 'd');
+        proof_byte(p, ' ');
+    }
+}
+
+void proof_lit(Proof *p, int code) {
+    if (p->binary) {
+        unsigned int x = (unsigned int)code;
+        while (x > 0x7f) {
+            proof_byte(p, (unsigned char)(0x80 | (x & 0x7f)));
+            x >>= 7;
+        }
+        proof_byte(p, (unsigned char)x);
+        return;
+    }
+
+    /* Signed decimal, most significant digit first. */
+    char digits[12];
+    int n = 0;
+    unsigned int var = (unsigned int)code >> 1;
+    do {
+        digits[n++] = (char)('0' + var % 10);
+        var /= 10;
+    } while (var > 0);
+    if (code & 1) proof_byte(p, '-');
+    while (n > 0) proof_byte(p, (unsigned char)digits[--n]);
+    proof_byte(p, ' ');
+}
+
+void proof_end(Proof *p) {
+    if (p->binary) {
+        proof_byte(p, 0);
+    } else {
+        proof_byte(p, '0');
+        proof_byte(p, '\n');
+    }
+    if (p->pos - p->head >= PROOF_CHUNK_BYTES) proof_publish(p, false);
+}
+
+void proof_add(Proof *p, const int *lits, int n) {
+    proof_begin(p, false);
+    for (int i = 0; i < n; i++) proof_lit(p, lits[i]);
+    proof_end(p);
+}
+
+void proof_delete(Proof *p, const int *lits, int n) {
+    proof_begin(p, true);
+    for (int i = 0; i < n; i++) proof_lit(p, lits[i]);
+    proof_end(p);
+}
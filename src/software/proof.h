@@ -0,0 +1,63 @@
+/*
+ * proof.h — DRAT proof output for UNSAT answers
+ *
+ * Usage:
+ *   Proof *p = proof_open("out.drat", true);
+ *   cdcl_set_proof(s, p);
+ *   int result = cdcl_solve(s);
+ *   proof_close(p);
+ *
+ * With a proof attached the solver logs every clause it adds to or removes
+ * from its database: learnt clauses (units included), the clauses rewritten
+ * or derived by cdcl_preprocess(), reduce_db() deletions, and the empty
+ * clause once the formula is known to be UNSAT.  A DRAT checker such as
+ * drat-trim verifies the log against the original formula:
+ *
+ *   drat-trim formula.cnf out.drat
+ *
+ * Only refutations are certified: an UNSAT answer under assumptions adds no
+ * empty clause.  Clauses added with cdcl_add_clause() between solves belong
+ * to the formula the proof is checked against.  Portfolio workers import
+ * clauses the log cannot justify, so cdcl_solve_portfolio() solves alone
+ * while a proof is attached.
+ *
+ * Records go into a ring buffer in memory and a writer thread moves them to
+ * the file, so the search never waits on the disk unless the ring fills up.
+ * The binary format is DRAT's compact one: 'a' or 'd', each literal as a
+ * variable-length number 2*var + (literal < 0), then 0.  That number is the
+ * solver's internal literal code, so records are written straight from the
+ * clause arena.
+ */
+
+#ifndef PROOF_H
+#define PROOF_H
+
+#include <stdbool.h>
+
+/* Bytes in the ring buffer (a power of two). */
+#define PROOF_RING_BYTES (1 << 24)
+
+/* Bytes the solver buffers before handing them to the writer thread. */
+#define PROOF_CHUNK_BYTES (1 << 16)
+
+typedef struct Proof Proof;
+
+/* Start a proof in file `path` ("-" for standard output), in binary DRAT
+ * or, if !binary, the text format.  Returns NULL (with a message) if the
+ * file cannot be opened. */
+Proof *proof_open(const char *path, bool binary);
+
+/* Write out what is buffered and close the file.  Returns 0, or -1 (with
+ * a message) if a write failed. */
+int proof_close(Proof *p);
+
+/* Log the addition or the deletion of a clause of internal literal codes. */
+void proof_add(Proof *p, const int *lits, int n);
+void proof_delete(Proof *p, const int *lits, int n);
+
+/* The same one literal at a time: begin, any number of lits, end. */
+void proof_begin(Proof *p, bool deletion);
+void proof_lit(Proof *p, int code);
+void proof_end(Proof *p);
+
+#endif /* PROOF_H */
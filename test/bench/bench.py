@@ -0,0 +1,455 @@
+#!/usr/bin/env python3
+"""
+bench.py — Benchmark driver for sat_solver
+
+Runs every instance of a corpus (corpus.txt) with one or more solver
+binaries and BCP backends, checks each answer (and SAT model), and records
+per run:
+
+    wall time, load time, search time, conflicts, propagations,
+    conflicts/s, propagations/s and peak RSS
+
+to CSV and/or JSON.  The load time, search time and counters come from the
+solver's `c load:` and `c search:` lines (see src/software/main.c); wall
+time and peak RSS are measured here, per child process (RSS by sampling
+VmHWM on Linux, so a peak in the last few milliseconds of a run can be
+missed).
+
+With --baseline, each run is compared with the stored one for the same
+instance, solver binary and backend:
+
+  - a wrong answer or model always fails;
+  - a wall time more than --tolerance (fraction) above the baseline, and at
+    least --min-delta seconds slower, is a regression — but only against a
+    baseline recorded on the same host (name, architecture and CPU model)
+    with the same --repeat; otherwise it is reported only;
+  - different conflict counts mean the search itself changed (for instance
+    a heuristic or propagation order), which is reported but not failed.
+
+Corpus entries are either generated here from a fixed seed (gen:...) or
+files (file:path, relative to the corpus file), such as SATLIB or
+SAT-competition instances downloaded into test/bench/cnf/.  Missing files
+are skipped.  Generated instances are written to test/bench/cnf/ on first
+use and are identical on every machine.
+
+Usage:
+    python3 test/bench/bench.py [--solver ./sat_solver ...] [--backends sw,sim]
+                                [--corpus corpus.txt] [--repeat n]
+                                [--csv out.csv] [--json out.json]
+                                [--baseline baseline.json] [--save-baseline]
+                                [--only name,...] [--timeout s] [-- extra args]
+
+    make bench                 # sat_solver, sw backend, against the baseline
+                               # (both best of BENCH_REPEAT=3 runs)
+    make bench BENCH_BACKENDS=sw,sim BENCH_SOLVERS="./sat_solver ./sat_solver_hw"
+"""
+
+import argparse
+import csv
+import datetime
+import json
+import os
+import platform
+import select
+import subprocess
+import sys
+import time
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+GEN_DIR = os.path.join(HERE, "cnf")
+
+FIELDS = [
+    "name", "solver", "backend", "expected", "answer", "ok",
+    "wall_s", "load_s", "search_s", "conflicts", "propagations",
+    "conflicts_per_s", "propagations_per_s", "peak_rss_kb",
+]
+
+
+# ── Instance generators ──────────────────────────────────────────────────
+#
+# xorshift64 rather than `random`, so the instances never depend on the
+# Python version.
+
+class Rng:
+    def __init__(self, seed):
+        self.state = (seed * 0x9E3779B97F4A7C15 + 1) & 0xFFFFFFFFFFFFFFFF
+
+    def next(self):
+        x = self.state
+        x ^= (x << 13) & 0xFFFFFFFFFFFFFFFF
+        x ^= x >> 7
+        x ^= (x << 17) & 0xFFFFFFFFFFFFFFFF
+        self.state = x
+        return x
+
+    def below(self, n):
+        return self.next() % n
+
+
+def gen_random_ksat(n, m, k, seed, planted=False):
+    """Uniform random k-SAT (SATLIB uf/uuf style).  With `planted`, only
+    clauses satisfied by a hidden assignment are kept, so the formula is
+    SAT."""
+    rng = Rng(seed)
+    hidden = [rng.below(2) for _ in range(n + 1)]
+    clauses = []
+    while len(clauses) < m:
+        vs = set()
+        while len(vs) < k:
+            vs.add(1 + rng.below(n))
+        c = [v if rng.below(2) else -v for v in sorted(vs)]
+        if planted and not any((l > 0) == bool(hidden[abs(l)]) for l in c):
+            continue
+        clauses.append(c)
+    return n, clauses
+
+
+def gen_pigeonhole(pigeons, holes):
+    """PHP(p, h): p pigeons in h holes, UNSAT when p > h."""
+    var = lambda p, h: p * holes + h + 1
+    clauses = [[var(p, h) for h in range(holes)] for p in range(pigeons)]
+    for h in range(holes):
+        for a in range(pigeons):
+            for b in range(a + 1, pigeons):
+                clauses.append([-var(a, h), -var(b, h)])
+    return pigeons * holes, clauses
+
+
+def gen_queens(n):
+    """n-queens: one queen per row, at most one per row, column and
+    diagonal (SAT for n >= 4)."""
+    var = lambda r, c: r * n + c + 1
+    clauses = [[var(r, c) for c in range(n)] for r in range(n)]
+    cells = [(r, c) for r in range(n) for c in range(n)]
+    for i, (ra, ca) in enumerate(cells):
+        for rb, cb in cells[i + 1:]:
+            if ra == rb or ca == cb or ra - ca == rb - cb or ra + ca == rb + cb:
+                clauses.append([-var(ra, ca), -var(rb, cb)])
+    return n * n, clauses
+
+
+GENERATORS = {
+    # gen:ksat <vars> <clauses> <k> <seed>
+    "ksat":    lambda a: gen_random_ksat(int(a[0]), int(a[1]), int(a[2]), int(a[3])),
+    # gen:planted <vars> <clauses> <k> <seed>
+    "planted": lambda a: gen_random_ksat(int(a[0]), int(a[1]), int(a[2]), int(a[3]),
+                                         planted=True),
+    # gen:php <pigeons> <holes>
+    "php":     lambda a: gen_pigeonhole(int(a[0]), int(a[1])),
+    # gen:queens <n>
+    "queens":  lambda a: gen_queens(int(a[0])),
+}
+
+
+def write_cnf(path, num_vars, clauses, comment):
+    tmp = path + ".tmp"
+    with open(tmp, "w") as f:
+        f.write("c %s\n" % comment)
+        f.write("p cnf %d %d\n" % (num_vars, len(clauses)))
+        for c in clauses:
+            f.write(" ".join(map(str, c)) + " 0\n")
+    os.replace(tmp, path)
+
+
+def instance_path(name, source, corpus_dir):
+    """Path of the CNF for a corpus entry (generating it if needed), or None
+    if it is a file that is not there."""
+    kind, _, spec = source.partition(":")
+    if kind == "file":
+        path = os.path.join(corpus_dir, spec)
+        return path if os.path.exists(path) else None
+    if kind != "gen":
+        raise ValueError("unknown source '%s'" % source)
+    args = spec.split(",")
+    os.makedirs(GEN_DIR, exist_ok=True)
+    path = os.path.join(GEN_DIR, name + ".cnf")
+    if not os.path.exists(path):
+        num_vars, clauses = GENERATORS[args[0]](args[1:])
+        write_cnf(path, num_vars, clauses, "bench.py %s" % source)
+    return path
+
+
+def read_corpus(path):
+    """Entries of a corpus file: `name expected source` per line, with
+    expected SAT, UNSAT or ? (not checked)."""
+    entries = []
+    with open(path) as f:
+        for lineno, line in enumerate(f, 1):
+            line = line.split("#", 1)[0].split()
+            if not line:
+                continue
+            if len(line) != 3 or line[1] not in ("SAT", "UNSAT", "?"):
+                sys.exit("%s:%d: expected `name SAT|UNSAT|? source`" % (path, lineno))
+            entries.append(tuple(line))
+    return entries
+
+
+# ── Running the solver ───────────────────────────────────────────────────
+
+def read_clauses(path):
+    clauses, cur = [], []
+    with open(path) as f:
+        for line in f:
+            if line[:1] in ("c", "p", "%", "\n"):
+                if line[:1] == "%":
+                    break
+                continue
+            for tok in line.split():
+                lit = int(tok)
+                if lit == 0:
+                    clauses.append(cur)
+                    cur = []
+                else:
+                    cur.append(lit)
+    return clauses
+
+
+def model_ok(path, model):
+    return all(any(model.get(abs(l)) == (l > 0) for l in c) for c in read_clauses(path))
+
+
+def vm_hwm_kb(pid):
+    """Peak RSS so far of a running process (Linux), in KiB, or 0."""
+    try:
+        with open("/proc/%d/status" % pid) as f:
+            for line in f:
+                if line.startswith("VmHWM:"):
+                    return int(line.split()[1])
+    except OSError:
+        pass
+    return 0
+
+
+def run_once(solver, backend, path, extra, timeout):
+    """Run the solver once.  Returns (answer, model, c-line values, wall
+    seconds, peak RSS in KiB)."""
+    cmd = [solver, "-b", backend] + extra + [path]
+    start = time.monotonic()
+    proc = subprocess.Popen(cmd, stdout=subprocess.PIPE, stderr=subprocess.DEVNULL)
+
+    # Read stdout while waiting, so a large model cannot block the child,
+    # and sample its high-water RSS.
+    chunks = []
+    deadline = start + timeout
+    timed_out = False
+    hwm = 0
+    fd = proc.stdout.fileno()
+    while True:
+        left = deadline - time.monotonic()
+        if left <= 0:
+            proc.kill()
+            timed_out = True
+            break
+        ready, _, _ = select.select([fd], [], [], min(left, 0.02))
+        hwm = max(hwm, vm_hwm_kb(proc.pid))
+        if ready:
+            data = os.read(fd, 1 << 16)
+            if not data:
+                break
+            chunks.append(data)
+    _, _, rusage = os.wait4(proc.pid, 0)
+    wall = time.monotonic() - start
+    proc.stdout.close()
+
+    # ru_maxrss (KiB on Linux, bytes on macOS) is no good on Linux: exec
+    # keeps the high-water mark of the forked copy of this process.
+    if sys.platform == "darwin":
+        rss = rusage.ru_maxrss // 1024
+    else:
+        rss = hwm or rusage.ru_maxrss
+    if timed_out:
+        return "TIMEOUT", {}, {}, wall, rss
+
+    answer, model, stats = "ERROR", {}, {}
+    for line in b"".join(chunks).decode(errors="replace").splitlines():
+        if line.startswith("s "):
+            answer = {"s SATISFIABLE": "SAT", "s UNSATISFIABLE": "UNSAT"}.get(line, "ERROR")
+        elif line.startswith("v "):
+            for tok in line[2:].split():
+                lit = int(tok)
+                if lit:
+                    model[abs(lit)] = lit > 0
+        elif line.startswith("c load:"):
+            stats["load_s"] = float(line.split()[2])
+        elif line.startswith("c search:"):
+            # c search: <t> s, <n> conflicts, <n> propagations
+            parts = line[len("c search:"):].replace(",", "").split()
+            stats["search_s"] = float(parts[0])
+            stats["conflicts"] = int(parts[2])
+            stats["propagations"] = int(parts[4])
+    return answer, model, stats, wall, rss
+
+
+def bench_one(solver, backend, name, expected, path, args):
+    """Best of --repeat runs (by wall time)."""
+    best = None
+    for _ in range(args.repeat):
+        answer, model, stats, wall, rss = run_once(solver, backend, path, args.extra,
+                                                   args.timeout)
+        ok = answer in ("SAT", "UNSAT") and expected in ("?", answer)
+        if ok and answer == "SAT" and not model_ok(path, model):
+            answer, ok = "BAD_MODEL", False
+        row = {
+            "name": name, "solver": solver, "backend": backend,
+            "expected": expected, "answer": answer, "ok": ok,
+            "wall_s": round(wall, 4), "peak_rss_kb": rss,
+            "load_s": stats.get("load_s"), "search_s": stats.get("search_s"),
+            "conflicts": stats.get("conflicts"), "propagations": stats.get("propagations"),
+            "conflicts_per_s": None, "propagations_per_s": None,
+        }
+        search = stats.get("search_s")
+        if search:
+            row["conflicts_per_s"] = round(row["conflicts"] / search)
+            row["propagations_per_s"] = round(row["propagations"] / search)
+        if best is None or (row["ok"], -row["wall_s"]) > (best["ok"], -best["wall_s"]):
+            best = row
+        if not ok:
+            break
+    return best
+
+
+# ── Baseline comparison ──────────────────────────────────────────────────
+
+def cpu_model():
+    """CPU model name, from /proc/cpuinfo on Linux."""
+    try:
+        with open("/proc/cpuinfo") as f:
+            for line in f:
+                key, _, value = line.partition(":")
+                if key.strip() in ("model name", "Model", "CPU part"):
+                    return value.strip()
+    except OSError:
+        pass
+    return platform.processor()
+
+
+def host_id():
+    """What a timing depends on: host name, architecture and CPU model.  The
+    name alone is not enough, as CI VMs often share one."""
+    return {"host": platform.node(), "machine": platform.machine(), "cpu": cpu_model()}
+
+
+def compare(rows, baseline, args):
+    """Print the comparison with `baseline`.  Returns the number of
+    failures."""
+    here = host_id()
+    theirs = {k: baseline.get(k) for k in here}
+    same_host = theirs == here
+    if not same_host:
+        print("note: baseline recorded on %s, not %s; times are reported only"
+              % (" / ".join(map(str, theirs.values())), " / ".join(here.values())))
+    elif baseline.get("repeat", 1) != args.repeat:
+        print("note: baseline kept the best of %d runs, this the best of %d;"
+              " times are reported only" % (baseline.get("repeat", 1), args.repeat))
+        same_host = False
+    if baseline.get("extra_args", []) != args.extra:
+        print("note: baseline ran with solver arguments %s" % baseline.get("extra_args"))
+    key = lambda r: (r["name"], os.path.basename(r["solver"]), r["backend"])
+    old = {key(r): r for r in baseline.get("results", [])}
+
+    failures = 0
+    for r in rows:
+        if not r["ok"]:
+            print("FAIL  %-18s %-5s %s (expected %s)"
+                  % (r["name"], r["backend"], r["answer"], r["expected"]))
+            failures += 1
+            continue
+        b = old.get(key(r))
+        if b is None:
+            continue
+        ratio = r["wall_s"] / b["wall_s"] if b["wall_s"] > 0 else 1.0
+        slower = (ratio > 1 + args.tolerance and
+                  r["wall_s"] - b["wall_s"] >= args.min_delta)
+        notes = []
+        if b.get("conflicts") is not None and r["conflicts"] != b["conflicts"]:
+            notes.append("conflicts %s -> %s" % (b["conflicts"], r["conflicts"]))
+        if slower:
+            notes.append("REGRESSION" if same_host else "slower")
+            if same_host:
+                failures += 1
+        if slower or notes:
+            print("%-5s %-18s %-5s %.3f s -> %.3f s (x%.2f)  %s"
+                  % ("SLOW" if slower else "info", r["name"], r["backend"],
+                     b["wall_s"], r["wall_s"], ratio, ", ".join(notes)))
+    return failures
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n\n")[0].strip(),
+                                 formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--solver", action="append",
+                    help="solver binary (repeatable; default ./sat_solver)")
+    ap.add_argument("--backends", default="sw", help="comma-separated -b backends")
+    ap.add_argument("--corpus", default=os.path.join(HERE, "corpus.txt"))
+    ap.add_argument("--only", help="comma-separated instance names")
+    ap.add_argument("--repeat", type=int, default=1, help="runs per instance (best kept)")
+    ap.add_argument("--timeout", type=float, default=300.0, help="seconds per run")
+    ap.add_argument("--csv", help="write results as CSV")
+    ap.add_argument("--json", help="write results as JSON")
+    ap.add_argument("--baseline", help="compare with this JSON result file")
+    ap.add_argument("--save-baseline", action="store_true",
+                    help="write the results to --baseline instead of comparing")
+    ap.add_argument("--tolerance", type=float, default=0.25,
+                    help="allowed wall-time increase (fraction, default 0.25)")
+    ap.add_argument("--min-delta", type=float, default=0.05,
+                    help="ignore slowdowns under this many seconds")
+    ap.add_argument("extra", nargs="*", help="extra solver arguments (after --)")
+    args = ap.parse_args()
+
+    solvers = args.solver or ["./sat_solver"]
+    backends = [b for b in args.backends.replace(" ", ",").split(",") if b]
+    corpus_dir = os.path.dirname(os.path.abspath(args.corpus))
+    only = set(args.only.split(",")) if args.only else None
+
+    rows = []
+    for name, expected, source in read_corpus(args.corpus):
+        if only and name not in only:
+            continue
+        path = instance_path(name, source, corpus_dir)
+        if path is None:
+            print("skip  %-18s (no %s)" % (name, source))
+            continue
+        for solver in solvers:
+            for backend in backends:
+                r = bench_one(solver, backend, name, expected, path, args)
+                rows.append(r)
+                print("%-5s %-18s %-5s %-7s %8.3f s  %10s confl/s  %12s props/s  %7d KiB"
+                      % ("ok" if r["ok"] else "FAIL", name, backend, r["answer"],
+                         r["wall_s"], r["conflicts_per_s"], r["propagations_per_s"],
+                         r["peak_rss_kb"]))
+                sys.stdout.flush()
+
+    doc = dict(host_id())
+    doc.update({
+        "date": datetime.datetime.now().isoformat(timespec="seconds"),
+        "extra_args": args.extra,
+        "repeat": args.repeat,
+        "results": rows,
+    })
+    if args.json:
+        with open(args.json, "w") as f:
+            json.dump(doc, f, indent=1)
+    if args.csv:
+        with open(args.csv, "w", newline="") as f:
+            w = csv.DictWriter(f, fieldnames=FIELDS)
+            w.writeheader()
+            w.writerows(rows)
+
+    failures = sum(not r["ok"] for r in rows)
+    if args.baseline and args.save_baseline:
+        with open(args.baseline, "w") as f:
+            json.dump(doc, f, indent=1)
+        print("baseline written to %s" % args.baseline)
+    elif args.baseline:
+        if os.path.exists(args.baseline):
+            with open(args.baseline) as f:
+                failures = compare(rows, json.load(f), args)
+        else:
+            print("note: no baseline at %s (record one with --save-baseline)" % args.baseline)
+
+    print("%d runs, %d failed" % (len(rows), failures))
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
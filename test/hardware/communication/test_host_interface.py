@@ -11,6 +11,9 @@ Tests:
   3. BCP_START, no implications — 4-byte done-ok packet (0xC0)
   4. BCP_START, one implication + no conflict — 6-byte impl packet then done-ok
   5. BCP_START, conflict — 4-byte done-conflict packet (0xC1) with clause id
+  6. FRAME with one WRITE_ASSIGN record — ACK, then the executor's write
+  7. FRAME with a bad CRC — NAK, and the BCP_START after it is ignored
+  8. The same FRAME resent intact — ACK, the interface is back in sync
 """
 
 import sys, os
@@ -26,8 +29,9 @@ from amaranth.sim import Simulator
 from communication.host_interface import (
     HostInterface,
     CMD_WRITE_CLAUSE, CMD_WRITE_WL_ENTRY, CMD_WRITE_WL_LEN,
-    CMD_WRITE_ASSIGN, CMD_BCP_START, CMD_RESET_STATE,
+    CMD_WRITE_ASSIGN, CMD_BCP_START, CMD_RESET_STATE, CMD_FRAME,
     RSP_IMPLICATION, RSP_DONE_OK, RSP_DONE_CONF,
+    RSP_FRAME_ACK, RSP_FRAME_NAK,
 )
 
 
@@ -77,6 +81,45 @@ async def collect_tx_bytes(dut, ctx, n, cycle_cnt, max_cycles=200,):
     return collected
 
 
+def crc16(data):
+    """CRC-16/CCITT-FALSE reference."""
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else crc << 1
+            crc &= 0xFFFF
+    return crc
+
+
+def build_frame(seq, records):
+    """FRAME command bytes for a list of (cmd, payload) records."""
+    body = [b for cmd, payload in records for b in [cmd] + payload]
+    head = [seq, len(body)]
+    crc = crc16(head + body)
+    return [CMD_FRAME] + head + body + [crc >> 8, crc & 0xFF]
+
+
+async def watch(dut, ctx, cycles):
+    """
+    Tick with tx_ready=1 for `cycles` cycles.  Returns the TX bytes, the
+    (addr, data) of every assignment write and the number of bcp_start
+    pulses seen.
+    """
+    ctx.set(dut.tx_ready, 1)
+    tx, writes, starts = [], [], 0
+    for _ in range(cycles):
+        if ctx.get(dut.tx_valid):
+            tx.append(ctx.get(dut.tx_data))
+        if ctx.get(dut.assign_wr_en):
+            writes.append((ctx.get(dut.assign_wr_addr),
+                           ctx.get(dut.assign_wr_data)))
+        starts += ctx.get(dut.bcp_start)
+        await ctx.tick()
+    ctx.set(dut.tx_ready, 0)
+    return tx, writes, starts
+
+
 # ── test ───────────────────────────────────────────────────────────────────
 
 def test_host_interface():
@@ -246,6 +289,48 @@ def test_host_interface():
 
         results["t5_tx"] = (cycle_cnt, await collect_tx_bytes(dut, ctx, 4, cycle_cnt))
 
+        # ──────────────────────────────────────────────────────────────
+        # Test 6: FRAME seq=0 with WRITE_ASSIGN var=9, val=2 (TRUE)
+        # Expected TX: [0xA0, 0x00], then one assignment write
+        # ──────────────────────────────────────────────────────────────
+        for _ in range(4):
+            await ctx.tick(); cycle_cnt += 1
+
+        frame0 = build_frame(0, [(CMD_WRITE_ASSIGN, [0x00, 0x09, 0x02])])
+        for b in frame0:
+            cycle_cnt = await send_byte(dut, ctx, b, cycle_cnt)
+        tx, writes, _ = await watch(dut, ctx, 40)
+        cycle_cnt += 40
+        results["t6_tx"]     = (cycle_cnt, tx)
+        results["t6_writes"] = (cycle_cnt, writes)
+
+        # ──────────────────────────────────────────────────────────────
+        # Test 7: FRAME seq=1 with a corrupted CRC, then BCP_START
+        # Expected TX: [0xA1, 0x01] (resend from seq 1), BCP not started
+        # ──────────────────────────────────────────────────────────────
+        frame1 = build_frame(1, [(CMD_WRITE_ASSIGN, [0x00, 0x0A, 0x01])])
+        bad = frame1[:-1] + [frame1[-1] ^ 0x01]
+        for b in bad:
+            cycle_cnt = await send_byte(dut, ctx, b, cycle_cnt)
+        cycle_cnt = await send_cmd(dut, ctx, CMD_BCP_START, [0x00, 0x07],
+                                   cycle_cnt)
+        tx, writes, starts = await watch(dut, ctx, 40)
+        cycle_cnt += 40
+        results["t7_tx"]     = (cycle_cnt, tx)
+        results["t7_writes"] = (cycle_cnt, writes)
+        results["t7_starts"] = (cycle_cnt, starts)
+
+        # ──────────────────────────────────────────────────────────────
+        # Test 8: FRAME seq=1 resent intact
+        # Expected TX: [0xA0, 0x01], then the write of var 10
+        # ──────────────────────────────────────────────────────────────
+        for b in frame1:
+            cycle_cnt = await send_byte(dut, ctx, b, cycle_cnt)
+        tx, writes, _ = await watch(dut, ctx, 40)
+        cycle_cnt += 40
+        results["t8_tx"]     = (cycle_cnt, tx)
+        results["t8_writes"] = (cycle_cnt, writes)
+
     sim = Simulator(dut)
     sim.add_clock(1e-8)
     sim.add_testbench(testbench)
@@ -294,6 +379,19 @@ def test_host_interface():
     check("T5 done-conflict TX", results["t5_tx"],
           [RSP_DONE_CONF, 0x00, 0x07, 0x00])
 
+    # Test 6: framed write accepted and applied
+    check("T6 frame ACK",   results["t6_tx"],     [RSP_FRAME_ACK, 0x00])
+    check("T6 frame write", results["t6_writes"], [(9, 2)])
+
+    # Test 7: corrupted frame rejected, later BCP_START ignored
+    check("T7 frame NAK",      results["t7_tx"],     [RSP_FRAME_NAK, 0x01])
+    check("T7 no write",       results["t7_writes"], [])
+    check("T7 BCP not started", results["t7_starts"], 0)
+
+    # Test 8: resent frame accepted
+    check("T8 frame ACK",   results["t8_tx"],     [RSP_FRAME_ACK, 0x01])
+    check("T8 frame write", results["t8_writes"], [(10, 1)])
+
     if all_pass:
         print("\nAll tests PASSED.")
     else:
@@ -9,8 +9,11 @@ Tests:
   1. WRITE_ASSIGN  — verify command was processed via ack_seq in response
   2. WRITE_CLAUSE  — verify command was processed via ack_seq in response
   3. BCP_START, no implications — DONE_OK status
-  4. BCP_START, one implication + no conflict — IMPL then DONE_OK
+  4. BCP_START, implications + no conflict — full IMPL burst then DONE_OK
   5. BCP_START, conflict — DONE_CONFLICT status with clause id
+  6. RESET_STATE — drains the implication FIFO, then IDLE with its ack_seq
+  7. READ_PERF     — counter sweep after tests 1-6, then the usual response
+                     again from the next command on
 
 JTAG response protocol: Each drscan shifts out the response loaded at the
 PREVIOUS jupdate and shifts in a new command.  So reading a response requires
@@ -35,9 +38,11 @@ from communication.jtag_host_interface import (
     JTAGHostInterface,
     CMD_WRITE_CLAUSE, CMD_WRITE_WL_ENTRY, CMD_WRITE_WL_LEN,
     CMD_WRITE_ASSIGN, CMD_BCP_START, CMD_RESET_STATE, CMD_ACK_IMPL,
-    RSP_IDLE, RSP_BUSY, RSP_IMPLICATION, RSP_DONE_OK, RSP_DONE_CONF,
-    REG_WIDTH,
+    CMD_READ_PERF,
+    RSP_IDLE, RSP_BUSY, RSP_IMPLICATION, RSP_DONE_OK, RSP_DONE_CONF, RSP_PERF,
+    REG_WIDTH, BURST_MAX,
 )
+from modules.perf_counters import PERF_COUNTERS, NUM_PERF, PERF_PER_READ
 
 
 # ── helpers ────────────────────────────────────────────────────────────────
@@ -57,15 +62,36 @@ def build_command(cmd_byte, payload_bytes, seq_num):
 def decode_response(rsp_bits):
     """
     Decode a 128-bit response.
-    Layout: [127:120]=status, [119:104]=var, [103:96]=val,
-            [95:80]=reason/clause_id, [79:8]=reserved, [7:0]=ack_seq
+    Layout: [127:120]=status, [119:117]=count, [116:104]=clause_id,
+            [99:8]=implication tuples (23 bits each), [7:0]=ack_seq
+    Returns (status, tuples, clause_id, ack_seq) where tuples is a list of
+    `count` (var, val, reason) triples.
     """
     status    = (rsp_bits >> 120) & 0xFF
-    var       = (rsp_bits >> 104) & 0xFFFF
-    val       = (rsp_bits >> 96)  & 0xFF
-    reason_id = (rsp_bits >> 80)  & 0xFFFF
+    count     = (rsp_bits >> 117) & 0x7
+    clause_id = (rsp_bits >> 104) & 0x1FFF
     ack_seq   = rsp_bits & 0xFF
-    return status, var, val, reason_id, ack_seq
+    tuples = []
+    for i in range(count):
+        t = (rsp_bits >> (8 + 23 * i)) & ((1 << 23) - 1)
+        tuples.append((t & 0x1FF, (t >> 9) & 1, t >> 10))
+    return status, tuples, clause_id, ack_seq
+
+
+def decode_perf(rsp_bits):
+    """
+    Decode a PERF response.
+    Layout: [127:120]=status, [119:112]=index, [111:108]=counters,
+            [107:104]=PEs, [103:8]=3 counters (32 bits each), [7:0]=ack_seq
+    Returns (status, index, num_counters, num_pes, values, ack_seq).
+    """
+    status  = (rsp_bits >> 120) & 0xFF
+    index   = (rsp_bits >> 112) & 0xFF
+    ncount  = (rsp_bits >> 108) & 0xF
+    num_pes = (rsp_bits >> 104) & 0xF
+    values  = [(rsp_bits >> (8 + 32 * i)) & 0xFFFFFFFF
+               for i in range(PERF_PER_READ)]
+    return status, index, ncount, num_pes, values, rsp_bits & 0xFF
 
 
 def format_raw_hex(rsp_bits):
@@ -111,7 +137,7 @@ async def wait_sync(ctx, n):
 
 async def read_response(dut, ctx, seq_counter, cmd_byte=0x00, payload=None):
     """
-    Flush scan + read scan.  Returns (status, var, val, reason_id, ack_seq, new_seq).
+    Flush scan + read scan.  Returns (status, tuples, clause_id, ack_seq, new_seq).
     Optionally sends a real command on the flush scan.
     """
     if payload is None:
@@ -120,10 +146,24 @@ async def read_response(dut, ctx, seq_counter, cmd_byte=0x00, payload=None):
     _ = await jtag_scan(dut, ctx, cmd_byte, payload, seq_counter)
     seq_counter += 1
     rsp = await jtag_scan(dut, ctx, 0x00, [], seq_counter)
-    s, v, vl, r, a = decode_response(rsp)
+    s, t, c, a = decode_response(rsp)
     print(f"  [SIM RX] raw_hex={format_raw_hex(rsp)}  status=0x{s:02x}  "
-          f"var={v}  val={vl}  reason={r}  ack_seq={a}")
-    return s, v, vl, r, a, seq_counter
+          f"impls={t}  clause_id={c}  ack_seq={a}")
+    return s, t, c, a, seq_counter
+
+
+async def read_perf(dut, ctx, seq_counter, index):
+    """
+    READ_PERF `index`, then a flush + read scan.  Returns the decoded PERF
+    response (see decode_perf) and the new seq.
+    """
+    seq_counter += 1
+    await jtag_scan(dut, ctx, CMD_READ_PERF, [index], seq_counter)
+    await wait_sync(ctx, CDC_SETTLE)
+    _ = await jtag_scan(dut, ctx, 0x00, [], 0)
+    rsp = await jtag_scan(dut, ctx, 0x00, [], 0)
+    print(f"  [SIM RX] raw_hex={format_raw_hex(rsp)}  perf={decode_perf(rsp)}")
+    return decode_perf(rsp), seq_counter
 
 
 # With two independent clocks, the 2-FF synchronizer needs time to
@@ -165,7 +205,7 @@ def test_jtag_host_interface():
         await wait_sync(ctx, CDC_SETTLE)
 
         # Read response: flush + read scan
-        status, _, _, _, ack_seq, seq = await read_response(dut, ctx, seq)
+        status, _, _, ack_seq, seq = await read_response(dut, ctx, seq)
         results["t1_status"]  = status
         results["t1_ack_seq"] = ack_seq
 
@@ -185,7 +225,7 @@ def test_jtag_host_interface():
         await jtag_scan(dut, ctx, CMD_WRITE_CLAUSE, payload_clause, seq)
         await wait_sync(ctx, CDC_SETTLE)
 
-        status, _, _, _, ack_seq, seq = await read_response(dut, ctx, seq)
+        status, _, _, ack_seq, seq = await read_response(dut, ctx, seq)
         results["t2_status"]  = status
         results["t2_ack_seq"] = ack_seq
 
@@ -202,18 +242,18 @@ def test_jtag_host_interface():
         await ctx.tick()
         ctx.set(dut.bcp_done, 0)
 
-        # FSM: BCP_WAIT → IMPL_CHECK → DONE_READY
+        # FSM: BCP_WAIT → BURST_LOAD → DONE_READY
         # Wait for FSM to settle + response CDC handshake
         await wait_sync(ctx, CDC_SETTLE)
 
-        status, _, _, _, ack_seq, seq = await read_response(dut, ctx, seq)
+        status, _, _, ack_seq, seq = await read_response(dut, ctx, seq)
         results["t3_status"] = status
 
         await wait_sync(ctx, 4)
 
         # ────────────────────────────────────────────────────────────────
-        # Test 4: BCP_START false_lit=11, one implication (var=6, val=1,
-        #         reason=3), then done ok
+        # Test 4: BCP_START false_lit=11, implications (var=6, val=1,
+        #         reason=3) drained as a burst, then done ok
         # ────────────────────────────────────────────────────────────────
         seq += 1
         await jtag_scan(dut, ctx, CMD_BCP_START, [0x00, 0x0B], seq)
@@ -228,25 +268,24 @@ def test_jtag_host_interface():
         await ctx.tick()
         ctx.set(dut.bcp_done, 0)
 
-        # FSM: BCP_WAIT → IMPL_CHECK → IMPL_READY
-        # Wait for response to appear in rsp_shadow
+        # FSM: BCP_WAIT → BURST_LOAD → IMPL_READY.  impl_valid is held
+        # high (there is no real FIFO behind the stub), so the burst fills
+        # up with BURST_MAX copies and more are still pending.
         await wait_sync(ctx, CDC_SETTLE)
 
         # Read IMPL response (NOP scans — no command sent).
         # With the shadow register approach, the response reflects the
         # current FSM state live, so we must read IMPL before sending
         # ACK_IMPL.
-        status, var, val, reason_id, ack_seq, seq = await read_response(
-            dut, ctx, seq)
+        status, tuples, _, ack_seq, seq = await read_response(dut, ctx, seq)
         results["t4_impl_status"] = status
-        results["t4_impl_var"]    = var
-        results["t4_impl_val"]    = val
-        results["t4_impl_reason"] = reason_id
+        results["t4_impl_count"]  = len(tuples)
+        results["t4_impl_tuple"]  = tuples[0] if tuples else None
 
         # Clear impl_valid BEFORE sending ACK_IMPL so that when the FSM
-        # processes ACK_IMPL (IMPL_READY → IMPL_CHECK), it sees
-        # impl_valid=0 and proceeds to DONE_READY instead of bouncing
-        # back to IMPL_READY.
+        # processes ACK_IMPL (IMPL_READY → BURST_LOAD), it finds the FIFO
+        # empty and proceeds to DONE_READY instead of bouncing back to
+        # IMPL_READY.
         ctx.set(dut.impl_valid, 0)
 
         # Send ACK_IMPL separately, then wait for FSM to process
@@ -254,9 +293,10 @@ def test_jtag_host_interface():
         await jtag_scan(dut, ctx, CMD_ACK_IMPL, [], seq)
         await wait_sync(ctx, CDC_SETTLE)
 
-        # Read DONE response
-        status, _, _, _, ack_seq, seq = await read_response(dut, ctx, seq)
+        # Read DONE response (empty final burst)
+        status, tuples, _, ack_seq, seq = await read_response(dut, ctx, seq)
         results["t4_done_status"] = status
+        results["t4_done_count"]  = len(tuples)
 
         await wait_sync(ctx, 4)
 
@@ -274,13 +314,62 @@ def test_jtag_host_interface():
         ctx.set(dut.bcp_done, 0)
         ctx.set(dut.bcp_conflict, 0)
 
-        # FSM: BCP_WAIT → IMPL_CHECK → DONE_READY
+        # FSM: BCP_WAIT → BURST_LOAD → DONE_READY
         await wait_sync(ctx, CDC_SETTLE)
 
-        status, _, _, reason_id, ack_seq, seq = await read_response(
+        status, _, clause_id, ack_seq, seq = await read_response(
             dut, ctx, seq)
         results["t5_status"]      = status
-        results["t5_conflict_id"] = reason_id
+        results["t5_conflict_id"] = clause_id
+
+        await wait_sync(ctx, 4)
+
+        # ────────────────────────────────────────────────────────────────
+        # Test 6: RESET_STATE from DONE_READY with an implication left in
+        #         the FIFO: BUSY while it drains, then IDLE
+        # ────────────────────────────────────────────────────────────────
+        ctx.set(dut.impl_valid, 1)
+        seq += 1
+        t6_seq = seq
+        await jtag_scan(dut, ctx, CMD_RESET_STATE, [], seq)
+        await wait_sync(ctx, CDC_SETTLE)
+
+        status, _, _, ack_seq, seq = await read_response(dut, ctx, seq)
+        results["t6_drain_status"] = status
+
+        ctx.set(dut.impl_valid, 0)
+        await wait_sync(ctx, 4)
+
+        status, _, _, ack_seq, seq = await read_response(dut, ctx, seq)
+        results["t6_status"]  = status
+        results["t6_ack_seq"] = ack_seq
+        results["t6_seq"]     = t6_seq
+
+        await wait_sync(ctx, 4)
+
+        # ────────────────────────────────────────────────────────────────
+        # Test 7: READ_PERF sweep.  Tests 3-5 ran three BCP rounds, and
+        #         test 4 left a full burst waiting for ACK_IMPL.  The
+        #         accelerator's event inputs are never driven here.
+        # ────────────────────────────────────────────────────────────────
+        counters = []
+        perf_ok = True
+        for index in range(0, NUM_PERF, PERF_PER_READ):
+            (status, idx, ncount, _, values, ack_seq), seq = await read_perf(
+                dut, ctx, seq, index)
+            perf_ok &= (status == RSP_PERF and idx == index
+                        and ncount == NUM_PERF and ack_seq == seq)
+            counters += values
+        results["t7_perf_ok"] = perf_ok
+        results["t7_counters"] = dict(zip(PERF_COUNTERS, counters))
+        results["t7_padding"] = counters[NUM_PERF:]
+
+        # Any other command brings back the usual response
+        seq += 1
+        await jtag_scan(dut, ctx, CMD_WRITE_ASSIGN, [0x00, 0x05, 0x00], seq)
+        await wait_sync(ctx, CDC_SETTLE)
+        status, _, _, ack_seq, seq = await read_response(dut, ctx, seq)
+        results["t7_status"] = status
 
     sim = Simulator(dut)
     sim.add_clock(1e-8)                # 100 MHz system clock (sync)
@@ -316,17 +405,32 @@ def test_jtag_host_interface():
     # Test 3: done-ok after BCP with no implications
     check("T3 done status", results["t3_status"], RSP_DONE_OK)
 
-    # Test 4: implication then done
+    # Test 4: implication burst then done
     check("T4 impl status", results["t4_impl_status"], RSP_IMPLICATION)
-    check("T4 impl var",    results["t4_impl_var"],    6)
-    check("T4 impl val",    results["t4_impl_val"],    1)
-    check("T4 impl reason", results["t4_impl_reason"], 3)
+    check("T4 impl count",  results["t4_impl_count"],  BURST_MAX)
+    check("T4 impl tuple",  results["t4_impl_tuple"],  (6, 1, 3))
     check("T4 done status", results["t4_done_status"], RSP_DONE_OK)
+    check("T4 done count",  results["t4_done_count"],  0)
 
     # Test 5: conflict
     check("T5 conflict status", results["t5_status"], RSP_DONE_CONF)
     check("T5 conflict id",     results["t5_conflict_id"], 7)
 
+    # Test 6: soft reset
+    check("T6 status while draining", results["t6_drain_status"], RSP_BUSY)
+    check("T6 status after reset",    results["t6_status"], RSP_IDLE)
+    check("T6 ack_seq",               results["t6_ack_seq"], results["t6_seq"])
+
+    # Test 7: performance counters
+    perf = results["t7_counters"]
+    check("T7 PERF responses",     results["t7_perf_ok"], True)
+    check("T7 bcp_rounds",         perf["bcp_rounds"], 3)
+    check("T7 cycles counted",     perf["cycles"] > 0, True)
+    check("T7 drain_wait counted", perf["drain_wait"] > 0, True)
+    check("T7 active (undriven)",  perf["active"], 0)
+    check("T7 padding",            results["t7_padding"], [0] * len(results["t7_padding"]))
+    check("T7 status after READ_PERF", results["t7_status"], RSP_IDLE)
+
     if all_pass:
         print("\nAll tests PASSED.")
     else:
@@ -7,6 +7,8 @@ Verifies:
   3. Reads reflect the most recent write.
   4. Multiple variables can hold independent values.
   5. Overwriting a variable updates correctly.
+  6. A backtrack unassigns exactly the variables above the target level.
+  7. A soft reset empties the trail but keeps the values.
 """
 
 import sys, os
@@ -96,6 +98,74 @@ def test_assignment_memory():
             )
         print("Test 5 PASSED: Unwritten variables remain UNASSIGNED.")
 
+        # ---- Test 6: Backtrack by decision level ----
+        # Everything written so far sits at level 0.  Open level 1 with
+        # var 10 and level 2 with var 20, each with one implied variable.
+        level_writes = [(10, TRUE, 1), (11, FALSE, 0),
+                        (20, TRUE, 1), (21, TRUE, 0)]
+        for var_id, value, decision in level_writes:
+            ctx.set(dut.wr_addr, var_id)
+            ctx.set(dut.wr_data, value)
+            ctx.set(dut.wr_decision, decision)
+            ctx.set(dut.wr_en, 1)
+            await ctx.tick()
+        ctx.set(dut.wr_en, 0)
+        ctx.set(dut.wr_decision, 0)
+
+        async def backtrack(level):
+            ctx.set(dut.bt_level, level)
+            ctx.set(dut.bt_start, 1)
+            await ctx.tick()
+            ctx.set(dut.bt_start, 0)
+            for _ in range(16):
+                await ctx.tick()
+                if not ctx.get(dut.bt_busy):
+                    return
+            raise AssertionError("Test 6 FAIL: backtrack did not finish")
+
+        def expect(expected, step):
+            for var_id, want in expected.items():
+                ctx.set(dut.rd_addr, var_id)
+                val = ctx.get(dut.rd_data)
+                assert val == want, (
+                    f"Test 6 FAIL ({step}): var {var_id} expected {want}, got {val}"
+                )
+
+        await backtrack(1)
+        expect({10: TRUE, 11: FALSE, 20: UNASSIGNED, 21: UNASSIGNED},
+               "to level 1")
+        await backtrack(0)
+        expect({10: UNASSIGNED, 11: UNASSIGNED, 0: FALSE, 2: TRUE,
+                511: FALSE}, "to level 0")
+        print("Test 6 PASSED: Backtrack unassigns by decision level.")
+
+        # ---- Test 7: Soft reset ----
+        # Var 40 opens level 1; after the reset it is a plain level-0 value
+        # that no backtrack can pop.
+        async def write(var_id, value, decision):
+            ctx.set(dut.wr_addr, var_id)
+            ctx.set(dut.wr_data, value)
+            ctx.set(dut.wr_decision, decision)
+            ctx.set(dut.wr_en, 1)
+            await ctx.tick()
+            ctx.set(dut.wr_en, 0)
+            ctx.set(dut.wr_decision, 0)
+
+        await write(40, TRUE, 1)
+        ctx.set(dut.rst_trail, 1)
+        await ctx.tick()
+        ctx.set(dut.rst_trail, 0)
+        await write(41, FALSE, 0)
+        await write(42, TRUE, 1)
+        await backtrack(0)
+        for var_id, want in {40: TRUE, 41: FALSE, 42: UNASSIGNED}.items():
+            ctx.set(dut.rd_addr, var_id)
+            val = ctx.get(dut.rd_data)
+            assert val == want, (
+                f"Test 7 FAIL: var {var_id} expected {want}, got {val}"
+            )
+        print("Test 7 PASSED: Soft reset empties the trail, keeps values.")
+
         print("\nAll tests PASSED.")
 
     sim.add_testbench(testbench)
@@ -2,18 +2,18 @@
 Testbench for the BCP Accelerator top-level module.
 
 Verifies end-to-end integration of all pipeline stages:
-  Watch List Manager → Clause Prefetcher → Clause Evaluator → Implication FIFO
+  Watch List Manager → Clause Dispatcher → Clause Prefetcher → evaluator PEs
+  → Implication FIFO
 backed by Clause Memory, Watch List Memory, and Assignment Memory.
 
-Tests use single-clause watch lists so that the evaluator (which processes
-one clause at a time) always has time to finish before the pipeline drains.
-
 Verifies:
   1. Empty watch list: done asserted quickly, no implications, no conflict.
   2. Single UNIT clause: implication appears in FIFO with correct fields.
   3. Conflict detection: conflict signal latched with correct clause ID.
   4. Satisfied clause (sat_bit): no implication, no conflict, done.
   5. Sequential BCP calls accumulate implications in the FIFO.
+  6. A watch list longer than the number of PEs: every clause is
+     evaluated and the implications arrive in watch list order.
 """
 
 import sys, os
@@ -130,6 +130,13 @@ def test_bcp_accelerator():
         # lit 0 (a) watches clause 3   — used in test 4 (satisfied)
         await write_watch_list(0, [3])
 
+        # Clauses 4–9: (¬j ∨ v) for v = var 3..8, j = var 9
+        # lits=[19, 2v]; all watched by lit 19 (¬j)   — used in test 6
+        for i in range(6):
+            await write_clause(4 + i, sat_bit=0, size=2,
+                               lits=[19, 2 * (3 + i), 0, 0, 0])
+        await write_watch_list(19, [4 + i for i in range(6)])
+
         # ---- Test 1: Empty watch list ----
         await start_bcp(false_lit=7)
         await wait_done()
@@ -203,6 +210,22 @@ def test_bcp_accelerator():
         assert ctx.get(dut.impl_valid) == 0, "Test 5 FAIL: FIFO should be empty"
         print("Test 5 PASSED: Two sequential BCP calls → two implications.")
 
+        # ---- Test 6: Six clauses over the PEs ----
+        # j=TRUE → ¬j (lit 19) false → each of clauses 4–9 implies its var
+        assert dut.num_pes < 6
+        await write_assign(9, TRUE)
+        await start_bcp(false_lit=19)
+        await wait_done()
+        assert ctx.get(dut.conflict) == 0, "Test 6 FAIL: unexpected conflict"
+        await ctx.tick()
+        for i in range(6):
+            assert ctx.get(dut.impl_valid) == 1, f"Test 6 FAIL: impl {i} missing"
+            imp = await pop_implication()
+            assert imp == {"var": 3 + i, "value": 1, "reason": 4 + i}, (
+                f"Test 6 FAIL: impl {i}: {imp}")
+        assert ctx.get(dut.impl_valid) == 0, "Test 6 FAIL: FIFO should be empty"
+        print("Test 6 PASSED: Six clauses on the PEs → six implications in order.")
+
         print("\nAll tests PASSED.")
 
     sim.add_testbench(testbench)
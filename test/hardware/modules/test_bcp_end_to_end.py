@@ -6,8 +6,8 @@ propagate() and the Amaranth BCP Accelerator.  Each scenario sets up a
 CNF formula, initial assignments, and a starting false_lit, then
 compares the full implication chain and conflict outcome.
 
-All watch lists contain a single clause so that the Phase-1 evaluator
-(one clause at a time) processes every clause without drops.
+The clauses of a watch list are spread over the evaluator PEs; scenario E
+has more clauses on one watch list than there are PEs.
 
 Literal encoding (same in SW and HW):
     variable v  ->  positive literal = 2v,  negative literal = 2v + 1
@@ -19,6 +19,7 @@ Scenarios:
   B. Chain into conflict: e=T → f=T, then ¬f+¬g → CONFLICT
   C. Empty watch list: immediate done, no output
   D. 3-literal clause with two false: UNIT implication
+  E. Six clauses on one watch list: six implications, in order
 """
 
 import sys, os
@@ -148,6 +149,12 @@ def build_scenarios():
         5: {"id": 5, "sat_bit": 0, "size": 3, "lits": [17, 19, 20, 0, 0]},
     }
 
+    # Scenario E  (vars 11–17, lits 22–35)
+    # C6–C11: (¬k ∨ x) for x = vars 12–17 → [23, 2x]
+    for i in range(6):
+        clauses[6 + i] = {"id": 6 + i, "sat_bit": 0, "size": 2,
+                          "lits": [23, 2 * (12 + i), 0, 0, 0]}
+
     watch_lists = {
         3:  [0],   # ¬a  → C0
         5:  [1],   # ¬b  → C1
@@ -155,6 +162,7 @@ def build_scenarios():
         11: [3],   # ¬e  → C3
         13: [4],   # ¬f  → C4
         17: [5],   # ¬h  → C5
+        23: [6, 7, 8, 9, 10, 11],  # ¬k → C6–C11
     }
 
     scenarios = [
@@ -182,6 +190,12 @@ def build_scenarios():
             "initial_false_lit": 17,                        # ¬h
             "vars_used": [8, 9, 10],
         },
+        {
+            "name": "E: six clauses on one watch list",
+            "initial_assigns": {11: HW_TRUE},              # k = TRUE
+            "initial_false_lit": 23,                        # ¬k
+            "vars_used": list(range(11, 18)),
+        },
     ]
 
     return clauses, watch_lists, scenarios
@@ -0,0 +1,115 @@
+"""
+Testbench for the Clause Dispatcher module.
+
+Verifies:
+  1. Clause IDs leave in stream order, to the PEs in round-robin order, and
+     each delivery follows its fetch by the 2-cycle prefetch latency.
+  2. A PE is not given a second clause before the first has reached it.
+  3. Backpressure: nothing is fetched while the PE whose turn it is is busy,
+     and nothing is lost meanwhile.
+  4. flush empties the queue.
+"""
+
+import sys, os
+
+# Add src/ to the path so we can import the module
+sys.path.insert(
+    0,
+    os.path.join(os.path.dirname(__file__), "..", "..", "..", "src", "hardware"),
+)
+
+from amaranth import *
+from amaranth.sim import Simulator
+
+from modules.clause_dispatcher import ClauseDispatcher
+
+
+NUM_PES = 2
+
+
+def test_clause_dispatcher():
+    dut = ClauseDispatcher(num_pes=NUM_PES, depth=8)
+    sim = Simulator(dut)
+    sim.add_clock(1e-8)  # 100 MHz
+
+    async def testbench(ctx):
+
+        async def run(cycles, stream=()):
+            """Run `cycles` cycles, streaming `stream` in from cycle 0.
+            Returns the fetches and deliveries as (cycle, value) lists."""
+            fetches, deliveries = [], []
+            stream = list(stream)
+            for cycle in range(cycles):
+                if cycle < len(stream):
+                    ctx.set(dut.clause_id_in, stream[cycle])
+                    ctx.set(dut.clause_id_valid, 1)
+                else:
+                    ctx.set(dut.clause_id_valid, 0)
+                if ctx.get(dut.fetch_valid):
+                    fetches.append((cycle, ctx.get(dut.fetch_id)))
+                if ctx.get(dut.deliver_valid):
+                    deliveries.append((cycle, ctx.get(dut.deliver_pe)))
+                await ctx.tick()
+            ctx.set(dut.clause_id_valid, 0)
+            return fetches, deliveries
+
+        async def flush():
+            ctx.set(dut.flush, 1)
+            await ctx.tick()
+            ctx.set(dut.flush, 0)
+
+        # ---- Test 1: Round robin, stream order, 2-cycle delivery ----
+        ctx.set(dut.pe_idle, 0b11)
+        fetches, deliveries = await run(16, stream=[10, 11, 12, 13])
+        assert [cid for _, cid in fetches] == [10, 11, 12, 13], (
+            f"Test 1 FAIL: fetch order {fetches}")
+        assert [pe for _, pe in deliveries] == [0, 1, 0, 1], (
+            f"Test 1 FAIL: delivery order {deliveries}")
+        for (fc, _), (dc, _) in zip(fetches, deliveries):
+            assert dc == fc + 2, f"Test 1 FAIL: fetch at {fc}, delivery at {dc}"
+        print("Test 1 PASSED: Round robin in stream order, delivered 2 cycles later.")
+
+        # ---- Test 2: One clause in flight per PE ----
+        # The third clause goes to PE 0 again, after its first one arrived
+        assert fetches[2][0] > deliveries[0][0], (
+            f"Test 2 FAIL: PE 0 fetched again at {fetches[2][0]} before "
+            f"its delivery at {deliveries[0][0]}")
+        print("Test 2 PASSED: A PE is reserved until its clause arrives.")
+
+        # ---- Test 3: Backpressure ----
+        ctx.set(dut.pe_idle, 0b00)
+        fetches, _ = await run(6, stream=[20, 21, 22])
+        assert fetches == [], f"Test 3 FAIL: fetched while busy: {fetches}"
+        # Only PE 0 free: one clause goes out, then PE 1's turn stalls
+        ctx.set(dut.pe_idle, 0b01)
+        fetches, deliveries = await run(6)
+        assert [cid for _, cid in fetches] == [20], (
+            f"Test 3 FAIL: expected only clause 20, got {fetches}")
+        assert [pe for _, pe in deliveries] == [0]
+        ctx.set(dut.pe_idle, 0b11)
+        fetches, deliveries = await run(8)
+        assert [cid for _, cid in fetches] == [21, 22], (
+            f"Test 3 FAIL: expected 21, 22 after the stall, got {fetches}")
+        assert [pe for _, pe in deliveries] == [1, 0]
+        print("Test 3 PASSED: Stalls on a busy PE without losing clauses.")
+
+        # ---- Test 4: flush empties the queue ----
+        ctx.set(dut.pe_idle, 0b00)
+        await run(4, stream=[30, 31])
+        await flush()
+        ctx.set(dut.pe_idle, 0b11)
+        fetches, deliveries = await run(6)
+        assert fetches == [] and deliveries == [], (
+            f"Test 4 FAIL: queue not empty after flush: {fetches}")
+        print("Test 4 PASSED: flush empties the queue.")
+
+        print("\nAll tests PASSED.")
+
+    sim.add_testbench(testbench)
+
+    with sim.write_vcd("clause_dispatcher.vcd"):
+        sim.run()
+
+
+if __name__ == "__main__":
+    test_clause_dispatcher()
@@ -0,0 +1,231 @@
+"""
+Testbench for the parallel Clause Evaluator PE.
+
+Verifies:
+  1. Satisfied clause (sat_bit=1) → SATISFIED.
+  2. Unit clause: 2-literal clause, one FALSE, one UNASSIGNED → UNIT.
+  3. Conflict clause: all literals FALSE → CONFLICT.
+  4. Unresolved clause: multiple UNASSIGNED literals → UNRESOLVED.
+  5. 5-literal clause, four FALSE → UNIT, result one cycle after the latch.
+  6. Literals beyond size are ignored.
+  7. A result is held until result_ready, and idle stays low meanwhile.
+  8. flush drops a clause in progress.
+
+Uses a real AssignmentMemory with MAX_K combinational read ports, one per
+literal of the PE.
+"""
+
+import sys, os
+
+# Add src/ to the path so we can import the module
+sys.path.insert(
+    0,
+    os.path.join(os.path.dirname(__file__), "..", "..", "..", "src", "hardware"),
+)
+
+from amaranth import *
+from amaranth.sim import Simulator
+
+from modules.clause_evaluator import SATISFIED, UNIT, CONFLICT, UNRESOLVED
+from modules.clause_evaluator_pe import ClauseEvaluatorPE
+from memory.assignment_memory import AssignmentMemory, UNASSIGNED, FALSE, TRUE
+from memory.clause_memory import MAX_K
+
+
+STATUS_NAMES = {SATISFIED: "SATISFIED", UNIT: "UNIT",
+                CONFLICT: "CONFLICT", UNRESOLVED: "UNRESOLVED"}
+
+
+class PETestWrapper(Elaboratable):
+    """Wraps ClauseEvaluatorPE + AssignmentMemory with internal wiring."""
+
+    def __init__(self, max_clauses=8192, max_vars=512):
+        self.pe = ClauseEvaluatorPE(max_clauses=max_clauses, max_vars=max_vars)
+        self.amem = AssignmentMemory(max_vars=max_vars, num_read_ports=MAX_K)
+
+    def elaborate(self, platform):
+        m = Module()
+        m.submodules.pe = self.pe
+        m.submodules.amem = self.amem
+
+        pe = self.pe
+        rd_addrs = [pe.assign_rd_addr0, pe.assign_rd_addr1, pe.assign_rd_addr2,
+                    pe.assign_rd_addr3, pe.assign_rd_addr4]
+        rd_datas = [pe.assign_rd_data0, pe.assign_rd_data1, pe.assign_rd_data2,
+                    pe.assign_rd_data3, pe.assign_rd_data4]
+        for k in range(MAX_K):
+            m.d.comb += [
+                self.amem.rd_addrs[k].eq(rd_addrs[k]),
+                rd_datas[k].eq(self.amem.rd_datas[k]),
+            ]
+        return m
+
+
+def test_clause_evaluator_pe():
+    dut = PETestWrapper(max_clauses=8192, max_vars=512)
+    pe = dut.pe
+    amem = dut.amem
+    sim = Simulator(dut)
+    sim.add_clock(1e-8)  # 100 MHz
+
+    async def testbench(ctx):
+
+        async def write_assign(var_id, value):
+            """Write a variable assignment (synchronous, takes 1 cycle)."""
+            ctx.set(amem.wr_addr, var_id)
+            ctx.set(amem.wr_data, value)
+            ctx.set(amem.wr_en, 1)
+            await ctx.tick()
+            ctx.set(amem.wr_en, 0)
+
+        async def clear_assignments(var_ids):
+            """Reset variables to UNASSIGNED."""
+            for v in var_ids:
+                await write_assign(v, UNASSIGNED)
+
+        async def submit_clause(clause_id, sat_bit, size, lits):
+            """Present a clause to the PE for one cycle."""
+            assert ctx.get(pe.idle) == 1, "PE not idle"
+            ctx.set(pe.clause_id_in, clause_id)
+            ctx.set(pe.meta_valid, 1)
+            ctx.set(pe.sat_bit, sat_bit)
+            ctx.set(pe.size, size)
+            ctx.set(pe.lit0, lits[0])
+            ctx.set(pe.lit1, lits[1])
+            ctx.set(pe.lit2, lits[2])
+            ctx.set(pe.lit3, lits[3])
+            ctx.set(pe.lit4, lits[4])
+            await ctx.tick()  # Latch cycle (IDLE → EVAL or OUTPUT)
+            ctx.set(pe.meta_valid, 0)
+
+        async def wait_result(max_cycles=10):
+            """Wait for result_valid and return the result dict."""
+            for _ in range(max_cycles):
+                if ctx.get(pe.result_valid):
+                    return {
+                        "status": ctx.get(pe.result_status),
+                        "implied_var": ctx.get(pe.result_implied_var),
+                        "implied_val": ctx.get(pe.result_implied_val),
+                        "clause_id": ctx.get(pe.result_clause_id),
+                    }
+                await ctx.tick()
+            raise AssertionError("Timed out waiting for result_valid")
+
+        ctx.set(pe.result_ready, 1)
+
+        # ---- Test 1: Satisfied clause via sat_bit ----
+        await submit_clause(42, sat_bit=1, size=3, lits=[2, 4, 6, 0, 0])
+        assert ctx.get(pe.result_valid) == 1, "Test 1 FAIL: sat_bit not immediate"
+        r = await wait_result()
+        assert r["status"] == SATISFIED, (
+            f"Test 1 FAIL: expected SATISFIED, got {STATUS_NAMES[r['status']]}")
+        assert r["clause_id"] == 42, f"Test 1 FAIL: clause_id"
+        print("Test 1 PASSED: sat_bit=1 → SATISFIED")
+        await ctx.tick()  # let FSM return to IDLE
+
+        # ---- Test 2: Unit clause ----
+        # Clause (x0 ∨ ¬x1): lits = [0, 3]; x0 = FALSE, x1 = UNASSIGNED
+        await write_assign(0, FALSE)
+        await submit_clause(7, sat_bit=0, size=2, lits=[0, 3, 0, 0, 0])
+        r = await wait_result()
+        assert r["status"] == UNIT, (
+            f"Test 2 FAIL: expected UNIT, got {STATUS_NAMES[r['status']]}")
+        assert r["implied_var"] == 1, (
+            f"Test 2 FAIL: implied_var expected 1, got {r['implied_var']}")
+        assert r["implied_val"] == 0, (
+            f"Test 2 FAIL: implied_val expected 0, got {r['implied_val']}")
+        print("Test 2 PASSED: Unit clause → UNIT with correct implication")
+        await ctx.tick()
+        await clear_assignments([0])
+
+        # ---- Test 3: Conflict clause ----
+        # Clause (x0 ∨ x1 ∨ x2), all variables FALSE
+        await write_assign(0, FALSE)
+        await write_assign(1, FALSE)
+        await write_assign(2, FALSE)
+        await submit_clause(99, sat_bit=0, size=3, lits=[0, 2, 4, 0, 0])
+        r = await wait_result()
+        assert r["status"] == CONFLICT, (
+            f"Test 3 FAIL: expected CONFLICT, got {STATUS_NAMES[r['status']]}")
+        assert r["clause_id"] == 99
+        print("Test 3 PASSED: All literals FALSE → CONFLICT")
+        await ctx.tick()
+        await clear_assignments([0, 1, 2])
+
+        # ---- Test 4: Unresolved clause ----
+        await submit_clause(50, sat_bit=0, size=2, lits=[0, 2, 0, 0, 0])
+        r = await wait_result()
+        assert r["status"] == UNRESOLVED, (
+            f"Test 4 FAIL: expected UNRESOLVED, got {STATUS_NAMES[r['status']]}")
+        print("Test 4 PASSED: Multiple UNASSIGNED → UNRESOLVED")
+        await ctx.tick()
+
+        # ---- Test 5: 5-literal clause in one EVAL cycle ----
+        # Clause (x1 ∨ x2 ∨ x3 ∨ ¬x4 ∨ x5): x1, x2, x3 FALSE, x4 TRUE,
+        # x5 UNASSIGNED → UNIT implying x5 = TRUE
+        await write_assign(1, FALSE)
+        await write_assign(2, FALSE)
+        await write_assign(3, FALSE)
+        await write_assign(4, TRUE)
+        await submit_clause(11, sat_bit=0, size=5, lits=[2, 4, 6, 9, 10])
+        assert ctx.get(pe.result_valid) == 0, "Test 5 FAIL: result during EVAL"
+        await ctx.tick()
+        assert ctx.get(pe.result_valid) == 1, "Test 5 FAIL: no result after EVAL"
+        r = await wait_result()
+        assert r["status"] == UNIT, (
+            f"Test 5 FAIL: expected UNIT, got {STATUS_NAMES[r['status']]}")
+        assert r["implied_var"] == 5 and r["implied_val"] == 1, (
+            f"Test 5 FAIL: expected x5=TRUE, got var={r['implied_var']} "
+            f"val={r['implied_val']}")
+        print("Test 5 PASSED: 5 literals evaluated in one cycle → UNIT")
+        await ctx.tick()
+
+        # ---- Test 6: Literals beyond size are ignored ----
+        # size=2 over lits [2, 4] (both FALSE); lit 10 (x5, unassigned) is
+        # in the slot but outside the clause → CONFLICT
+        await submit_clause(12, sat_bit=0, size=2, lits=[2, 4, 10, 0, 0])
+        r = await wait_result()
+        assert r["status"] == CONFLICT, (
+            f"Test 6 FAIL: expected CONFLICT, got {STATUS_NAMES[r['status']]}")
+        print("Test 6 PASSED: Literals beyond size ignored")
+        await ctx.tick()
+        await clear_assignments([1, 2, 3, 4])
+
+        # ---- Test 7: Result held until result_ready ----
+        ctx.set(pe.result_ready, 0)
+        await write_assign(0, FALSE)
+        await submit_clause(13, sat_bit=0, size=2, lits=[0, 3, 0, 0, 0])
+        r = await wait_result()
+        for _ in range(3):
+            await ctx.tick()
+            assert ctx.get(pe.result_valid) == 1, "Test 7 FAIL: result not held"
+            assert ctx.get(pe.idle) == 0, "Test 7 FAIL: idle while holding"
+            assert ctx.get(pe.result_clause_id) == 13
+        ctx.set(pe.result_ready, 1)
+        await ctx.tick()
+        assert ctx.get(pe.idle) == 1, "Test 7 FAIL: not idle after result_ready"
+        assert ctx.get(pe.result_valid) == 0
+        print("Test 7 PASSED: Result held until result_ready")
+        await clear_assignments([0])
+
+        # ---- Test 8: flush drops a clause in progress ----
+        await submit_clause(14, sat_bit=0, size=2, lits=[0, 2, 0, 0, 0])
+        ctx.set(pe.flush, 1)
+        await ctx.tick()
+        ctx.set(pe.flush, 0)
+        assert ctx.get(pe.idle) == 1, "Test 8 FAIL: not idle after flush"
+        for _ in range(3):
+            assert ctx.get(pe.result_valid) == 0, "Test 8 FAIL: result after flush"
+            await ctx.tick()
+        print("Test 8 PASSED: flush drops the clause")
+
+        print("\nAll tests PASSED.")
+
+    sim.add_testbench(testbench)
+
+    with sim.write_vcd("clause_evaluator_pe.vcd"):
+        sim.run()
+
+
+if __name__ == "__main__":
+    test_clause_evaluator_pe()
@@ -8,6 +8,10 @@ scenarios as test_integration.py but using JTAG communication.
 Scenarios (same setup as test_bcp_end_to_end.py Scenario A):
   1. Implication chain: a=T → b=T → c=T → d=T (no conflict)
   2. Conflict scenario
+  3. Implication burst: five implications from one BCP round
+
+The accelerator writes implied values to its assignment memory itself, so
+the host never writes them back between rounds.
 """
 
 import sys
@@ -26,7 +30,7 @@ from communication.jtag_host_interface import (
     CMD_WRITE_CLAUSE, CMD_WRITE_WL_ENTRY, CMD_WRITE_WL_LEN,
     CMD_WRITE_ASSIGN, CMD_BCP_START, CMD_ACK_IMPL,
     RSP_IDLE, RSP_BUSY, RSP_IMPLICATION, RSP_DONE_OK, RSP_DONE_CONF,
-    REG_WIDTH,
+    REG_WIDTH, BURST_MAX,
 )
 
 
@@ -94,7 +98,7 @@ class JTAGDriver:
     async def read_response(self, ctx):
         """
         Read the current response: flush scan + read scan (NOP only).
-        Returns (status, var, val, reason_id, ack_seq).
+        Returns (status, tuples, clause_id, ack_seq).
         """
         # Flush scan: loads current rsp_shadow into shift_reg
         await self.send_cmd(ctx, 0x00, [])
@@ -104,12 +108,16 @@ class JTAGDriver:
 
     @staticmethod
     def decode(rsp_bits):
+        """tuples is a list of (var, val, reason) implication triples."""
         status    = (rsp_bits >> 120) & 0xFF
-        var       = (rsp_bits >> 104) & 0xFFFF
-        val       = (rsp_bits >> 96)  & 0xFF
-        reason_id = (rsp_bits >> 80)  & 0xFFFF
+        count     = (rsp_bits >> 117) & 0x7
+        clause_id = (rsp_bits >> 104) & 0x1FFF
         ack_seq   = rsp_bits & 0xFF
-        return status, var, val, reason_id, ack_seq
+        tuples = []
+        for i in range(count):
+            t = (rsp_bits >> (8 + 23 * i)) & ((1 << 23) - 1)
+            tuples.append((t & 0x1FF, (t >> 9) & 1, t >> 10))
+        return status, tuples, clause_id, ack_seq
 
 
 # ── Payload encoding helpers ─────────────────────────────────────────────
@@ -218,57 +226,32 @@ def test_integration_jtag_implication_chain():
         await drv.send_and_wait(ctx, CMD_BCP_START,
                                 encode_bcp_start(3), wait=80)
 
-        # Read implication: should be b=TRUE (var=2, val=1, reason=0)
-        status, var, val, reason_id, _ = await drv.read_response(ctx)
-        assert status == RSP_IMPLICATION, \
-            f"Expected IMPL (0xB0), got 0x{status:02X}"
-        assert var == 2, f"Expected var=2, got {var}"
-        assert val == 1, f"Expected val=1, got {val}"
-        assert reason_id == 0, f"Expected reason=0, got {reason_id}"
-        print(f"  PASS: impl var={var} val={val} reason={reason_id}")
-
-        # Send ACK_IMPL separately, wait for FSM to process
-        await drv.send_and_wait(ctx, CMD_ACK_IMPL, [])
-
-        # Read done
-        status, _, _, _, _ = await drv.read_response(ctx)
+        # A single implication fits in one burst, so it arrives together
+        # with DONE: b=TRUE (var=2, val=1, reason=0)
+        status, tuples, _, _ = await drv.read_response(ctx)
         assert status == RSP_DONE_OK, \
             f"Expected DONE_OK (0xC0), got 0x{status:02X}"
-        print("  PASS: round 1 done-no-conflict")
+        assert tuples == [(2, 1, 0)], f"Expected [(2, 1, 0)], got {tuples}"
+        print(f"  PASS: round 1 done-no-conflict, impls={tuples}")
 
-        # ── Round 2: Update b=TRUE, BCP on false_lit=5 (¬b) ─────────
-        await drv.send_and_wait(ctx, CMD_WRITE_ASSIGN,
-                                encode_write_assign(2, HW_TRUE))
+        # ── Round 2: BCP on false_lit=5 (¬b) ─────────────────────────
+        # b=TRUE was applied by the accelerator; no host write needed.
         await drv.send_and_wait(ctx, CMD_BCP_START,
                                 encode_bcp_start(5), wait=80)
 
-        status, var, val, reason_id, _ = await drv.read_response(ctx)
-        assert status == RSP_IMPLICATION
-        assert var == 3 and val == 1 and reason_id == 1
-        print(f"  PASS: impl var={var} val={val} reason={reason_id}")
-
-        await drv.send_and_wait(ctx, CMD_ACK_IMPL, [])
-
-        status, _, _, _, _ = await drv.read_response(ctx)
+        status, tuples, _, _ = await drv.read_response(ctx)
         assert status == RSP_DONE_OK
-        print("  PASS: round 2 done-no-conflict")
+        assert tuples == [(3, 1, 1)], f"Expected [(3, 1, 1)], got {tuples}"
+        print(f"  PASS: round 2 done-no-conflict, impls={tuples}")
 
-        # ── Round 3: Update c=TRUE, BCP on false_lit=7 (¬c) ─────────
-        await drv.send_and_wait(ctx, CMD_WRITE_ASSIGN,
-                                encode_write_assign(3, HW_TRUE))
+        # ── Round 3: BCP on false_lit=7 (¬c) ─────────────────────────
         await drv.send_and_wait(ctx, CMD_BCP_START,
                                 encode_bcp_start(7), wait=80)
 
-        status, var, val, reason_id, _ = await drv.read_response(ctx)
-        assert status == RSP_IMPLICATION
-        assert var == 4 and val == 1 and reason_id == 2
-        print(f"  PASS: impl var={var} val={val} reason={reason_id}")
-
-        await drv.send_and_wait(ctx, CMD_ACK_IMPL, [])
-
-        status, _, _, _, _ = await drv.read_response(ctx)
+        status, tuples, _, _ = await drv.read_response(ctx)
         assert status == RSP_DONE_OK
-        print("  PASS: round 3 done-no-conflict (final)")
+        assert tuples == [(4, 1, 2)], f"Expected [(4, 1, 2)], got {tuples}"
+        print(f"  PASS: round 3 done-no-conflict (final), impls={tuples}")
 
         print("\n  JTAG Integration test (implication chain): ALL PASSED")
 
@@ -341,29 +324,22 @@ def test_integration_jtag_conflict():
         await drv.send_and_wait(ctx, CMD_BCP_START,
                                 encode_bcp_start(11), wait=80)
 
-        status, var, val, reason_id, _ = await drv.read_response(ctx)
-        assert status == RSP_IMPLICATION
-        assert var == 6 and val == 1 and reason_id == 0
-        print(f"  PASS: impl var={var} val={val} reason={reason_id}")
-
-        await drv.send_and_wait(ctx, CMD_ACK_IMPL, [])
-
-        status, _, _, _, _ = await drv.read_response(ctx)
+        status, tuples, _, _ = await drv.read_response(ctx)
         assert status == RSP_DONE_OK
-        print("  PASS: round 1 done-no-conflict")
+        assert tuples == [(6, 1, 0)], f"Expected [(6, 1, 0)], got {tuples}"
+        print(f"  PASS: round 1 done-no-conflict, impls={tuples}")
 
-        # ── Round 2: Update f=TRUE, BCP on false_lit=13 (¬f) ────────
-        await drv.send_and_wait(ctx, CMD_WRITE_ASSIGN,
-                                encode_write_assign(6, HW_TRUE))
+        # ── Round 2: BCP on false_lit=13 (¬f) ────────────────────────
+        # f=TRUE was applied by the accelerator in round 1.
         await drv.send_and_wait(ctx, CMD_BCP_START,
                                 encode_bcp_start(13), wait=80)
 
-        status, _, _, reason_id, _ = await drv.read_response(ctx)
+        status, _, clause_id, _ = await drv.read_response(ctx)
         assert status == RSP_DONE_CONF, \
             f"Expected DONE_CONF (0xC1), got 0x{status:02X}"
-        assert reason_id == 1, \
-            f"Expected conflict clause=1, got {reason_id}"
-        print(f"  PASS: conflict on clause {reason_id}")
+        assert clause_id == 1, \
+            f"Expected conflict clause=1, got {clause_id}"
+        print(f"  PASS: conflict on clause {clause_id}")
 
         print("\n  JTAG Integration test (conflict): ALL PASSED")
 
@@ -375,6 +351,85 @@ def test_integration_jtag_conflict():
         sim.run()
 
 
+# ── Test: Implication burst ──────────────────────────────────────────────
+
+def test_integration_jtag_burst():
+    """
+    Full-stack JTAG test: one BCP round with more implications than fit in
+    a single response.
+
+    Clauses C0..C4: (¬a ∨ x_i) for x_i = vars 2..6 → lits [3, 2*(i+2)]
+    Watch list: lit 3 (¬a) → [C0, C1, C2, C3, C4]
+    Initial assignment: a = TRUE, x_i unassigned
+
+    Expected: an IMPL response carrying BURST_MAX implications, then after
+    ACK_IMPL a DONE_OK response carrying the remaining one.
+    """
+    dut = BCPTopJTAG(use_jtagg_primitive=False)
+    sim = Simulator(dut)
+    sim.add_clock(1e-8)                # 100 MHz system clock (sync)
+    sim.add_clock(1.3e-7, domain="jtck")  # ~7.7 MHz JTAG clock
+
+    num_impl = BURST_MAX + 1
+
+    async def testbench(ctx):
+        drv = JTAGDriver(dut)
+
+        ctx.set(dut.host_if.jtag_shift, 0)
+        ctx.set(dut.host_if.jtag_update, 0)
+        ctx.set(dut.host_if.jtag_tdi, 0)
+        ctx.set(dut.host_if.jtag_sel, 0)
+        for _ in range(10):
+            await ctx.tick("sync")
+
+        # ── Upload clauses and the watch list of ¬a ───────────────────
+        for i in range(num_impl):
+            await drv.send_and_wait(ctx, CMD_WRITE_CLAUSE,
+                                    encode_write_clause(i, 2, 0, [3, 2 * (i + 2)]))
+        await drv.send_and_wait(ctx, CMD_WRITE_WL_LEN,
+                                encode_write_wl_len(3, num_impl))
+        for i in range(num_impl):
+            await drv.send_and_wait(ctx, CMD_WRITE_WL_ENTRY,
+                                    encode_write_wl_entry(3, i, i))
+
+        # ── Upload assignments ────────────────────────────────────────
+        await drv.send_and_wait(ctx, CMD_WRITE_ASSIGN,
+                                encode_write_assign(1, HW_TRUE))
+        for i in range(num_impl):
+            await drv.send_and_wait(ctx, CMD_WRITE_ASSIGN,
+                                    encode_write_assign(i + 2, HW_UNASSIGNED))
+
+        # ── BCP on false_lit=3 (¬a) ───────────────────────────────────
+        await drv.send_and_wait(ctx, CMD_BCP_START,
+                                encode_bcp_start(3), wait=120)
+
+        status, first, _, _ = await drv.read_response(ctx)
+        assert status == RSP_IMPLICATION, \
+            f"Expected IMPL (0xB0), got 0x{status:02X}"
+        assert len(first) == BURST_MAX, f"Expected a full burst, got {first}"
+        print(f"  PASS: first burst impls={first}")
+
+        await drv.send_and_wait(ctx, CMD_ACK_IMPL, [])
+
+        status, rest, _, _ = await drv.read_response(ctx)
+        assert status == RSP_DONE_OK, \
+            f"Expected DONE_OK (0xC0), got 0x{status:02X}"
+        print(f"  PASS: final burst impls={rest}")
+
+        got = sorted(first + rest)
+        expected = [(i + 2, 1, i) for i in range(num_impl)]
+        assert got == expected, f"Expected {expected}, got {got}"
+        print("\n  JTAG Integration test (burst): ALL PASSED")
+
+    sim.add_testbench(testbench)
+
+    vcd_path = os.path.join(os.path.dirname(__file__),
+                            "integration_jtag_burst.vcd")
+    with sim.write_vcd(vcd_path):
+        sim.run()
+
+
 if __name__ == "__main__":
     test_integration_jtag_implication_chain()
     test_integration_jtag_conflict()
+    test_integration_jtag_burst()
@@ -7,7 +7,12 @@
  *
  * Compile:
  *   gcc -O2 -I../../src/software -o test_CDCL \
- *       test_CDCL.c ../../src/software/CDCL.c -lm
+ *       test_CDCL.c ../../src/software/CDCL.c ../../src/software/dimacs.c \
+ *       ../../src/software/portfolio.c ../../src/software/proof.c \
+ *       ../../src/software/bcp_backend.c ../../src/software/hw_clausedb.c \
+ *       ../../src/software/hw_trace.c ../../src/software/hw_sim.c \
+ *       ../../src/software/hw_interface_jtag.c ../../src/software/hw_interface.c \
+ *       -lm -pthread
  *
  * Run:
  *   ./test_CDCL
@@ -17,6 +22,11 @@
 #include <stdlib.h>
 #include <string.h>
 #include "CDCL.h"
+#include "dimacs.h"
+#include "portfolio.h"
+#include "proof.h"
+#include "bcp_backend.h"
+#include "hw_clausedb.h"
 
 /* ========================================================================= */
 /*  Test helpers                                                             */
@@ -52,6 +62,15 @@ static int verify_assignment(CDCLSolver *s, int clauses[][10], int num_clauses)
     return 1;
 }
 
+/* Add every clause of a 0-terminated clause table to the solver. */
+static void add_all(CDCLSolver *s, int clauses[][10], int num_clauses) {
+    for (int i = 0; i < num_clauses; i++) {
+        int len = 0;
+        while (clauses[i][len] != 0) len++;
+        cdcl_add_clause(s, clauses[i], len);
+    }
+}
+
 /* Print pass/fail and update counters. */
 static void check(const char *name, int passed) {
     tests_run++;
@@ -242,10 +261,607 @@ static void test_empty_clause(void) {
     cdcl_destroy(s);
 }
 
+/*
+ * Test 8: Pigeonhole PHP(4,3) — 4 pigeons, 3 holes (UNSAT).
+ *   x(p,h) = 3*p + h + 1.  Needs many decisions and multi-step
+ *   resolution in conflict analysis before UNSAT is proven.
+ */
+static void test_pigeonhole_4_3(void) {
+    int clauses[22][10];
+    int n = 0;
+    for (int p = 0; p < 4; p++) {
+        for (int h = 0; h < 3; h++) clauses[n][h] = 3 * p + h + 1;
+        clauses[n++][3] = 0;
+    }
+    for (int h = 0; h < 3; h++)
+        for (int a = 0; a < 4; a++)
+            for (int b = a + 1; b < 4; b++) {
+                clauses[n][0] = -(3 * a + h + 1);
+                clauses[n][1] = -(3 * b + h + 1);
+                clauses[n++][2] = 0;
+            }
+
+    CDCLSolver *s = cdcl_create(12);
+    add_all(s, clauses, n);
+    check("pigeonhole PHP(4,3) UNSAT", cdcl_solve(s) == UNSAT);
+    cdcl_destroy(s);
+}
+
+/*
+ * Test 9: Implication chain over 60 variables (SAT).
+ *   (x1) AND (~xi OR xi+1) for all i, plus (~x60 OR ~x59 OR x30):
+ *   every variable is forced TRUE by propagation from the single unit.
+ */
+static void test_long_chain_sat(void) {
+    int clauses[61][10];
+    int n = 0;
+    clauses[n][0] = 1; clauses[n++][1] = 0;
+    for (int i = 1; i < 60; i++) {
+        clauses[n][0] = -i; clauses[n][1] = i + 1; clauses[n++][2] = 0;
+    }
+    clauses[n][0] = -60; clauses[n][1] = -59; clauses[n][2] = 30;
+    clauses[n++][3] = 0;
+
+    CDCLSolver *s = cdcl_create(60);
+    add_all(s, clauses, n);
+    int result = cdcl_solve(s);
+    check("long chain SAT (result)", result == SAT);
+    if (result == SAT)
+        check("long chain SAT (verify)", verify_assignment(s, clauses, n));
+    cdcl_destroy(s);
+}
+
 /* ========================================================================= */
 /*  Main — run all tests                                                     */
 /* ========================================================================= */
 
+/*
+ * Test 10: Binary implication cycle — UNSAT
+ *   x1 -> x2 -> ... -> x8 -> ~x1, and ~x1 -> x9 -> x1.
+ *   Every clause is binary, so propagation runs entirely on the binary
+ *   implication lists and conflict analysis on inline binary reasons.
+ */
+static void test_binary_cycle_unsat(void) {
+    int clauses[10][10];
+    int n = 0;
+    for (int i = 1; i < 8; i++) {
+        clauses[n][0] = -i; clauses[n][1] = i + 1; clauses[n++][2] = 0;
+    }
+    clauses[n][0] = -8; clauses[n][1] = -1; clauses[n++][2] = 0;
+    clauses[n][0] = 1;  clauses[n][1] = 9;  clauses[n++][2] = 0;
+    clauses[n][0] = -9; clauses[n][1] = 1;  clauses[n++][2] = 0;
+
+    CDCLSolver *s = cdcl_create(9);
+    add_all(s, clauses, n);
+    check("binary implication cycle UNSAT", cdcl_solve(s) == UNSAT);
+    cdcl_destroy(s);
+}
+
+/*
+ * Test 11: DIMACS loader — comments between literals, a clause split over
+ *   lines, the SATLIB "%" end marker; and rejection of out-of-range literals.
+ */
+static void test_load_dimacs(void) {
+    char path[] = "/tmp/test_CDCL_XXXXXX";
+    int fd = mkstemp(path);
+    FILE *fp = fdopen(fd, "w");
+    fputs("c leading comment\n"
+          "p cnf 3 3\n"
+          "1 -2 c comment inside a clause\n"
+          "  3 0\n"
+          "-1 0\n"
+          "2\t-3 0\n"
+          "%\n"
+          "0\n", fp);
+    fclose(fp);
+
+    DimacsInfo info;
+    CDCLSolver *s = cdcl_load_dimacs(path, &info);
+    check("load DIMACS (parsed)", s != NULL && info.num_vars == 3 &&
+          info.clauses_read == 3 && info.max_clause_len == 3);
+    if (s) {
+        int clauses[3][10] = { {1, -2, 3, 0}, {-1, 0}, {2, -3, 0} };
+        int result = cdcl_solve(s);
+        check("load DIMACS (SAT)", result == SAT);
+        if (result == SAT)
+            check("load DIMACS (verify)", verify_assignment(s, clauses, 3));
+        cdcl_destroy(s);
+    }
+
+    fp = fopen(path, "w");
+    fputs("p cnf 2 1\n1 -3 0\n", fp);
+    fclose(fp);
+    s = cdcl_load_dimacs(path, NULL);
+    check("load DIMACS (rejects literal out of range)", s == NULL);
+    if (s) cdcl_destroy(s);
+    remove(path);
+}
+
+/*
+ * Test 12: Bulk loading — the pigeonhole PHP(4,3) formula of test 8, added
+ *   through cdcl_reserve() + cdcl_add_clauses() (UNSAT), and a small SAT
+ *   formula whose model is checked.
+ */
+static void test_bulk_add(void) {
+    /* p(i,j) = pigeon i in hole j -> var 3*(i-1)+j */
+    int flat[128];
+    int n = 0, clauses = 0;
+    for (int i = 1; i <= 4; i++) {
+        for (int j = 1; j <= 3; j++) flat[n++] = 3 * (i - 1) + j;
+        flat[n++] = 0;
+        clauses++;
+    }
+    for (int j = 1; j <= 3; j++)
+        for (int a = 1; a <= 4; a++)
+            for (int b = a + 1; b <= 4; b++) {
+                flat[n++] = -(3 * (a - 1) + j);
+                flat[n++] = -(3 * (b - 1) + j);
+                flat[n++] = 0;
+                clauses++;
+            }
+
+    CDCLSolver *s = cdcl_create(12);
+    cdcl_reserve(s, clauses, n - clauses);
+    check("bulk add (clause count)", cdcl_add_clauses(s, flat, n) == clauses);
+    check("bulk add PHP(4,3) UNSAT", cdcl_solve(s) == UNSAT);
+    cdcl_destroy(s);
+
+    int sat_flat[] = { 1, 2, 3, 0,  -1, -2, 0,  -2, -3, 0,  -1, -3, 0,  2, 0 };
+    int sat_clauses[5][10] = { {1, 2, 3, 0}, {-1, -2, 0}, {-2, -3, 0},
+                               {-1, -3, 0}, {2, 0} };
+    s = cdcl_create(3);
+    cdcl_add_clauses(s, sat_flat, sizeof(sat_flat) / sizeof(sat_flat[0]));
+    int result = cdcl_solve(s);
+    check("bulk add SAT (result)", result == SAT);
+    if (result == SAT)
+        check("bulk add SAT (verify)", verify_assignment(s, sat_clauses, 5));
+    cdcl_destroy(s);
+}
+
+/*
+ * Test 13: Portfolio — PHP(5,4) (UNSAT) and an 8-queens encoding (SAT,
+ *   model checked) with four threads, and a cancelled solve (UNKNOWN).
+ */
+static void test_portfolio(void) {
+    /* x(p,h) = 4*p + h + 1 */
+    int php[5 + 4 * 10][10];
+    int n = 0;
+    for (int p = 0; p < 5; p++) {
+        for (int h = 0; h < 4; h++) php[n][h] = 4 * p + h + 1;
+        php[n++][4] = 0;
+    }
+    for (int h = 0; h < 4; h++)
+        for (int a = 0; a < 5; a++)
+            for (int b = a + 1; b < 5; b++) {
+                php[n][0] = -(4 * a + h + 1);
+                php[n][1] = -(4 * b + h + 1);
+                php[n++][2] = 0;
+            }
+    CDCLSolver *s = cdcl_create(20);
+    add_all(s, php, n);
+    check("portfolio PHP(5,4) UNSAT", cdcl_solve_portfolio(s, 4) == UNSAT);
+    cdcl_destroy(s);
+
+    /* Worker 0 never restarts, so it imports on the conflict schedule. */
+    s = cdcl_create(20);
+    add_all(s, php, n);
+    cdcl_set_restart(s, RESTART_NONE);
+    check("portfolio PHP(5,4) UNSAT without restarts", cdcl_solve_portfolio(s, 4) == UNSAT);
+    cdcl_destroy(s);
+
+    /* A clone reading the original clauses from a shared base. */
+    s = cdcl_create(20);
+    add_all(s, php, n);
+    ClauseBase *base = cdcl_base_create(s);
+    CDCLSolver *w = cdcl_clone(s, base);
+    check("clone shares the original clauses",
+          base && w->clause_count == n && (w->clauses[0] & CREF_BASE));
+    check("clone on a base PHP(5,4) UNSAT", cdcl_solve(w) == UNSAT);
+    cdcl_destroy(w);
+    check("source after its clone PHP(5,4) UNSAT", cdcl_solve(s) == UNSAT);
+    cdcl_base_destroy(base);
+    cdcl_destroy(s);
+
+    ClauseShare *sh = share_create(3);
+    int lits[SHARE_CLAUSE_MAX], lbd;
+    int clause[3] = { 2, 5, 7 };
+    share_push(sh, 0, clause, 3, 2);
+    check("share: pending for the other workers",
+          share_pending(sh, 1) && share_pending(sh, 2) && !share_pending(sh, 0));
+    check("share: pulled once",
+          share_pull(sh, 1, lits, &lbd) == 3 && lits[2] == 7 && lbd == 2 &&
+          share_pull(sh, 1, lits, &lbd) == 0 && !share_pending(sh, 1) &&
+          share_pending(sh, 2));
+    share_destroy(sh);
+
+    /* q(r,c) = 8*r + c + 1: one queen per row, at most one per row, column
+     * and diagonal. */
+    static int queens[8 + 8 * 28 * 2 + 2 * 8 * 28][10];
+    n = 0;
+    for (int r = 0; r < 8; r++) {
+        for (int c = 0; c < 8; c++) queens[n][c] = 8 * r + c + 1;
+        queens[n++][8] = 0;
+    }
+    for (int a = 0; a < 64; a++)
+        for (int b = a + 1; b < 64; b++) {
+            int ra = a / 8, ca = a % 8, rb = b / 8, cb = b % 8;
+            if (ra == rb || ca == cb || ra - ca == rb - cb || ra + ca == rb + cb) {
+                queens[n][0] = -(a + 1);
+                queens[n][1] = -(b + 1);
+                queens[n++][2] = 0;
+            }
+        }
+    s = cdcl_create(64);
+    add_all(s, queens, n);
+    base = cdcl_base_create(s);
+    w = cdcl_clone(s, base);
+    check("clone on a base 8-queens SAT",
+          cdcl_solve(w) == SAT && verify_assignment(w, queens, n));
+    cdcl_destroy(w);
+    cdcl_base_destroy(base);
+
+    int result = cdcl_solve_portfolio(s, 4);
+    check("portfolio 8-queens (result)", result == SAT);
+    if (result == SAT)
+        check("portfolio 8-queens (verify)", verify_assignment(s, queens, n));
+
+    cdcl_cancel(s);
+    check("cancelled solve UNKNOWN", cdcl_solve(s) == UNKNOWN);
+    cdcl_destroy(s);
+}
+
+/*
+ * Test 14: Incremental solving — (x1 OR x2) AND (~x1 OR x3) AND (~x2 OR x3)
+ *   is SAT and implies x3.  Under assumptions {x4, ~x3} it is UNSAT with
+ *   core {~x3}; adding (~x4 OR ~x1) between calls still leaves it SAT, with
+ *   x4 and x2 forced under assumption x4.
+ */
+static void test_incremental(void) {
+    int clauses[4][10] = { {1, 2, 0}, {-1, 3, 0}, {-2, 3, 0}, {-4, -1, 0} };
+    CDCLSolver *s = cdcl_create(4);
+    add_all(s, clauses, 3);
+
+    check("incremental: first solve SAT", cdcl_solve(s) == SAT);
+
+    int assumps[] = {4, -3};
+    int core_size;
+    check("incremental: assumptions UNSAT",
+          cdcl_solve_assumptions(s, assumps, 2) == UNSAT);
+    const int *core = cdcl_final_conflict(s, &core_size);
+    check("incremental: core is {~x3}", core_size == 1 && core[0] == -3);
+
+    cdcl_add_clause(s, clauses[3], 2);
+    int result = cdcl_solve_assumptions(s, assumps, 1);
+    check("incremental: clause added after solve, SAT", result == SAT);
+    if (result == SAT)
+        check("incremental: model verified",
+              verify_assignment(s, clauses, 4) &&
+              cdcl_get_value(s, 4) == 1 && cdcl_get_value(s, 2) == 1);
+
+    check("incremental: no assumptions, SAT", cdcl_solve(s) == SAT);
+    cdcl_destroy(s);
+}
+
+/*
+ * Test 15: Preprocessing — (x1 OR x2 OR x3) is subsumed by (x1 OR x2), and
+ *   (x1 OR ~x2 OR x4) is strengthened to (x1 OR x4).  x2 and x3 can be
+ *   eliminated; the model must still satisfy every original clause.  Frozen
+ *   x1 is kept for assumptions, and a clause on an eliminated variable is
+ *   refused.  PHP(4,3) stays UNSAT.
+ */
+static void test_preprocess(void) {
+    int clauses[6][10] = { {1, 2, 0}, {1, 2, 3, 0}, {1, -2, 4, 0}, {-2, 3, 0},
+                           {-3, 5, 0}, {-1, -4, -5, 0} };
+    CDCLSolver *s = cdcl_create(5);
+    add_all(s, clauses, 6);
+    cdcl_freeze(s, 1);
+
+    check("preprocess: not UNSAT", cdcl_preprocess(s) == UNKNOWN);
+    check("preprocess: clauses removed", s->clause_count < 6);
+    check("preprocess: x3 eliminated, x1 frozen",
+          s->eliminated[3] && !s->eliminated[1]);
+    int result = cdcl_solve(s);
+    check("preprocess: SAT", result == SAT);
+    if (result == SAT)
+        check("preprocess: model extended", verify_assignment(s, clauses, 6));
+
+    int assump = -1;
+    result = cdcl_solve_assumptions(s, &assump, 1);
+    check("preprocess: frozen assumption SAT", result == SAT);
+    if (result == SAT)
+        check("preprocess: model under assumption",
+              verify_assignment(s, clauses, 6) && cdcl_get_value(s, 1) == 0);
+
+    int late[] = {-3, 4};
+    check("preprocess: clause on eliminated variable refused",
+          cdcl_add_clause(s, late, 2) == -1);
+    cdcl_destroy(s);
+
+    int php[22][10];
+    int n = 0;
+    for (int p = 0; p < 4; p++) {
+        for (int h = 0; h < 3; h++) php[n][h] = 3 * p + h + 1;
+        php[n++][3] = 0;
+    }
+    for (int h = 0; h < 3; h++)
+        for (int a = 0; a < 4; a++)
+            for (int b = a + 1; b < 4; b++) {
+                php[n][0] = -(3 * a + h + 1);
+                php[n][1] = -(3 * b + h + 1);
+                php[n++][2] = 0;
+            }
+    s = cdcl_create(12);
+    add_all(s, php, n);
+    cdcl_preprocess(s);
+    check("preprocess: PHP(4,3) UNSAT", cdcl_solve(s) == UNSAT);
+    cdcl_destroy(s);
+}
+
+/*
+ * Test 16: DRAT proof — PHP(4,3), preprocessed and solved with a binary
+ *   proof attached: the file must be a sequence of well-formed records
+ *   ending in the empty clause.  The text format ends in "0" on a line of
+ *   its own too, and a SAT answer adds no empty clause.
+ */
+static int proof_ends_empty(const char *path, int binary) {
+    FILE *fp = fopen(path, "rb");
+    if (!fp) return 0;
+    int records = 0, ok = 1, empty = 0, ch;
+    if (binary) {
+        while (ok && (ch = fgetc(fp)) != EOF) {
+            int deletion = ch == 'd';
+            int lits = 0;
+            ok = ch == 'a' || ch == 'd';
+            while (ok && (ch = fgetc(fp)) > 0)
+                if (!(ch & 0x80)) lits++;   /* last byte of a literal */
+            ok = ok && ch == 0;
+            empty = !deletion && lits == 0;
+            records++;
+        }
+    } else {
+        char line[256];
+        while (ok && fgets(line, sizeof(line), fp)) {
+            size_t len = strlen(line);
+            ok = len >= 2 && strcmp(line + len - 2, "0\n") == 0;
+            empty = strcmp(line, "0\n") == 0;
+            records++;
+        }
+    }
+    fclose(fp);
+    return ok && records > 0 && empty;
+}
+
+static void test_proof(void) {
+    int php[22][10];
+    int n = 0;
+    for (int p = 0; p < 4; p++) {
+        for (int h = 0; h < 3; h++) php[n][h] = 3 * p + h + 1;
+        php[n++][3] = 0;
+    }
+    for (int h = 0; h < 3; h++)
+        for (int a = 0; a < 4; a++)
+            for (int b = a + 1; b < 4; b++) {
+                php[n][0] = -(3 * a + h + 1);
+                php[n][1] = -(3 * b + h + 1);
+                php[n++][2] = 0;
+            }
+
+    char path[] = "/tmp/test_CDCL_XXXXXX";
+    fclose(fdopen(mkstemp(path), "w"));
+    for (int binary = 1; binary >= 0; binary--) {
+        Proof *proof = proof_open(path, binary);
+        CDCLSolver *s = cdcl_create(12);
+        add_all(s, php, n);
+        cdcl_set_proof(s, proof);
+        cdcl_preprocess(s);
+        int result = cdcl_solve(s);
+        cdcl_destroy(s);
+        int closed = proof_close(proof);
+        check(binary ? "proof: binary PHP(4,3) UNSAT" : "proof: text PHP(4,3) UNSAT",
+              result == UNSAT && closed == 0 && proof_ends_empty(path, binary));
+    }
+
+    int clauses[3][10] = { {1, 2, 0}, {-1, 3, 0}, {-2, -3, 0} };
+    Proof *proof = proof_open(path, true);
+    CDCLSolver *s = cdcl_create(3);
+    add_all(s, clauses, 3);
+    cdcl_set_proof(s, proof);
+    int result = cdcl_solve(s);
+    cdcl_destroy(s);
+    proof_close(proof);
+    check("proof: SAT adds no empty clause", result == SAT && !proof_ends_empty(path, true));
+    remove(path);
+}
+
+/*
+ * Test 17: Reset — one solver recycled through PHP(4,3) (UNSAT), a smaller
+ *   SAT formula, a larger one loaded from DIMACS with
+ *   cdcl_load_dimacs_into(), and PHP(4,3) again after preprocessing
+ *   eliminated variables.  Each answer must be that of a fresh solver.
+ */
+static void test_reset(void) {
+    int php[22][10];
+    int n = 0;
+    for (int p = 0; p < 4; p++) {
+        for (int h = 0; h < 3; h++) php[n][h] = 3 * p + h + 1;
+        php[n++][3] = 0;
+    }
+    for (int h = 0; h < 3; h++)
+        for (int a = 0; a < 4; a++)
+            for (int b = a + 1; b < 4; b++) {
+                php[n][0] = -(3 * a + h + 1);
+                php[n][1] = -(3 * b + h + 1);
+                php[n++][2] = 0;
+            }
+
+    CDCLSolver *s = cdcl_create(12);
+    cdcl_set_polarity(s, POLARITY_TRUE);
+    add_all(s, php, n);
+    check("reset: PHP(4,3) UNSAT", cdcl_solve(s) == UNSAT);
+
+    int small[3][10] = { {1, 2, 0}, {-1, 3, 0}, {-2, -3, 0} };
+    cdcl_reset(s, 3);
+    add_all(s, small, 3);
+    int result = cdcl_solve(s);
+    check("reset: smaller formula SAT", result == SAT && verify_assignment(s, small, 3));
+    check("reset: configuration kept", s->polarity == POLARITY_TRUE);
+
+    char path[] = "/tmp/test_CDCL_XXXXXX";
+    FILE *fp = fdopen(mkstemp(path), "w");
+    fprintf(fp, "p cnf 40 40\n");
+    int chain[40][10];
+    for (int i = 0; i < 40; i++) {
+        chain[i][0] = -(i + 1);
+        chain[i][1] = (i + 2) % 40 + 1;
+        chain[i][2] = 0;
+        fprintf(fp, "%d %d 0\n", chain[i][0], chain[i][1]);
+    }
+    fclose(fp);
+    DimacsInfo info;
+    check("reset: larger formula loaded into the solver",
+          cdcl_load_dimacs_into(s, path, &info) == 0 && s->num_vars == 40 &&
+          info.clauses_read == 40);
+    result = cdcl_solve(s);
+    check("reset: larger formula SAT", result == SAT && verify_assignment(s, chain, 40));
+    remove(path);
+
+    cdcl_reset(s, 12);
+    add_all(s, php, n);
+    cdcl_preprocess(s);
+    check("reset: PHP(4,3) UNSAT again", cdcl_solve(s) == UNSAT);
+    cdcl_reset(s, 12);
+    check("reset: eliminated variables forgotten", s->num_eliminated == 0 && !s->unsat);
+    cdcl_destroy(s);
+}
+
+/*
+ * Test 18: Eviction from the accelerator — random 3-SAT on the sim backend
+ *   with room for only a few learnt clauses, so that they are evicted in the
+ *   middle of the search.  After every learnt clause, each clause software
+ *   propagates must keep its watch invariant: a watch that is false and
+ *   already propagated leaves the clause satisfied (by the other watch or
+ *   by the blocker).  The implication list entries of binary clauses must
+ *   carry BIN_RESIDENT exactly while the clause is resident.
+ */
+static int evict_violations;
+static int evict_batches;
+static int flag_mismatches;
+
+static int resident_count(void) {
+    int n, count = 0;
+    CRef *refs = hw_db_refs(&n);
+    for (int id = 0; id < n; id++) count += refs[id] != CREF_UNDEF;
+    return count;
+}
+
+static void check_watches(CDCLSolver *s, CRef cr) {
+    int before = resident_count();
+    bcp_backend_sim.learnt(s, cr);
+    if (resident_count() < before) evict_batches++;
+
+    int *pos = (int *)malloc((s->num_vars + 1) * sizeof(int));
+    for (int v = 0; v <= s->num_vars; v++) pos[v] = s->trail_size;
+    for (int t = 0; t < s->trail_size; t++) pos[s->trail[t] >> 1] = t;
+
+    for (int i = 0; i < s->clause_count; i++) {
+        Clause *c = cdcl_clause(s, s->clauses[i]);
+        if (c->hw || c->deleted || c->size < 2) continue;
+        bool stale = false, satisfied = false;
+        for (int w = 0; w < 2; w++) {
+            int lit = c->lits[w];
+            if (s->values[lit] == 0 && pos[lit >> 1] < s->prop_head) stale = true;
+        }
+        for (int k = 0; k < (int)c->size; k++)
+            if (s->values[c->lits[k]] == 1) satisfied = true;
+        if (stale && !satisfied) evict_violations++;
+    }
+    free(pos);
+
+    /* Binary entries carry the residency of their clause. */
+    for (int lit = 2; lit <= 2 * s->num_vars + 1; lit++) {
+        for (int i = 0; i < s->bin_size[lit]; i++) {
+            CRef bcr = s->bin_watches[lit][i].cref;
+            bool flag = (bcr & BIN_RESIDENT) != 0;
+            if (flag != (bool)cdcl_clause(s, bcr & ~BIN_RESIDENT)->hw) flag_mismatches++;
+        }
+    }
+}
+
+static void test_hw_eviction(void) {
+    enum { VARS = 150, CLAUSES = 639 };
+    static int cnf[CLAUSES][10];
+    uint64_t x = 88172645463325252ull;
+    for (int i = 0; i < CLAUSES; i++) {
+        for (int k = 0; k < 3; k++) {
+            x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+            int var = (int)(x % VARS) + 1;
+            cnf[i][k] = (x >> 32) & 1 ? var : -var;
+        }
+        cnf[i][3] = 0;
+    }
+
+    CDCLSolver *ref = cdcl_create(VARS);
+    add_all(ref, cnf, CLAUSES);
+    int expected = cdcl_solve(ref);
+    cdcl_destroy(ref);
+
+    BCPBackend sim = bcp_backend_sim;
+    sim.learnt = check_watches;
+    hw_db_set_capacity(CLAUSES + 40);
+    evict_violations = evict_batches = flag_mismatches = 0;
+
+    CDCLSolver *s = cdcl_create(VARS);
+    add_all(s, cnf, CLAUSES);
+    cdcl_set_backend(s, &sim, NULL);
+    int result = cdcl_solve(s);
+    hw_db_set_capacity(0);
+
+    check("eviction: learnt clauses evicted mid-search", evict_batches > 0);
+    check("eviction: watches valid after every learnt clause", evict_violations == 0);
+    check("eviction: binary entries flagged as resident", flag_mismatches == 0);
+    check("eviction: same answer as software",
+          result == expected && (result != SAT || verify_assignment(s, cnf, CLAUSES)));
+    cdcl_destroy(s);
+}
+
+/*
+ * Test 19: A backend that cannot be opened, or stops answering mid-solve —
+ * no answer (UNKNOWN), not UNSAT, and no retrying forever.
+ */
+static int open_fails(const char *port) {
+    (void)port;
+    return -1;
+}
+
+static int dead_calls = 0;
+
+static CRef propagate_fails(CDCLSolver *s) {
+    (void)s;
+    dead_calls++;
+    return CREF_ERROR;
+}
+
+static void test_backend_failure(void) {
+    int clauses[2][10] = { {1, 2, 0}, {-1, 2, 0} };
+    BCPBackend broken = bcp_backend_sim;
+    broken.open = open_fails;
+
+    CDCLSolver *s = cdcl_create(2);
+    add_all(s, clauses, 2);
+    cdcl_set_backend(s, &broken, NULL);
+    check("backend open failure gives UNKNOWN", cdcl_solve(s) == UNKNOWN);
+
+    BCPBackend dead = bcp_backend_sim;
+    dead.propagate = propagate_fails;
+    cdcl_set_backend(s, &dead, NULL);
+    check("backend propagate failure gives UNKNOWN", cdcl_solve(s) == UNKNOWN);
+    check("failed propagate not retried", dead_calls == 1);
+
+    cdcl_set_backend(s, NULL, NULL);
+    check("software solve afterwards SAT", cdcl_solve(s) == SAT);
+    cdcl_destroy(s);
+}
+
 int main(void) {
     printf("=== CDCL SAT Solver Testbench ===\n\n");
 
@@ -256,6 +872,18 @@ int main(void) {
     test_xor_chain_sat();
     test_3sat();
     test_empty_clause();
+    test_pigeonhole_4_3();
+    test_long_chain_sat();
+    test_binary_cycle_unsat();
+    test_load_dimacs();
+    test_bulk_add();
+    test_portfolio();
+    test_incremental();
+    test_preprocess();
+    test_proof();
+    test_reset();
+    test_hw_eviction();
+    test_backend_failure();
 
     printf("\n=== Results: %d / %d tests passed ===\n", tests_passed, tests_run);
 